@@ -0,0 +1,189 @@
+/****************************************************************************************************************************
+  AsyncGet.ino - Simple Arduino web server sample for WiFi shield
+
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Based on and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Based on  and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Non-blocking GET client for HttpClient, next to a local web server.
+  Starts a GET request every five seconds and polls it with step() from loop(),
+  so the local server keeps answering while waiting for the upstream server
+ *****************************************************************************************************************************/
+
+#include "defines.h"
+
+char serverAddress[] = "192.168.2.112";  // server address
+int port = 8080;
+
+WiFiClient      client;
+WiFiHttpClient  httpClient(client, serverAddress, port);
+
+WiFiWebServer   server(80);
+
+int status = WL_IDLE_STATUS;     // the Wifi radio's status
+
+int           lastStatusCode  = 0;
+unsigned long lastBodyLength  = 0;
+unsigned long lastRequestTime = 0;
+
+void onResponse(WiFiHttpClient& aClient, int aStatusCode, void* aArg)
+{
+  (void) aClient;
+  (void) aArg;
+
+  Serial.print(F("Status code: "));
+  Serial.println(aStatusCode);
+
+  lastStatusCode = aStatusCode;
+  lastBodyLength = 0;
+}
+
+void onBody(WiFiHttpClient& aClient, const uint8_t* aData, size_t aLength, void* aArg)
+{
+  (void) aClient;
+  (void) aArg;
+
+  Serial.write(aData, aLength);
+
+  lastBodyLength += aLength;
+}
+
+void onDone(WiFiHttpClient& aClient, int aResult, void* aArg)
+{
+  (void) aClient;
+  (void) aArg;
+
+  Serial.print(F("\nRequest done, result = "));
+  Serial.println(aResult);
+}
+
+void handleRoot()
+{
+  String message = F("Last upstream status: ");
+  message += lastStatusCode;
+  message += F(", body length: ");
+  message += lastBodyLength;
+
+  server.send(200, F("text/plain"), message);
+}
+
+void printWifiStatus()
+{
+  // print the SSID of the network you're attached to:
+  // you're connected now, so print out the data
+  Serial.print(F("You're connected to the network, IP = "));
+  Serial.println(WiFi.localIP());
+
+  Serial.print(F("SSID: "));
+  Serial.print(WiFi.SSID());
+
+  // print the received signal strength:
+  int32_t rssi = WiFi.RSSI();
+  Serial.print(F(", Signal strength (RSSI):"));
+  Serial.print(rssi);
+  Serial.println(F(" dBm"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  Serial.print(F("\nStarting AsyncGet on "));
+  Serial.print(BOARD_NAME);
+  Serial.print(F(" with "));
+  Serial.println(SHIELD_TYPE);
+  Serial.println(WIFI_WEBSERVER_VERSION);
+
+#if WIFI_USING_ESP_AT
+
+  // initialize serial for ESP module
+  EspSerial.begin(115200);
+  // initialize ESP module
+  WiFi.init(&EspSerial);
+
+  Serial.println(F("WiFi shield init done"));
+
+#endif
+
+#if !(ESP32 || ESP8266)
+
+  // check for the presence of the shield
+#if USE_WIFI_NINA
+
+  if (WiFi.status() == WL_NO_MODULE)
+#else
+  if (WiFi.status() == WL_NO_SHIELD)
+#endif
+  {
+    Serial.println(F("WiFi shield not present"));
+
+    // don't continue
+    while (true);
+  }
+
+#if USE_WIFI_NINA
+  String fv = WiFi.firmwareVersion();
+
+  if (fv < WIFI_FIRMWARE_LATEST_VERSION)
+  {
+    Serial.println(F("Please upgrade the firmware"));
+  }
+
+#endif
+
+#endif
+
+  Serial.print(F("Connecting to SSID: "));
+  Serial.println(ssid);
+
+  status = WiFi.begin(ssid, pass);
+
+  delay(1000);
+
+  // attempt to connect to WiFi network
+  while ( status != WL_CONNECTED)
+  {
+    delay(500);
+
+    // Connect to WPA/WPA2 network
+    status = WiFi.status();
+  }
+
+  // you're connected now, so print out the data
+  printWifiStatus();
+
+  httpClient.onResponse(onResponse);
+  httpClient.onBody(onBody);
+  httpClient.onDone(onDone);
+
+  server.on(F("/"), handleRoot);
+  server.begin();
+}
+
+void loop()
+{
+  server.handleClient();
+
+  if (httpClient.asyncBusy())
+  {
+    // Only handles what has already arrived, then returns
+    httpClient.step();
+  }
+  else if ( (lastRequestTime == 0) || (millis() - lastRequestTime > 5000) )
+  {
+    Serial.println(F("making GET request"));
+
+    lastRequestTime = millis();
+
+    if (httpClient.startRequestAsync("/", HTTP_METHOD_GET) != HTTP_SUCCESS)
+    {
+      Serial.println(F("Connection failed"));
+    }
+  }
+}
@@ -0,0 +1,163 @@
+/****************************************************************************************************************************
+  ConnectionPool.ino - Simple Arduino web server sample for WiFi shield
+
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Based on and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Based on  and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  GET requests to several servers through a WiFiHttpConnectionPool.
+  Connections are kept alive and reused by the next request to the same server,
+  instead of a new TCP connection per request
+ *****************************************************************************************************************************/
+
+#include "defines.h"
+
+// Servers to talk to, e.g. node_test_server on different ports
+const char* serverAddresses[] = { "192.168.2.112", "192.168.2.112", "192.168.2.113" };
+const int   serverPorts[]     = { 8080, 8081, 8080 };
+
+#define NUMBER_OF_SERVERS     ( sizeof(serverPorts) / sizeof(serverPorts[0]) )
+
+// One client per socket the pool may use, at most WS_HTTP_POOL_MAX_CONNECTIONS
+WiFiClient              client1;
+WiFiClient              client2;
+WiFiClient              client3;
+
+WiFiHttpConnectionPool  pool;
+
+int status = WL_IDLE_STATUS;     // the Wifi radio's status
+
+void printWifiStatus()
+{
+  // print the SSID of the network you're attached to:
+  // you're connected now, so print out the data
+  Serial.print(F("You're connected to the network, IP = "));
+  Serial.println(WiFi.localIP());
+
+  Serial.print(F("SSID: "));
+  Serial.print(WiFi.SSID());
+
+  // print the received signal strength:
+  int32_t rssi = WiFi.RSSI();
+  Serial.print(F(", Signal strength (RSSI):"));
+  Serial.print(rssi);
+  Serial.println(F(" dBm"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  Serial.print(F("\nStarting ConnectionPool on "));
+  Serial.print(BOARD_NAME);
+  Serial.print(F(" with "));
+  Serial.println(SHIELD_TYPE);
+  Serial.println(WIFI_WEBSERVER_VERSION);
+
+#if WIFI_USING_ESP_AT
+
+  // initialize serial for ESP module
+  EspSerial.begin(115200);
+  // initialize ESP module
+  WiFi.init(&EspSerial);
+
+  Serial.println(F("WiFi shield init done"));
+
+#endif
+
+#if !(ESP32 || ESP8266)
+
+  // check for the presence of the shield
+#if USE_WIFI_NINA
+
+  if (WiFi.status() == WL_NO_MODULE)
+#else
+  if (WiFi.status() == WL_NO_SHIELD)
+#endif
+  {
+    Serial.println(F("WiFi shield not present"));
+
+    // don't continue
+    while (true);
+  }
+
+#if USE_WIFI_NINA
+  String fv = WiFi.firmwareVersion();
+
+  if (fv < WIFI_FIRMWARE_LATEST_VERSION)
+  {
+    Serial.println(F("Please upgrade the firmware"));
+  }
+
+#endif
+
+#endif
+
+  Serial.print(F("Connecting to SSID: "));
+  Serial.println(ssid);
+
+  status = WiFi.begin(ssid, pass);
+
+  delay(1000);
+
+  // attempt to connect to WiFi network
+  while ( status != WL_CONNECTED)
+  {
+    delay(500);
+
+    // Connect to WPA/WPA2 network
+    status = WiFi.status();
+  }
+
+  // you're connected now, so print out the data
+  printWifiStatus();
+
+  pool.addClient(client1);
+  pool.addClient(client2);
+  pool.addClient(client3);
+}
+
+void loop()
+{
+  for (uint8_t i = 0; i < NUMBER_OF_SERVERS; i++)
+  {
+    // The connection goes back to the pool when httpClient goes out of scope
+    WiFiHttpClient httpClient(pool, serverAddresses[i], serverPorts[i]);
+
+    Serial.print(F("making GET request to "));
+    Serial.print(serverAddresses[i]);
+    Serial.print(F(":"));
+    Serial.println(serverPorts[i]);
+
+    unsigned long startTime = millis();
+
+    httpClient.get("/");
+
+    // Read the whole body, so the connection can be reused
+    int statusCode  = httpClient.responseStatusCode();
+    String response = httpClient.responseBody();
+
+    Serial.print(F("Status code: "));
+    Serial.print(statusCode);
+    Serial.print(F(", time (ms): "));
+    Serial.println(millis() - startTime);
+    Serial.print(F("Response: "));
+    Serial.println(response);
+  }
+
+  Serial.print(F("Pool hits: "));
+  Serial.print(pool.hits());
+  Serial.print(F(", misses: "));
+  Serial.print(pool.misses());
+  Serial.print(F(", hit rate (%): "));
+  Serial.println(pool.hitRate());
+
+  Serial.println(F("Wait five seconds"));
+  delay(5000);
+}
@@ -0,0 +1,182 @@
+/****************************************************************************************************************************
+  DeflateBenchmark.ino - Compression ratio and CPU time of the WebSocket permessage-deflate codec
+
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Based on and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Based on  and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Compresses telemetry JSON messages as WiFiWebSocketClient does with enableDeflate(), for several
+  window sizes with and without context takeover, then inflates them to check the round trip.
+  No network is needed
+ *****************************************************************************************************************************/
+
+#include "defines.h"
+
+#define NUMBER_OF_MESSAGES      50
+
+// Window sizes to test, in bits. 9 and 10 suit a SAMD21
+const uint8_t windowBits[] = { 9, 10, 12 };
+
+WiFiDeflate deflater;
+WiFiInflate inflater;
+
+// Compressed message
+uint8_t compressed[512];
+size_t  compressedLength;
+
+char    message[256];
+uint8_t decoded[256];
+
+void deflateOutput(void* aContext, const uint8_t* aData, size_t aLength)
+{
+  (void) aContext;
+
+  if (compressedLength + aLength <= sizeof(compressed))
+  {
+    memcpy(compressed + compressedLength, aData, aLength);
+  }
+
+  compressedLength += aLength;
+}
+
+// Representative payload: the same keys every time, slowly changing values
+size_t makeMessage(int i)
+{
+  return snprintf(message, sizeof(message),
+                  "{\"device\":\"sensor-%02d\",\"time\":%lu,\"temperature\":%d.%d,\"humidity\":%d,"
+                  "\"pressure\":%d,\"battery\":%d,\"rssi\":%d,\"status\":\"%s\"}",
+                  i % 4, 1670000000UL + i * 15, 21 + (i % 3), i % 10, 40 + (i % 7), 1008 + (i % 5), 95 - i / 10,
+                  -60 - (i % 9), (i % 10) ? "ok" : "low battery");
+}
+
+void runBenchmark(uint8_t bits, bool contextTakeover)
+{
+  if (!deflater.begin(bits, deflateOutput, NULL) || !inflater.begin(bits))
+  {
+    Serial.println(F("Out of memory"));
+
+    return;
+  }
+
+  unsigned long rawBytes        = 0;
+  unsigned long compressedBytes = 0;
+  unsigned long deflateTime     = 0;
+  unsigned long inflateTime     = 0;
+  int           failed          = 0;
+
+  for (int i = 0; i < NUMBER_OF_MESSAGES; i++)
+  {
+    size_t length = makeMessage(i);
+
+    compressedLength = 0;
+
+    unsigned long start = micros();
+
+    if (!contextTakeover)
+    {
+      deflater.reset();
+    }
+
+    deflater.write((const uint8_t*) message, length);
+    deflater.finishMessage();
+
+    deflateTime += micros() - start;
+
+    rawBytes        += length;
+    compressedBytes += compressedLength;
+
+    // Round trip
+    start = micros();
+
+    if (!contextTakeover)
+    {
+      inflater.reset();
+    }
+    else
+    {
+      inflater.beginMessage();
+    }
+
+    size_t  written = 0;
+    size_t  total   = 0;
+
+    while (!inflater.done() && !inflater.error())
+    {
+      written += inflater.write(compressed + written, min(compressedLength, sizeof(compressed)) - written);
+
+      if (written == min(compressedLength, sizeof(compressed)))
+      {
+        inflater.finishMessage();
+      }
+
+      int len = inflater.read(decoded + total, sizeof(decoded) - total);
+
+      if (len > 0)
+      {
+        total += len;
+      }
+      else if (total == sizeof(decoded))
+      {
+        break;
+      }
+    }
+
+    inflateTime += micros() - start;
+
+    if ( (total != length) || memcmp(decoded, message, length) )
+    {
+      failed++;
+    }
+  }
+
+  deflater.end();
+  inflater.end();
+
+  Serial.print(F("Window "));
+  Serial.print(1UL << bits);
+  Serial.print(contextTakeover ? F(" B, context takeover   : ") : F(" B, no context takeover: "));
+  Serial.print(rawBytes);
+  Serial.print(F(" -> "));
+  Serial.print(compressedBytes);
+  Serial.print(F(" bytes ("));
+  Serial.print(100.0 * compressedBytes / rawBytes, 1);
+  Serial.print(F("%), deflate = "));
+  Serial.print(deflateTime / NUMBER_OF_MESSAGES);
+  Serial.print(F(" us/msg, inflate = "));
+  Serial.print(inflateTime / NUMBER_OF_MESSAGES);
+  Serial.print(F(" us/msg, failed = "));
+  Serial.println(failed);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  Serial.print(F("\nStarting DeflateBenchmark on "));
+  Serial.print(BOARD_NAME);
+  Serial.print(F(" with "));
+  Serial.println(SHIELD_TYPE);
+  Serial.println(WIFI_WEBSERVER_VERSION);
+
+  makeMessage(0);
+  Serial.print(F("Sample message: "));
+  Serial.println(message);
+}
+
+void loop()
+{
+  for (uint8_t i = 0; i < sizeof(windowBits); i++)
+  {
+    runBenchmark(windowBits[i], true);
+    runBenchmark(windowBits[i], false);
+  }
+
+  Serial.println(F("Wait ten seconds"));
+  delay(10000);
+}
@@ -0,0 +1,189 @@
+/****************************************************************************************************************************
+  LatencyBenchmark.ino - Simple Arduino web server sample for WiFi shield
+
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Based on and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Based on  and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Measures GET request latency against node_test_server, which answers /delay/<ms> after <ms> ms.
+  Each request costs the server delay plus network time, not a whole poll interval
+ *****************************************************************************************************************************/
+
+#include "defines.h"
+
+char serverAddress[] = "192.168.2.112";  // server address
+int port = 8080;
+
+WiFiClient      client;
+WiFiHttpClient  httpClient(client, serverAddress, port);
+
+int status = WL_IDLE_STATUS;     // the Wifi radio's status
+
+#define NUMBER_OF_REQUESTS      20
+
+// Server delays to test, in ms
+const int serverDelays[] = { 0, 5, 50 };
+
+void printWifiStatus()
+{
+  // print the SSID of the network you're attached to:
+  // you're connected now, so print out the data
+  Serial.print(F("You're connected to the network, IP = "));
+  Serial.println(WiFi.localIP());
+
+  Serial.print(F("SSID: "));
+  Serial.print(WiFi.SSID());
+
+  // print the received signal strength:
+  int32_t rssi = WiFi.RSSI();
+  Serial.print(F(", Signal strength (RSSI):"));
+  Serial.print(rssi);
+  Serial.println(F(" dBm"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  while (!Serial && millis() < 5000);
+
+  Serial.print(F("\nStarting LatencyBenchmark on "));
+  Serial.print(BOARD_NAME);
+  Serial.print(F(" with "));
+  Serial.println(SHIELD_TYPE);
+  Serial.println(WIFI_WEBSERVER_VERSION);
+
+#if WIFI_USING_ESP_AT
+
+  // initialize serial for ESP module
+  EspSerial.begin(115200);
+  // initialize ESP module
+  WiFi.init(&EspSerial);
+
+  Serial.println(F("WiFi shield init done"));
+
+#endif
+
+#if !(ESP32 || ESP8266)
+
+  // check for the presence of the shield
+#if USE_WIFI_NINA
+
+  if (WiFi.status() == WL_NO_MODULE)
+#else
+  if (WiFi.status() == WL_NO_SHIELD)
+#endif
+  {
+    Serial.println(F("WiFi shield not present"));
+
+    // don't continue
+    while (true);
+  }
+
+#if USE_WIFI_NINA
+  String fv = WiFi.firmwareVersion();
+
+  if (fv < WIFI_FIRMWARE_LATEST_VERSION)
+  {
+    Serial.println(F("Please upgrade the firmware"));
+  }
+
+#endif
+
+#endif
+
+  Serial.print(F("Connecting to SSID: "));
+  Serial.println(ssid);
+
+  status = WiFi.begin(ssid, pass);
+
+  delay(1000);
+
+  // attempt to connect to WiFi network
+  while ( status != WL_CONNECTED)
+  {
+    delay(500);
+
+    // Connect to WPA/WPA2 network
+    status = WiFi.status();
+  }
+
+  // you're connected now, so print out the data
+  printWifiStatus();
+}
+
+void runBenchmark(int serverDelay)
+{
+  char path[24];
+
+  snprintf(path, sizeof(path), "/delay/%d", serverDelay);
+
+  unsigned long minTime = 0xFFFFFFFF;
+  unsigned long maxTime = 0;
+  unsigned long total   = 0;
+  int           failed  = 0;
+
+  for (int i = 0; i < NUMBER_OF_REQUESTS; i++)
+  {
+    unsigned long start = millis();
+
+    httpClient.get(path);
+
+    int statusCode = httpClient.responseStatusCode();
+
+    // Reads headers and body, "OK"
+    httpClient.responseBody();
+
+    unsigned long elapsed = millis() - start;
+
+    httpClient.stop();
+
+    if (statusCode != 200)
+    {
+      failed++;
+      continue;
+    }
+
+    total += elapsed;
+
+    if (elapsed < minTime)
+      minTime = elapsed;
+
+    if (elapsed > maxTime)
+      maxTime = elapsed;
+  }
+
+  Serial.print(F("GET "));
+  Serial.print(path);
+
+  if (failed == NUMBER_OF_REQUESTS)
+  {
+    Serial.println(F(" : all requests failed"));
+
+    return;
+  }
+
+  Serial.print(F(" : min = "));
+  Serial.print(minTime);
+  Serial.print(F(" ms, avg = "));
+  Serial.print(total / (NUMBER_OF_REQUESTS - failed));
+  Serial.print(F(" ms, max = "));
+  Serial.print(maxTime);
+  Serial.print(F(" ms, failed = "));
+  Serial.println(failed);
+}
+
+void loop()
+{
+  for (uint8_t i = 0; i < sizeof(serverDelays) / sizeof(serverDelays[0]); i++)
+  {
+    runBenchmark(serverDelays[i]);
+  }
+
+  Serial.println(F("Wait ten seconds"));
+  delay(10000);
+}
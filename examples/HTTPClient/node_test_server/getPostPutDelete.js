@@ -66,6 +66,13 @@ app.get('/chunked', function(request, response) {
 	response.end();
 });
 
+// answers after the given number of ms, for LatencyBenchmark:
+app.get('/delay/:ms', function(request, response) {
+	setTimeout(function() {
+		response.send('OK');
+	}, parseInt(request.params.ms) || 0);
+});
+
 // this is the POST handler:
 app.all('/*', function (request, response) {
 	console.log('Got a ' + request.method + ' request');
@@ -86,10 +86,14 @@ void setup()
     status = WiFi.status();
   }
 
+  // The Basic token is encoded once here, not on every request
+  server.setCredentials(www_username, www_password);
+
   server.on(F("/"), []()
   {
-    if (!server.authenticate(www_username, www_password))
+    if (!server.authenticate())
     {
+      // requestAuthentication(DIGEST_AUTH) asks for Digest instead, which never sends the password
       return server.requestAuthentication();
     }
 
@@ -16,6 +16,7 @@
 #include "multiFileProject.h"
 
 // To be included only in main(), .ino with setup() to avoid `Multiple Definitions` Linker Error
+// unless the library is built with compiler flag WIFI_WEBSERVER_SEPARATE_IMPL=true
 #include <WiFiWebServer.h>      // https://github.com/khoih-prog/WiFiWebServer
 
 void setup()
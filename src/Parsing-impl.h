@@ -143,17 +143,294 @@ static char* readBytesWithTimeout(WiFiClient& client, size_t maxLength, size_t&
 
 ////////////////////////////////////////
 
+#if USE_NEW_WEBSERVER_VERSION
+
 bool WiFiWebServer::_parseRequest(WiFiClient& client)
 {
   // Read the first line of HTTP request
   String req = client.readStringUntil('\r');
   client.readStringUntil('\n');
 
+  if (!_parseRequestLine(req))
+  {
+    return false;
+  }
+
+  //parse headers
+  while (1)
+  {
+    req = client.readStringUntil('\r');
+    client.readStringUntil('\n');
+
+    if (req == "")
+      break;//no more headers
+
+    if (!_parseHeaderLine(req))
+    {
+      break;
+    }
+  }
+
+  WS_TRACE(HEADERS, _bodyLength);
+
+  // below is needed only when POST type request
+  if (_requestHasBody())
+  {
+#if WEBSERVER_SUPPORT_MULTIPART
+    if (_bodyType == BODY_FORM)
+    {
+      _parseArguments(_searchStr);
+
+      // here: content is not yet read
+      bool parsed = _parseForm(client, _boundaryStr, _bodyLength);
+
+      _uploadRelease();
+
+      if (!parsed)
+      {
+        return false;
+      }
+    }
+    else
+#endif
+    {
+      if (_bodyType == BODY_JSON)
+      {
+        // Fields go to _postArgs while the body streams in, no _plainBuf
+        if (!_parseJsonBody(client, _bodyLength))
+        {
+          return false;
+        }
+      }
+      else if (   !readBytesWithTimeout(client, _bodyLength, _plainBuf, HTTP_MAX_POST_WAIT)
+                  || (_plainBuf.length() < _bodyLength) )
+      {
+        return false;
+      }
+
+      _parseBodyArgs();
+    }
+  }
+  else
+  {
+    _parseArguments(_searchStr);
+  }
+
+  _endParseRequest(client);
+
+  return true;
+}
+
+////////////////////////////////////////
+
+// Returns 1 when the request is complete, 0 when more data is needed, -1 on error
+int WiFiWebServer::_parseRequestStep(WiFiClient& client, unsigned long start, uint32_t budget_us)
+{
+  // One more for the NUL closing a plain body block
+  static const size_t kBlockSize = 64;
+
+  uint8_t buf[kBlockSize + 1];
+
+  while (micros() - start < budget_us)
+  {
+    if ( (_parseStage == PARSE_BODY) && (_bodyRead >= _bodyLength) )
+    {
+#if WEBSERVER_SUPPORT_MULTIPART
+      if (_bodyType == BODY_FORM)
+      {
+        if (!_endFormBody())
+        {
+          _sendParseError(400);
+
+          return -1;
+        }
+
+        _endParseRequest(client);
+
+        return 1;
+      }
+#endif
+
+      if ( (_bodyType == BODY_JSON) && !_endJsonBody() )
+      {
+        _sendParseError(400);
+
+        return -1;
+      }
+
+      _parseBodyArgs();
+      _endParseRequest(client);
+
+      return 1;
+    }
+
+    size_t avail = client.available();
+
+    if (!avail)
+    {
+      return 0;
+    }
+
+    _statusChange = millis();
+
+    if (_parseStage == PARSE_BODY)
+    {
+      if (avail > kBlockSize)
+        avail = kBlockSize;
+
+      if (avail > _bodyLength - _bodyRead)
+        avail = _bodyLength - _bodyRead;
+
+      int readLen = client.read(buf, avail);
+
+      if (readLen <= 0)
+      {
+        return 0;
+      }
+
+      if (_bodyType == BODY_JSON)
+      {
+        _jsonTokenizer->write((const char*) buf, readLen);
+      }
+#if WEBSERVER_SUPPORT_MULTIPART
+      else if (_bodyType == BODY_FORM)
+      {
+        if (!_formBodyWrite(buf, readLen))
+        {
+          _sendParseError(400);
+
+          return -1;
+        }
+      }
+#endif
+      else
+      {
+        // Into the reserved _plainBuf a block at a time, unless the body holds a NUL
+        buf[readLen] = '\0';
+
+        if (!memchr(buf, '\0', readLen))
+        {
+          _plainBuf += (const char*) buf;
+        }
+        else
+        {
+          for (int i = 0; i < readLen; i++)
+            _plainBuf += (char) buf[i];
+        }
+      }
+
+      _bodyRead += readLen;
+
+      continue;
+    }
+
+    // Request line and headers are read byte by byte, so the body is left in the client
+    int c = client.read();
+
+    if (c < 0)
+    {
+      return 0;
+    }
+
+    if (c == '\r')
+    {
+      continue;
+    }
+
+    if (c != '\n')
+    {
+      if (_parseLine.length() >= WEBSERVER_MAX_LINE_LEN)
+      {
+        WS_LOGDEBUG1(F("_parseRequestStep: Line too long, max = "), WEBSERVER_MAX_LINE_LEN);
+
+        // Answer before closing, or the client waits or retries
+        if (_parseStage == PARSE_REQUEST_LINE)
+        {
+          // Its version isn't known yet
+          _currentVersion = 1;
+          _sendParseError(414);
+        }
+        else
+        {
+          _sendParseError(431);
+        }
+
+        return -1;
+      }
+
+      _parseLine += (char) c;
+
+      continue;
+    }
+
+    if (_parseStage == PARSE_REQUEST_LINE)
+    {
+      if (!_parseRequestLine(_parseLine))
+      {
+        return -1;
+      }
+
+      _parseStage = PARSE_HEADERS;
+      _parseLine  = "";
+
+      continue;
+    }
+
+    if ( (_parseLine.length() != 0) && _parseHeaderLine(_parseLine) )
+    {
+      _parseLine = "";
+
+      continue;
+    }
+
+    // End of headers
+    _parseLine = String();
+
+    WS_TRACE(HEADERS, _bodyLength);
+
+    if (!_requestHasBody())
+    {
+      _parseArguments(_searchStr);
+      _endParseRequest(client);
+
+      return 1;
+    }
+
+    if (_bodyType == BODY_JSON)
+    {
+      _beginJsonBody();
+    }
+#if WEBSERVER_SUPPORT_MULTIPART
+    else if (_bodyType == BODY_FORM)
+    {
+      // Query args first, a "blob" upload takes its name from the "filename" one
+      _parseArguments(_searchStr);
+      _beginFormBody();
+    }
+#endif
+    else if (!_plainBuf.reserve(_bodyLength + 1))
+    {
+      return -1;
+    }
+
+    _bodyRead   = 0;
+    _parseStage = PARSE_BODY;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_parseRequestLine(const String& req)
+{
+#if WEBSERVER_SUPPORT_HEADERS
   //reset header value
   for (int i = 0; i < _headerKeysCount; ++i)
   {
     _currentHeaders[i].value = String();
   }
+#endif
 
   // First line of HTTP request looks like "GET /path HTTP/1.1"
   // Retrieve the "/path" part by finding the spaces
@@ -170,12 +447,12 @@ bool WiFiWebServer::_parseRequest(WiFiClient& client)
   String url        = req.substring(addr_start + 1, addr_end);
   String versionEnd = req.substring(addr_end + 8);
   _currentVersion   = atoi(versionEnd.c_str());
-  String searchStr  = "";
+  _searchStr        = "";
   int hasSearch     = url.indexOf('?');
 
   if (hasSearch != -1)
   {
-    searchStr = url.substring(hasSearch + 1);
+    _searchStr = url.substring(hasSearch + 1);
     url = url.substring(0, hasSearch);
   }
 
@@ -184,8 +461,6 @@ bool WiFiWebServer::_parseRequest(WiFiClient& client)
 
   HTTPMethod method = HTTP_GET;
 
-#if USE_NEW_WEBSERVER_VERSION
-
   if (methodStr == "HEAD")
   {
     method = HTTP_HEAD;
@@ -211,8 +486,213 @@ bool WiFiWebServer::_parseRequest(WiFiClient& client)
     method = HTTP_PATCH;
   }
 
+  _currentMethod = method;
+
+  WS_LOGDEBUG1(F("method: "), methodStr);
+  WS_LOGDEBUG1(F("url: "), url);
+  WS_LOGDEBUG1(F("search: "), _searchStr);
+
+  //attach handler
+  RequestHandler* handler = nullptr;
+
+  for (handler = _firstHandler; handler; handler = handler->next())
+  {
+    if (handler->canHandle(_currentMethod, _currentUri))
+      break;
+  }
+
+  _currentHandler = handler;
+
+  _bodyType             = BODY_PLAIN;
+  _bodyLength           = 0;
+  _clientContentLength  = 0;
+#if WEBSERVER_SUPPORT_MULTIPART
+  _boundaryStr          = String();
+#endif
+  _plainBuf             = String();
+
+#if WIFI_WEBSERVER_METRICS
+  _requestBytesIn = req.length() + 2;
+#endif
+
+  WS_TRACE(REQUEST_LINE, method);
+
+  return true;
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_parseHeaderLine(const String& req)
+{
+  int headerDiv = req.indexOf(':');
+
+  if (headerDiv == -1)
+  {
+    return false;
+  }
+
+  String headerName  = req.substring(0, headerDiv);
+  String headerValue = req.substring(headerDiv + 1);
+
+  headerValue.trim();
+  _collectHeader(headerName.c_str(), headerValue.c_str());
+
+  WS_LOGDEBUG1(F("headerName: "), headerName);
+  WS_LOGDEBUG1(F("headerValue: "), headerValue);
+
+#if WIFI_WEBSERVER_METRICS
+  _requestBytesIn += req.length() + 2;
+#endif
+
+  if (headerName.equalsIgnoreCase("Content-Type"))
+  {
+#if (ESP32 || ESP8266)
+    using namespace mime_esp;
+#else
+    using namespace mime;
+#endif
+
+    if (headerValue.startsWith(mimeTable[txt].mimeType))
+    {
+      _bodyType = BODY_PLAIN;
+    }
+    else if (headerValue.startsWith("application/x-www-form-urlencoded"))
+    {
+      _bodyType = BODY_ENCODED;
+    }
+#if WEBSERVER_SUPPORT_MULTIPART
+    else if (headerValue.startsWith("multipart/"))
+    {
+      _boundaryStr = headerValue.substring(headerValue.indexOf('=') + 1);
+      _boundaryStr.replace("\"", "");
+      _bodyType = BODY_FORM;
+    }
+#endif
+    else if (_jsonTokenizer && headerValue.startsWith(mimeTable[json].mimeType))
+    {
+      _bodyType = BODY_JSON;
+    }
+  }
+  else if (headerName.equalsIgnoreCase("Content-Length"))
+  {
+    _bodyLength = headerValue.toInt();
+    _clientContentLength = headerValue.toInt();
+  }
+  else if (headerName.equalsIgnoreCase("Host"))
+  {
+    _hostHeader = headerValue;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+// Body other than multipart has been read into _plainBuf, or into _postArgs for JSON
+void WiFiWebServer::_parseBodyArgs()
+{
+  if (_bodyType == BODY_ENCODED)
+  {
+    // add _plainBuf in search str
+    if (_searchStr.length())
+      _searchStr += '&';
+
+    _searchStr += _plainBuf;
+  }
+
+  // parse searchStr for key/value pairs
+  _parseArguments(_searchStr);
+
+  if (_bodyType == BODY_JSON)
+  {
+    _mergePostArgs();
+  }
+  else if (_bodyLength)
+  {
+    // add key=value: plain={body} (post json or other data)
+    RequestArgument& arg = _currentArgs[_currentArgCount++];
+    arg.key   = F("plain");
+    arg.value = _plainBuf;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_endParseRequest(WiFiClient& client)
+{
+  client.flush();
+
+  WS_TRACE(BODY, _bodyLength);
+
+#if WIFI_WEBSERVER_METRICS
+  // Empty line after the headers, and the body
+  _requestBytesIn += 2 + (_requestHasBody() ? _bodyLength : 0);
+#endif
+
+  WS_LOGDEBUG1(F("Request:"), _currentUri);
+  WS_LOGDEBUG1(F("Arguments:"), _searchStr);
+  WS_LOGDEBUG (F("Final list of key/value pairs:"));
+
+  for (int i = 0; i < _currentArgCount; i++)
+  {
+    WS_LOGDEBUG1("key:",   _currentArgs[i].key.c_str());
+    WS_LOGDEBUG1("value:", _currentArgs[i].value.c_str());
+  }
+
+  // Already copied into the args
+  _plainBuf   = String();
+  _searchStr  = String();
+}
+
+////////////////////////////////////////
+
 #else   // #if USE_NEW_WEBSERVER_VERSION
 
+////////////////////////////////////////
+
+bool WiFiWebServer::_parseRequest(WiFiClient& client)
+{
+  // Read the first line of HTTP request
+  String req = client.readStringUntil('\r');
+  client.readStringUntil('\n');
+
+#if WEBSERVER_SUPPORT_HEADERS
+  //reset header value
+  for (int i = 0; i < _headerKeysCount; ++i)
+  {
+    _currentHeaders[i].value = String();
+  }
+#endif
+
+  // First line of HTTP request looks like "GET /path HTTP/1.1"
+  // Retrieve the "/path" part by finding the spaces
+  int addr_start  = req.indexOf(' ');
+  int addr_end    = req.indexOf(' ', addr_start + 1);
+
+  if (addr_start == -1 || addr_end == -1)
+  {
+    WS_LOGDEBUG1(F("_parseRequest: Invalid request: "), req);
+    return false;
+  }
+
+  String methodStr  = req.substring(0, addr_start);
+  String url        = req.substring(addr_start + 1, addr_end);
+  String versionEnd = req.substring(addr_end + 8);
+  _currentVersion   = atoi(versionEnd.c_str());
+  String searchStr  = "";
+  int hasSearch     = url.indexOf('?');
+
+  if (hasSearch != -1)
+  {
+    searchStr = url.substring(hasSearch + 1);
+    url = url.substring(0, hasSearch);
+  }
+
+  _currentUri = url;
+  _chunked = false;
+
+  HTTPMethod method = HTTP_GET;
+
   if (methodStr == "POST")
   {
     method = HTTP_POST;
@@ -235,8 +715,6 @@ bool WiFiWebServer::_parseRequest(WiFiClient& client)
     method = HTTP_PATCH;
   }
 
-#endif    // #if USE_NEW_WEBSERVER_VERSION
-
   _currentMethod = method;
 
   WS_LOGDEBUG1(F("method: "), methodStr);
@@ -309,12 +787,14 @@ bool WiFiWebServer::_parseRequest(WiFiClient& client)
           isForm = false;
           isEncoded = true;
         }
+#if WEBSERVER_SUPPORT_MULTIPART
         else if (headerValue.startsWith("multipart/"))
         {
           boundaryStr = headerValue.substring(headerValue.indexOf('=') + 1);
           boundaryStr.replace("\"", "");
           isForm = true;
         }
+#endif
       }
       else if (headerName.equalsIgnoreCase("Content-Length"))
       {
@@ -328,123 +808,28 @@ bool WiFiWebServer::_parseRequest(WiFiClient& client)
     }
 
     //KH
-#if USE_NEW_WEBSERVER_VERSION
-
-    ////////////////////////////////////////
-
-    String plainBuf;
-
-    if (   !isForm
-           && // read content into plainBuf
-           (   !readBytesWithTimeout(client, contentLength, plainBuf, HTTP_MAX_POST_WAIT)
-               || (plainBuf.length() < contentLength)
-           )
-       )
-    {
-      return false;
-    }
-
-    if (isEncoded)
-    {
-      // isEncoded => !isForm => plainBuf is not empty
-      // add plainBuf in search str
-      if (searchStr.length())
-        searchStr += '&';
-
-      searchStr += plainBuf;
-    }
-
-    // parse searchStr for key/value pairs
-    _parseArguments(searchStr);
-
-    if (!isForm)
-    {
-      if (contentLength)
-      {
-        // add key=value: plain={body} (post json or other data)
-        RequestArgument& arg = _currentArgs[_currentArgCount++];
-        arg.key   = F("plain");
-        arg.value = plainBuf;
-      }
-    }
-    else
-    {
-      // isForm is true
-      // here: content is not yet read (plainBuf is still empty)
-      if (!_parseForm(client, boundaryStr, contentLength))
-      {
-        return false;
-      }
-    }
-  }
-  else
-  {
-    String headerName;
-    String headerValue;
-
-    //parse headers
-    while (1)
-    {
-      req = client.readStringUntil('\r');
-      client.readStringUntil('\n');
-
-      if (req == "")
-        break;//no more headers
-
-      int headerDiv = req.indexOf(':');
-
-      if (headerDiv == -1)
-      {
-        break;
-      }
-
-      headerName  = req.substring(0, headerDiv);
-      headerValue = req.substring(headerDiv + 2);
-      _collectHeader(headerName.c_str(), headerValue.c_str());
-
-      WS_LOGDEBUG1(F("headerName:"), headerName);
-      WS_LOGDEBUG1(F("headerValue:"), headerValue);
-
-      if (headerName.equalsIgnoreCase(F("Host")))
-      {
-        _hostHeader = headerValue;
-      }
-    }
-
-    _parseArguments(searchStr);
-  }
-
-  client.flush();
-
-  WS_LOGDEBUG1(F("Request:"), url);
-  WS_LOGDEBUG1(F("Arguments:"), searchStr);
-  WS_LOGDEBUG (F("Final list of key/value pairs:"));
-
-  for (int i = 0; i < _currentArgCount; i++)
-  {
-    WS_LOGDEBUG1("key:",   _currentArgs[i].key.c_str());
-    WS_LOGDEBUG1("value:", _currentArgs[i].value.c_str());
-  }
-
-  return true;
-
-  ////////////////////////////////////////
-
-#else   // #if USE_NEW_WEBSERVER_VERSION
 
     ////////////////////////////////////////
 
     (void) isEncoded;
 
+#if WEBSERVER_SUPPORT_MULTIPART
     if (isForm)
     {
       _parseArguments(searchStr);
 
-      if (!_parseForm(client, boundaryStr, contentLength))
+      bool parsed = _parseForm(client, boundaryStr, contentLength);
+
+      _uploadRelease();
+
+      if (!parsed)
       {
         return false;
       }
     }
+#else
+    (void) isForm;
+#endif
   }
   else
   {
@@ -489,14 +874,17 @@ bool WiFiWebServer::_parseRequest(WiFiClient& client)
   WS_LOGDEBUG1(F("Arguments: "), searchStr);
 
   return true;
+}
+
+////////////////////////////////////////
 
 #endif    // #if USE_NEW_WEBSERVER_VERSION
-}
 
 ////////////////////////////////////////
 
 bool WiFiWebServer::_collectHeader(const char* headerName, const char* headerValue)
 {
+#if WEBSERVER_SUPPORT_HEADERS
   for (int i = 0; i < _headerKeysCount; i++)
   {
     if (_currentHeaders[i].key.equalsIgnoreCase(headerName))
@@ -505,6 +893,10 @@ bool WiFiWebServer::_collectHeader(const char* headerName, const char* headerVal
       return true;
     }
   }
+#else
+  (void) headerName;
+  (void) headerValue;
+#endif
 
   return false;
 }
@@ -612,22 +1004,8 @@ void WiFiWebServer::_parseArguments(const String& data)
 
 ////////////////////////////////////////
 
-void WiFiWebServer::_uploadWriteByte(uint8_t b)
-{
-  if (_currentUpload->currentSize == HTTP_UPLOAD_BUFLEN)
-  {
-    if (_currentHandler && _currentHandler->canUpload(_currentUri))
-      _currentHandler->upload(*this, _currentUri, *_currentUpload);
-
-    _currentUpload->totalSize += _currentUpload->currentSize;
-    _currentUpload->currentSize = 0;
-  }
-
-  _currentUpload->buf[_currentUpload->currentSize++] = b;
-}
-
-////////////////////////////////////////
-
+#if WEBSERVER_SUPPORT_MULTIPART
+
 int WiFiWebServer::_uploadReadByte(WiFiClient& client)
 {
   int res = client.read();
@@ -670,6 +1048,8 @@ int WiFiWebServer::_uploadReadByte(WiFiClient& client)
   return res;
 }
 
+#endif    // #if WEBSERVER_SUPPORT_MULTIPART
+
 ////////////////////////////////////////
 
 #else   // #if USE_NEW_WEBSERVER_VERSION
@@ -759,21 +1139,7 @@ void WiFiWebServer::_parseArguments(const String& data)
 
 ////////////////////////////////////////
 
-void WiFiWebServer::_uploadWriteByte(uint8_t b)
-{
-  if (_currentUpload.currentSize == HTTP_UPLOAD_BUFLEN)
-  {
-    if (_currentHandler && _currentHandler->canUpload(_currentUri))
-      _currentHandler->upload(*this, _currentUri, _currentUpload);
-
-    _currentUpload.totalSize += _currentUpload.currentSize;
-    _currentUpload.currentSize = 0;
-  }
-
-  _currentUpload.buf[_currentUpload.currentSize++] = b;
-}
-
-////////////////////////////////////////
+#if WEBSERVER_SUPPORT_MULTIPART
 
 int WiFiWebServer::_uploadReadByte(WiFiClient& client)
 {
@@ -790,6 +1156,8 @@ int WiFiWebServer::_uploadReadByte(WiFiClient& client)
   return res;
 }
 
+#endif    // #if WEBSERVER_SUPPORT_MULTIPART
+
 ////////////////////////////////////////
 
 #endif    // #if USE_NEW_WEBSERVER_VERSION
@@ -800,6 +1168,8 @@ int WiFiWebServer::_uploadReadByte(WiFiClient& client)
 
 ////////////////////////////////////////
 
+#if WEBSERVER_SUPPORT_MULTIPART
+
 bool WiFiWebServer::_parseForm(WiFiClient& client, const String& boundary, uint32_t len)
 {
   (void) len;
@@ -918,25 +1288,9 @@ bool WiFiWebServer::_parseForm(WiFiClient& client, const String& boundary, uint3
           }
           else
           {
-            //_currentUpload.reset(new HTTPUpload());
-            if (!_currentUpload)
-              _currentUpload = new HTTPUpload();
-
-            _currentUpload->status = UPLOAD_FILE_START;
-            _currentUpload->name = argName;
-            _currentUpload->filename = argFilename;
-            _currentUpload->type = argType;
-            _currentUpload->totalSize = 0;
-            _currentUpload->currentSize = 0;
-            _currentUpload->contentLength = len;
-
-            WS_LOGDEBUG1(F("Start File: "), _currentUpload->filename);
-            WS_LOGDEBUG1(F("Type: "), _currentUpload->type);
+            if (!_uploadStart(argName, argFilename, argType, len))
+              return false;
 
-            if (_currentHandler && _currentHandler->canUpload(_currentUri))
-              _currentHandler->upload(*this, _currentUri, *_currentUpload);
-
-            _currentUpload->status = UPLOAD_FILE_WRITE;
             uint8_t argByte = _uploadReadByte(client);
 
 readfile:
@@ -959,171 +1313,513 @@ readfile:
             {
               argByte = _uploadReadByte(client);
 
-              if (!client.connected())
-                return _parseFormUploadAborted();
+              if (!client.connected())
+                return _parseFormUploadAborted();
+
+              if ((char)argByte != '-')
+              {
+                //continue reading the file
+                _uploadWriteByte(0x0D);
+                _uploadWriteByte(0x0A);
+                goto readfile;
+              }
+              else
+              {
+                argByte = _uploadReadByte(client);
+
+                if (!client.connected())
+                  return _parseFormUploadAborted();
+
+                if ((char)argByte != '-')
+                {
+                  //continue reading the file
+                  _uploadWriteByte(0x0D);
+                  _uploadWriteByte(0x0A);
+                  _uploadWriteByte((uint8_t)('-'));
+                  goto readfile;
+                }
+              }
+
+#define USING_VLA    true
+
+#if USING_VLA
+              // Better compiler warning than risk of fragmented heap
+              uint8_t endBuf[boundary.length()];
+#else
+              // No compiler warning, but risk of fragmented heap
+              uint8_t* endBuf = new uint8_t[boundary.length()];
+
+              if (!endBuf)
+              {
+                return false;
+              }
+
+#endif
+
+              client.readBytes(endBuf, boundary.length());
+
+              if (strstr((const char*)endBuf, boundary.c_str()) != NULL)
+              {
+                _uploadEnd();
+
+                line = client.readStringUntil(0x0D);
+                client.readStringUntil(0x0A);
+
+                if (line == "--")
+                {
+                  WS_LOGDEBUG(F("Done Parsing POST"));
+
+                  break;
+                }
+
+                continue;
+              }
+              else
+              {
+                _uploadWriteByte(0x0D);
+                _uploadWriteByte(0x0A);
+                _uploadWriteByte((uint8_t)('-'));
+                _uploadWriteByte((uint8_t)('-'));
+
+                uint32_t i = 0;
+
+                while (i < boundary.length())
+                {
+                  _uploadWriteByte(endBuf[i++]);
+                }
+
+                argByte = _uploadReadByte(client);
+                goto readfile;
+              }
+
+#if !USING_VLA
+
+              if (endBuf)
+                delete [] endBuf;
+
+#endif
+            }
+            else
+            {
+              _uploadWriteByte(0x0D);
+              goto readfile;
+            }
+
+            break;
+          }
+        }
+      }
+    }
+
+    _mergePostArgs();
+
+    return true;
+  }
+
+  WS_LOGDEBUG1(F("Error: line: "), line);
+
+  return false;
+}
+
+////////////////////////////////////////
+
+// The same form as _parseForm(), taken as it arrives so handleClient(budget_us) never waits for it
+void WiFiWebServer::_beginFormBody()
+{
+  if (_postArgs)
+    delete[] _postArgs;
+
+  _postArgs     = new RequestArgument[WEBSERVER_MAX_POST_ARGS];
+  _postArgsLen  = 0;
+
+  _formState    = FORM_PREAMBLE;
+  _parseLine    = String();
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_formBodyWrite(const uint8_t* data, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    uint8_t c = data[i];
+
+    if (_formState == FORM_DATA)
+    {
+      _formDataByte(c);
+
+      continue;
+    }
+
+    // Epilogue
+    if (_formState == FORM_DONE)
+      break;
+
+    if (c == '\r')
+      continue;
+
+    if (c != '\n')
+    {
+      if (_parseLine.length() >= WEBSERVER_MAX_LINE_LEN)
+      {
+        WS_LOGDEBUG1(F("_formBodyWrite: Line too long, max = "), WEBSERVER_MAX_LINE_LEN);
+
+        return false;
+      }
+
+      _parseLine += (char) c;
+
+      continue;
+    }
+
+    if (!_formLine())
+      return false;
+
+    _parseLine = "";
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_formLine()
+{
+  const String& line = _parseLine;
+
+  if (_formState != FORM_HEADERS)
+  {
+    bool last;
+
+    if (_formState == FORM_PREAMBLE)
+    {
+      String delimiter = "--" + _boundaryStr;
+
+      // Anything before the first boundary is ignored
+      if ( (line != delimiter) && (line != delimiter + "--") )
+        return true;
+
+      last = (line.length() > delimiter.length());
+    }
+    else
+    {
+      // Rest of the line of a boundary found in the data, "--" after the last one
+      last = line.startsWith("--");
+    }
+
+    if (last)
+    {
+      _formState = FORM_DONE;
+
+      return true;
+    }
+
+#if (ESP32 || ESP8266)
+    using namespace mime_esp;
+#else
+    using namespace mime;
+#endif
+
+    _formName     = String();
+    _formFilename = String();
+    _formType     = mimeTable[txt].mimeType;
+    _formIsFile   = false;
+    _formState    = FORM_HEADERS;
+
+    return true;
+  }
+
+  if (line.length() == 0)
+  {
+    // End of the part headers, its data follows
+    if (_formIsFile && !_uploadStart(_formName, _formFilename, _formType, _bodyLength))
+      return false;
+
+    _plainBuf   = String();
+    _formMatch  = 0;
+    _formState  = FORM_DATA;
+  }
+  else if (line.length() > 19 && line.substring(0, 19).equalsIgnoreCase(F("Content-Disposition")))
+  {
+    int nameStart = line.indexOf('=');
+
+    if (nameStart != -1)
+    {
+      _formName = line.substring(nameStart + 2);
+      nameStart = _formName.indexOf('=');
+
+      if (nameStart == -1)
+      {
+        _formName = _formName.substring(0, _formName.length() - 1);
+      }
+      else
+      {
+        _formFilename = _formName.substring(nameStart + 2, _formName.length() - 1);
+        _formName     = _formName.substring(0, _formName.indexOf('"'));
+        _formIsFile   = true;
+
+        //use GET to set the filename if uploading using blob
+        if (_formFilename == F("blob") && hasArg("filename"))
+          _formFilename = arg("filename");
+      }
+    }
+  }
+  else if (line.length() > 12 && line.substring(0, 12).equalsIgnoreCase("Content-Type"))
+  {
+    _formType = line.substring(line.indexOf(':') + 2);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_formDataByte(uint8_t c)
+{
+  // The part ends at "\r\n--" + boundary. '\r' only starts it, so a mismatch restarts the match at 0 or 1
+  static const char kDashes[] = "\r\n--";
+
+  uint16_t delimiterLength = 4 + _boundaryStr.length();
+
+  if ( c == (uint8_t) ((_formMatch < 4) ? kDashes[_formMatch] : _boundaryStr[_formMatch - 4]) )
+  {
+    if (++_formMatch < delimiterLength)
+      return;
+
+    if (_formIsFile)
+    {
+      _uploadEnd();
+    }
+    else if ( _formName.length() && (_postArgsLen < WEBSERVER_MAX_POST_ARGS) )
+    {
+      RequestArgument& arg = _postArgs[_postArgsLen++];
+      arg.key   = _formName;
+      arg.value = _plainBuf;
+    }
+
+    _plainBuf   = String();
+    _formState  = FORM_DELIMITER;
+
+    return;
+  }
+
+  // Not the delimiter after all, what was held back is data
+  for (uint16_t i = 0; i < _formMatch; i++)
+    _formData( (i < 4) ? kDashes[i] : _boundaryStr[i - 4] );
+
+  _formMatch = (c == '\r') ? 1 : 0;
+
+  if (!_formMatch)
+    _formData(c);
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_formData(uint8_t c)
+{
+  if (_formIsFile)
+    _uploadWriteByte(c);
+  else if (c != '\r')
+    _plainBuf += (char) c;    // Lines joined with '\n', as _parseForm() does
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_endFormBody()
+{
+  // The CRLF after the last boundary is optional
+  if ( (_formState == FORM_DELIMITER) && _parseLine.startsWith("--") )
+    _formState = FORM_DONE;
+
+  if (_formState != FORM_DONE)
+  {
+    WS_LOGDEBUG(F("_endFormBody: form cut short"));
+
+    return false;
+  }
+
+  _uploadRelease();
+  _mergePostArgs();
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_abortFormBody()
+{
+  if ( (_formState == FORM_DATA) && _formIsFile )
+    _parseFormUploadAborted();
+
+  _uploadRelease();
 
-              if ((char)argByte != '-')
-              {
-                //continue reading the file
-                _uploadWriteByte(0x0D);
-                _uploadWriteByte(0x0A);
-                goto readfile;
-              }
-              else
-              {
-                argByte = _uploadReadByte(client);
+  _formState    = FORM_DONE;
+  _formName     = String();
+  _formFilename = String();
+  _formType     = String();
+}
 
-                if (!client.connected())
-                  return _parseFormUploadAborted();
+#endif    // #if WEBSERVER_SUPPORT_MULTIPART
 
-                if ((char)argByte != '-')
-                {
-                  //continue reading the file
-                  _uploadWriteByte(0x0D);
-                  _uploadWriteByte(0x0A);
-                  _uploadWriteByte((uint8_t)('-'));
-                  goto readfile;
-                }
-              }
+////////////////////////////////////////
 
-#define USING_VLA    true
+void WiFiWebServer::_mergePostArgs()
+{
+  int iarg;
+  int totalArgs = ((WEBSERVER_MAX_POST_ARGS - _postArgsLen) < _currentArgCount) ? (WEBSERVER_MAX_POST_ARGS - _postArgsLen)
+                  : _currentArgCount;
 
-#if USING_VLA
-              // Better compiler warning than risk of fragmented heap
-              uint8_t endBuf[boundary.length()];
-#else
-              // No compiler warning, but risk of fragmented heap
-              uint8_t* endBuf = new uint8_t[boundary.length()];
+  for (iarg = 0; iarg < totalArgs; iarg++)
+  {
+    RequestArgument& arg = _postArgs[_postArgsLen++];
+    arg.key = _currentArgs[iarg].key;
+    arg.value = _currentArgs[iarg].value;
+  }
 
-              if (!endBuf)
-              {
-                return false;
-              }
+  if (_currentArgs)
+    delete[] _currentArgs;
 
-#endif
+  _currentArgs = new RequestArgument[_postArgsLen];
 
-              client.readBytes(endBuf, boundary.length());
+  for (iarg = 0; iarg < _postArgsLen; iarg++)
+  {
+    RequestArgument& arg = _currentArgs[iarg];
+    arg.key = _postArgs[iarg].key;
+    arg.value = _postArgs[iarg].value;
+  }
 
-              if (strstr((const char*)endBuf, boundary.c_str()) != NULL)
-              {
-                if (_currentHandler && _currentHandler->canUpload(_currentUri))
-                  _currentHandler->upload(*this, _currentUri, *_currentUpload);
+  _currentArgCount = iarg;
 
-                _currentUpload->totalSize += _currentUpload->currentSize;
-                _currentUpload->status = UPLOAD_FILE_END;
+  if (_postArgs)
+  {
+    delete[] _postArgs;
+    _postArgs = nullptr;
+    _postArgsLen = 0;
+  }
+}
 
-                if (_currentHandler && _currentHandler->canUpload(_currentUri))
-                  _currentHandler->upload(*this, _currentUri, *_currentUpload);
+////////////////////////////////////////
 
-                WS_LOGDEBUG1(F("End File: "), _currentUpload->filename);
-                WS_LOGDEBUG1(F("Type: "), _currentUpload->type);
-                WS_LOGDEBUG1(F("Size: "), _currentUpload->totalSize);
+bool WiFiWebServer::_parseJsonBody(WiFiClient& client, uint32_t len)
+{
+  _beginJsonBody();
 
-                line = client.readStringUntil(0x0D);
-                client.readStringUntil(0x0A);
+  // Small stack block, the body itself is never held in memory
+  uint8_t   buf[64];
+  uint32_t  remaining = len;
 
-                if (line == "--")
-                {
-                  WS_LOGDEBUG(F("Done Parsing POST"));
+  while (remaining)
+  {
+    int tries = HTTP_MAX_POST_WAIT;
+    size_t avail;
 
-                  break;
-                }
+    while (!(avail = client.available()) && tries--)
+      delay(1);
 
-                continue;
-              }
-              else
-              {
-                _uploadWriteByte(0x0D);
-                _uploadWriteByte(0x0A);
-                _uploadWriteByte((uint8_t)('-'));
-                _uploadWriteByte((uint8_t)('-'));
+    if (!avail)
+      break;
 
-                uint32_t i = 0;
+    if (avail > sizeof(buf))
+      avail = sizeof(buf);
 
-                while (i < boundary.length())
-                {
-                  _uploadWriteByte(endBuf[i++]);
-                }
+    if (avail > remaining)
+      avail = remaining;
 
-                argByte = _uploadReadByte(client);
-                goto readfile;
-              }
+    int readLen = client.read(buf, avail);
 
-#if !USING_VLA
+    if (readLen <= 0)
+      break;
 
-              if (endBuf)
-                delete [] endBuf;
+    // Keep draining the body after a syntax error, args already seen are kept
+    _jsonTokenizer->write((const char*) buf, readLen);
+    remaining -= readLen;
+  }
 
-#endif
-            }
-            else
-            {
-              _uploadWriteByte(0x0D);
-              goto readfile;
-            }
+  bool valid = _endJsonBody();
 
-            break;
-          }
-        }
-      }
-    }
+  if (remaining)
+  {
+    return false;
+  }
 
-    int iarg;
-    int totalArgs = ((WEBSERVER_MAX_POST_ARGS - _postArgsLen) < _currentArgCount) ? (WEBSERVER_MAX_POST_ARGS - _postArgsLen)
-                    : _currentArgCount;
+  if (!valid)
+  {
+    _sendParseError(400);
 
-    for (iarg = 0; iarg < totalArgs; iarg++)
-    {
-      RequestArgument& arg = _postArgs[_postArgsLen++];
-      arg.key = _currentArgs[iarg].key;
-      arg.value = _currentArgs[iarg].value;
-    }
+    return false;
+  }
 
-    if (_currentArgs)
-      delete[] _currentArgs;
+  return true;
+}
 
-    _currentArgs = new RequestArgument[_postArgsLen];
+////////////////////////////////////////
 
-    for (iarg = 0; iarg < _postArgsLen; iarg++)
-    {
-      RequestArgument& arg = _currentArgs[iarg];
-      arg.key = _postArgs[iarg].key;
-      arg.value = _postArgs[iarg].value;
-    }
+void WiFiWebServer::_beginJsonBody()
+{
+  if (_postArgs)
+    delete[] _postArgs;
 
-    _currentArgCount = iarg;
+  _postArgs = new RequestArgument[WEBSERVER_MAX_POST_ARGS];
+  _postArgsLen = 0;
 
-    if (_postArgs)
-    {
-      delete[] _postArgs;
-      _postArgs = nullptr;
-      _postArgsLen = 0;
-    }
+  _jsonTokenizer->reset();
+}
 
-    return true;
+////////////////////////////////////////
+
+bool WiFiWebServer::_endJsonBody()
+{
+  if (_jsonTokenizer->truncated())
+  {
+    WS_LOGDEBUG1(F("_parseJsonBody: value truncated to "), WS_JSON_MAX_VALUE_LEN);
   }
 
-  WS_LOGDEBUG1(F("Error: line: "), line);
+  if (!_jsonTokenizer->finish())
+  {
+    WS_LOGDEBUG(F("_parseJsonBody: invalid or incomplete JSON"));
 
-  return false;
+    return false;
+  }
+
+  return true;
 }
 
-bool WiFiWebServer::_parseFormUploadAborted()
-{
-  _currentUpload->status = UPLOAD_FILE_ABORTED;
+////////////////////////////////////////
 
-  if (_currentHandler && _currentHandler->canUpload(_currentUri))
-    _currentHandler->upload(*this, _currentUri, *_currentUpload);
+void WiFiWebServer::_sendParseError(int code)
+{
+  // No handler runs for this request, answer before the connection is closed
+  _contentLength    = CONTENT_LENGTH_NOT_SET;
+  _responseHeaders  = String();
 
-  return false;
+  send(code);
 }
 
 ////////////////////////////////////////
 
+void WiFiWebServer::_jsonValueCallback(void* context, const char* path, int index, const char* value)
+{
+  WiFiWebServer* server = (WiFiWebServer*) context;
+
+  if (index >= 0)
+  {
+    if (server->_jsonElementHandler)
+      server->_jsonElementHandler(path, index, value);
+  }
+  else if (path[0] && (server->_postArgsLen < WEBSERVER_MAX_POST_ARGS))
+  {
+    RequestArgument& arg = server->_postArgs[server->_postArgsLen++];
+    arg.key   = path;
+    arg.value = value;
+  }
+}
+
 #else   // #if USE_NEW_WEBSERVER_VERSION
 
 ////////////////////////////////////////
 
+#if WEBSERVER_SUPPORT_MULTIPART
+
 bool WiFiWebServer::_parseForm(WiFiClient& client, const String& boundary, uint32_t len)
 {
   WS_LOGDEBUG1(F("Parse Form: Boundary: "), boundary);
@@ -1233,21 +1929,10 @@ bool WiFiWebServer::_parseForm(WiFiClient& client, const String& boundary, uint3
           }
           else
           {
-            _currentUpload.status       = UPLOAD_FILE_START;
-            _currentUpload.name         = argName;
-            _currentUpload.filename     = argFilename;
-            _currentUpload.type         = argType;
-            _currentUpload.totalSize    = 0;
-            _currentUpload.currentSize  = 0;
-
-            WS_LOGDEBUG1(F("Start File: "), _currentUpload.filename);
-            WS_LOGDEBUG1(F("Type: "), _currentUpload.type);
-
-            if (_currentHandler && _currentHandler->canUpload(_currentUri))
-              _currentHandler->upload(*this, _currentUri, _currentUpload);
+            if (!_uploadStart(argName, argFilename, argType, len))
+              return false;
 
-            _currentUpload.status = UPLOAD_FILE_WRITE;
-            uint8_t argByte       = _uploadReadByte(client);
+            uint8_t argByte = _uploadReadByte(client);
 
 readfile:
 
@@ -1316,18 +2001,7 @@ readfile:
 
               if (strstr((const char*)endBuf, boundary.c_str()) != NULL)
               {
-                if (_currentHandler && _currentHandler->canUpload(_currentUri))
-                  _currentHandler->upload(*this, _currentUri, _currentUpload);
-
-                _currentUpload.totalSize += _currentUpload.currentSize;
-                _currentUpload.status = UPLOAD_FILE_END;
-
-                if (_currentHandler && _currentHandler->canUpload(_currentUri))
-                  _currentHandler->upload(*this, _currentUri, _currentUpload);
-
-                WS_LOGDEBUG1(F("End File: "), _currentUpload.filename);
-                WS_LOGDEBUG1(F("Type: "), _currentUpload.type);
-                WS_LOGDEBUG1(F("Size: "), _currentUpload.totalSize);
+                _uploadEnd();
 
                 line = client.readStringUntil(0x0D);
                 client.readStringUntil(0x0A);
@@ -1415,6 +2089,87 @@ readfile:
 
 ////////////////////////////////////////
 
+#endif    // #if WEBSERVER_SUPPORT_MULTIPART
+
+////////////////////////////////////////
+
+#endif    // #if USE_NEW_WEBSERVER_VERSION
+
+////////////////////////////////////////
+
+#if WEBSERVER_SUPPORT_UPLOAD
+
+bool WiFiWebServer::_uploadStart(const String& name, const String& filename, const String& type, uint32_t len)
+{
+  // Further files of the same form reuse the buffer
+  if (!_currentUpload.buf)
+  {
+    _currentUpload.bufSize  = _currentHandler ? _currentHandler->uploadBufferSize() : HTTP_UPLOAD_BUFLEN;
+    _currentUpload.buf      = WiFiUploadBufferPool::acquire(_currentUpload.bufSize);
+
+    if (!_currentUpload.buf)
+    {
+      WS_LOGERROR1(F("Upload: no memory for buffer of "), _currentUpload.bufSize);
+
+      return false;
+    }
+  }
+
+  _currentUpload.status         = UPLOAD_FILE_START;
+  _currentUpload.name           = name;
+  _currentUpload.filename       = filename;
+  _currentUpload.type           = type;
+  _currentUpload.totalSize      = 0;
+  _currentUpload.currentSize    = 0;
+  _currentUpload.contentLength  = len;
+
+  WS_LOGDEBUG1(F("Start File: "), _currentUpload.filename);
+  WS_LOGDEBUG1(F("Type: "), _currentUpload.type);
+
+  if (_currentHandler && _currentHandler->canUpload(_currentUri))
+    _currentHandler->upload(*this, _currentUri, _currentUpload);
+
+  _currentUpload.status = UPLOAD_FILE_WRITE;
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_uploadWriteByte(uint8_t b)
+{
+  if (_currentUpload.currentSize == _currentUpload.bufSize)
+  {
+    if (_currentHandler && _currentHandler->canUpload(_currentUri))
+      _currentHandler->upload(*this, _currentUri, _currentUpload);
+
+    _currentUpload.totalSize += _currentUpload.currentSize;
+    _currentUpload.currentSize = 0;
+  }
+
+  _currentUpload.buf[_currentUpload.currentSize++] = b;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_uploadEnd()
+{
+  if (_currentHandler && _currentHandler->canUpload(_currentUri))
+    _currentHandler->upload(*this, _currentUri, _currentUpload);
+
+  _currentUpload.totalSize += _currentUpload.currentSize;
+  _currentUpload.status = UPLOAD_FILE_END;
+
+  if (_currentHandler && _currentHandler->canUpload(_currentUri))
+    _currentHandler->upload(*this, _currentUri, _currentUpload);
+
+  WS_LOGDEBUG1(F("End File: "), _currentUpload.filename);
+  WS_LOGDEBUG1(F("Type: "), _currentUpload.type);
+  WS_LOGDEBUG1(F("Size: "), _currentUpload.totalSize);
+}
+
+////////////////////////////////////////
+
 bool WiFiWebServer::_parseFormUploadAborted()
 {
   _currentUpload.status = UPLOAD_FILE_ABORTED;
@@ -1427,7 +2182,52 @@ bool WiFiWebServer::_parseFormUploadAborted()
 
 ////////////////////////////////////////
 
-#endif    // #if USE_NEW_WEBSERVER_VERSION
+void WiFiWebServer::_uploadRelease()
+{
+  WiFiUploadBufferPool::release(_currentUpload.buf);
+
+  _currentUpload.buf = NULL;
+}
+
+////////////////////////////////////////
+
+#elif WEBSERVER_SUPPORT_MULTIPART
+
+// File parts are read and dropped
+
+bool WiFiWebServer::_uploadStart(const String&, const String&, const String&, uint32_t)
+{
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_uploadWriteByte(uint8_t)
+{
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_uploadEnd()
+{
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_parseFormUploadAborted()
+{
+  return false;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_uploadRelease()
+{
+}
+
+////////////////////////////////////////
+
+#endif    // #if WEBSERVER_SUPPORT_UPLOAD
 
 ////////////////////////////////////////
 
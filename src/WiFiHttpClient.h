@@ -46,7 +46,16 @@
 #include <Arduino.h>
 
 #include "utility/WiFiDebug.h"
+#include "utility/WiFiFeatures.h"
+
+#if !WEBSERVER_SUPPORT_HTTP_CLIENT
+  #error WiFiHttpClient.h included, but the library is built with WEBSERVER_SUPPORT_HTTP_CLIENT false
+#endif
+
 #include "WiFi_HTTPClient/WiFi_HttpClient.h"
+#include "WiFi_HTTPClient/WiFi_HttpConnectionPool.h"
+#include "WiFi_HTTPClient/WiFi_DnsCache.h"
+#include "WiFi_HTTPClient/WiFi_Deflate.h"
 #include "WiFi_HTTPClient/WiFi_WebSocketClient.h"
 #include "WiFi_HTTPClient/WiFi_URLEncoder.h"
 
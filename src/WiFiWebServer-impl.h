@@ -40,7 +40,7 @@
 #define WiFiWebServer_Impl_H
 
 #include <Arduino.h>
-#include <libb64/cencode.h>
+#include "utility/Base64Codec.h"
 
 #include "WiFiWebServer.hpp"
 #include "utility/RequestHandlersImpl.h"
@@ -88,8 +88,7 @@ String fromWWString(const WWString&& str)
 
 #if (ESP32 || ESP8266)
 WiFiWebServer::WiFiWebServer(IPAddress addr, int port)
-  : _corsEnabled(false)
-  , _server(addr, port)
+  : _server(addr, port)
   , _currentMethod(HTTP_ANY)
   , _currentVersion(0)
   , _currentStatus(HC_NONE)
@@ -102,8 +101,6 @@ WiFiWebServer::WiFiWebServer(IPAddress addr, int port)
   , _currentArgs(nullptr)
   , _postArgsLen(0)
   , _postArgs(nullptr)
-  , _headerKeysCount(0)
-  , _currentHeaders(nullptr)
   , _contentLength(0)
   , _clientContentLength(0)
   , _chunked(false)
@@ -114,8 +111,7 @@ WiFiWebServer::WiFiWebServer(IPAddress addr, int port)
 ////////////////////////////////////////
 
 WiFiWebServer::WiFiWebServer(int port)
-  : _corsEnabled(false)
-  , _server(port)
+  : _server(port)
   , _currentMethod(HTTP_ANY)
   , _currentVersion(0)
   , _currentStatus(HC_NONE)
@@ -128,8 +124,6 @@ WiFiWebServer::WiFiWebServer(int port)
   , _currentArgs(nullptr)
   , _postArgsLen(0)
   , _postArgs(nullptr)
-  , _headerKeysCount(0)
-  , _currentHeaders(nullptr)
   , _contentLength(0)
   , _clientContentLength(0)
   , _chunked(false)
@@ -144,8 +138,10 @@ WiFiWebServer::~WiFiWebServer()
   _server.close();
 #endif
 
+#if WEBSERVER_SUPPORT_HEADERS
   if (_currentHeaders)
     delete[]_currentHeaders;
+#endif
 
   RequestHandler* handler = _firstHandler;
 
@@ -155,6 +151,14 @@ WiFiWebServer::~WiFiWebServer()
     delete handler;
     handler = next;
   }
+
+  if (_jsonTokenizer)
+    delete _jsonTokenizer;
+
+  for (int i = 0; i < WEBSERVER_MAX_DEFERRED; i++)
+  {
+    _releaseDeferred(i);
+  }
 }
 
 ////////////////////////////////////////
@@ -188,8 +192,7 @@ void WiFiWebServer::begin(uint16_t port)
 ////////////////////////////////////////
 
 WiFiWebServer::WiFiWebServer(int port)
-  : _corsEnabled(false)
-  , _server(port)
+  : _server(port)
   , _currentMethod(HTTP_ANY)
   , _currentVersion(0)
   , _currentHandler(nullptr)
@@ -197,8 +200,6 @@ WiFiWebServer::WiFiWebServer(int port)
   , _lastHandler(nullptr)
   , _currentArgCount(0)
   , _currentArgs(nullptr)
-  , _headerKeysCount(0)
-  , _currentHeaders(nullptr)
   , _contentLength(0)
   , _chunked(false)
 {
@@ -208,10 +209,16 @@ WiFiWebServer::WiFiWebServer(int port)
 
 WiFiWebServer::~WiFiWebServer()
 {
+  // close() may collectHeaders() again, so before _currentHeaders is deleted
+  close();
+
+#if WEBSERVER_SUPPORT_HEADERS
   if (_currentHeaders)
     delete[]_currentHeaders;
 
   _headerKeysCount = 0;
+#endif
+
   RequestHandler* handler = _firstHandler;
 
   while (handler)
@@ -220,8 +227,6 @@ WiFiWebServer::~WiFiWebServer()
     delete handler;
     handler = next;
   }
-
-  close();
 }
 
 ////////////////////////////////////////
@@ -231,8 +236,10 @@ void WiFiWebServer::begin()
   _currentStatus = HC_NONE;
   _server.begin();
 
+#if WEBSERVER_SUPPORT_HEADERS
   if (!_headerKeysCount)
     collectHeaders(0, 0);
+#endif
 }
 
 ////////////////////////////////////////
@@ -241,218 +248,1201 @@ void WiFiWebServer::begin()
 
 ////////////////////////////////////////
 
+#if WEBSERVER_SUPPORT_AUTH
+
 bool WiFiWebServer::authenticate(const char * username, const char * password)
 {
-  if (hasHeader(AUTHORIZATION_HEADER))
+  const char* token;
+  size_t      length;
+
+  if (_authorization("Digest", token, length))
+  {
+    DigestField fields[DIGEST_FIELDS];
+    int         algorithm = _digestFields(token, length, fields);
+
+    if ( (algorithm < 0) || (fields[DIGEST_USERNAME].length != strlen(username))
+         || strncmp(fields[DIGEST_USERNAME].value, username, fields[DIGEST_USERNAME].length) )
+    {
+      return false;
+    }
+
+    // HA1 = H(username:realm:password). _digestVerify() checks the realm is the one challenged
+    WiFiDigestHash  hash(algorithm);
+    uint8_t         ha1[WS_DIGEST_MAX_SIZE];
+
+    hash.update(username);
+    hash.update(":");
+    hash.update(fields[DIGEST_REALM].value, fields[DIGEST_REALM].length);
+    hash.update(":");
+    hash.update(password);
+    hash.finish(ha1);
+
+    return _digestVerify(fields, algorithm, ha1);
+  }
+
+  if (!_authorization("Basic", token, length))
+    return false;
+
+  // Encode "username:password" a block at a time, comparing as it goes, so
+  // nothing is allocated whatever the length of the credentials
+  static const size_t kBlockSize = 24;
+
+  WiFiBase64Encoder encoder;
+  char              encoded[WS_BASE64_ENCODED_LENGTH(kBlockSize + 2) + 1];
+
+  uint8_t     diff    = 0;
+  size_t      offset  = 0;
+
+  const char* parts[] = { username, ":", password };
+
+  for (uint8_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++)
   {
-    String authReq = header(AUTHORIZATION_HEADER);
+    const uint8_t*  input   = (const uint8_t*) parts[i];
+    size_t          left    = strlen(parts[i]);
 
-    if (authReq.startsWith("Basic"))
+    while (left)
     {
-      authReq = authReq.substring(6);
-      authReq.trim();
-      char toencodeLen = strlen(username) + strlen(password) + 1;
-      char *toencode = new char[toencodeLen + 1];
+      size_t block = min(left, kBlockSize);
+      size_t count = encoder.update(input, block, encoded);
+
+      diff   |= _constantTimeDiff(token + min(offset, length), length - min(offset, length), encoded, count);
+      offset += count;
+      input  += block;
+      left   -= block;
+    }
+  }
+
+  size_t count = encoder.finish(encoded);
+
+  diff   |= _constantTimeDiff(token + min(offset, length), length - min(offset, length), encoded, count);
+  offset += count;
+
+  return (diff == 0) && (offset == length);
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::setCredentials(const char * username, const char * password, const char * realm)
+{
+  size_t usernameLength = strlen(username);
+  size_t passwordLength = strlen(password);
+
+  if ( (_credentialsCount >= WEBSERVER_MAX_CREDENTIALS) || (usernameLength + 1 + passwordLength > WEBSERVER_MAX_CREDENTIAL_LENGTH) )
+    return false;
+
+  Credential&       credential  = _credentials[_credentialsCount];
+  WiFiBase64Encoder encoder;
+  char*             token       = credential.token;
+
+  credential.usernameLength = usernameLength;
+
+  token += encoder.update((const uint8_t*) username, usernameLength, token);
+  token += encoder.update((const uint8_t*) ":", 1, token);
+  token += encoder.update((const uint8_t*) password, passwordLength, token);
+  encoder.finish(token);
+
+  if (!realm)
+    realm = WEBSERVER_AUTH_REALM;
+
+  WiFiDigestHash hash;
+
+  for (uint8_t algorithm = WiFiDigestHash::HASH_MD5; algorithm <= WiFiDigestHash::HASH_SHA256; algorithm++)
+  {
+    hash.begin(algorithm);
+    hash.update(username);
+    hash.update(":");
+    hash.update(realm);
+    hash.update(":");
+    hash.update(password);
+    hash.finish( (algorithm == WiFiDigestHash::HASH_SHA256) ? credential.ha1Sha256 : credential.ha1Md5 );
+  }
+
+  _credentialsCount++;
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::clearCredentials()
+{
+  memset(_credentials, 0, sizeof(_credentials));
+  _credentialsCount = 0;
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::authenticate()
+{
+  const char* token;
+  size_t      length;
+
+  if (_authorization("Digest", token, length))
+  {
+    DigestField fields[DIGEST_FIELDS];
+    int         algorithm = _digestFields(token, length, fields);
+
+    const DigestField& username = fields[DIGEST_USERNAME];
+
+    if ( (algorithm < 0) || (username.length + 1 > WEBSERVER_MAX_CREDENTIAL_LENGTH) )
+      return false;
 
-      if (toencode == NULL)
+    // Each token starts with its "username:" encoded, so the username sent is encoded once
+    // the same way and compared with that prefix. Of the last, partial group, only the first
+    // characters are made of "username:" bits alone
+    WiFiBase64Encoder encoder;
+    char              user[WS_BASE64_ENCODED_LENGTH(WEBSERVER_MAX_CREDENTIAL_LENGTH) + 1];
+    size_t            userLength;
+
+    userLength  = encoder.update((const uint8_t*) username.value, username.length, user);
+    userLength += encoder.update((const uint8_t*) ":", 1, user + userLength);
+    encoder.finish(user + userLength);
+    userLength += (username.length + 1) % 3;
+
+    // The username is sent in the clear, so only the HA1 of the user it names is checked
+    for (uint8_t i = 0; i < _credentialsCount; i++)
+    {
+      if ( (_credentials[i].usernameLength == username.length) && !strncmp(_credentials[i].token, user, userLength) )
       {
-        authReq = String();
+        return _digestVerify(fields, algorithm,
+                             (algorithm == WiFiDigestHash::HASH_SHA256) ? _credentials[i].ha1Sha256 : _credentials[i].ha1Md5);
+      }
+    }
+
+    return false;
+  }
+
+  if (!_authorization("Basic", token, length))
+    return false;
+
+  bool match = false;
+
+  // Every user is compared, so the time doesn't tell which one matched
+  for (uint8_t i = 0; i < _credentialsCount; i++)
+  {
+    size_t expectedLength = strlen(_credentials[i].token);
+
+    match |= (_constantTimeDiff(token, length, _credentials[i].token, expectedLength) == 0) && (length == expectedLength);
+  }
+
+  return match;
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_authorization(const char* scheme, const char*& token, size_t& length)
+{
+  for (int i = 0; i < _headerKeysCount; ++i)
+  {
+    if (_currentHeaders[i].key == AUTHORIZATION_HEADER)
+    {
+      const String& value         = _currentHeaders[i].value;
+      size_t        schemeLength  = strlen(scheme);
 
+      if ( (value.length() <= schemeLength) || strncasecmp(value.c_str(), scheme, schemeLength) || (value[schemeLength] != ' ') )
         return false;
+
+      token   = value.c_str() + schemeLength;
+      length  = value.length() - schemeLength;
+
+      while (length && (*token == ' '))
+      {
+        token++;
+        length--;
       }
 
-      char *encoded = new char[base64_encode_expected_len(toencodeLen) + 1];
+      while (length && isSpace(token[length - 1]))
+        length--;
+
+      return (length > 0);
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////
+
+uint8_t WiFiWebServer::_constantTimeDiff(const char* received, size_t receivedLength, const char* expected, size_t expectedLength)
+{
+  uint8_t diff = 0;
+
+  for (size_t i = 0; i < expectedLength; i++)
+  {
+    // Past the end of received, compare with NUL, which base64 never contains
+    diff |= (uint8_t) ( ((i < receivedLength) ? received[i] : 0) ^ expected[i] );
+  }
+
+  return diff;
+}
+
+////////////////////////////////////////
+
+int WiFiWebServer::_digestFields(const char* params, size_t length, DigestField* fields)
+{
+  static const char* const kNames[DIGEST_FIELDS] =
+  {
+    "username", "realm", "nonce", "uri", "response", "algorithm", "qop", "nc", "cnonce"
+  };
+
+  memset(fields, 0, DIGEST_FIELDS * sizeof(DigestField));
+
+  const char* end = params + length;
+
+  // name=value or name="value", separated by commas
+  while (params < end)
+  {
+    while ( (params < end) && ((*params == ',') || (*params == ' ')) )
+      params++;
+
+    const char* name = params;
+
+    while ( (params < end) && (*params != '=') && (*params != ',') )
+      params++;
+
+    size_t nameLength = params - name;
+
+    while (nameLength && (name[nameLength - 1] == ' '))
+      nameLength--;
+
+    if ( (params >= end) || (*params != '=') )
+      continue;
+
+    params++;
+
+    while ( (params < end) && (*params == ' ') )
+      params++;
 
-      if (encoded == NULL)
+    const char* value;
+    size_t      valueLength;
+
+    if ( (params < end) && (*params == '"') )
+    {
+      value = ++params;
+
+      while ( (params < end) && (*params != '"') )
       {
-        authReq = String();
-        delete[] toencode;
+        if ( (*params == '\\') && (params + 1 < end) )
+          params++;
 
-        return false;
+        params++;
       }
 
-      sprintf(toencode, "%s:%s", username, password);
+      if (params >= end)
+        return -1;
 
-      if (base64_encode_chars(toencode, toencodeLen, encoded) > 0 && authReq.equals(encoded))
-      {
-        authReq = String();
-        delete[] toencode;
-        delete[] encoded;
+      valueLength = params++ - value;
+    }
+    else
+    {
+      value = params;
 
-        return true;
+      while ( (params < end) && (*params != ',') && (*params != ' ') )
+        params++;
+
+      valueLength = params - value;
+    }
+
+    for (uint8_t i = 0; i < DIGEST_FIELDS; i++)
+    {
+      if ( (strlen(kNames[i]) == nameLength) && !strncasecmp(name, kNames[i], nameLength) )
+      {
+        fields[i].value  = value;
+        fields[i].length = valueLength;
+        break;
       }
+    }
+  }
+
+  for (uint8_t i = 0; i < DIGEST_FIELDS; i++)
+  {
+    if ( !fields[i].value && (i != DIGEST_ALGORITHM) )
+      return -1;
+  }
+
+  // Only qop=auth is offered, so nc and cnonce are always there
+  if ( (fields[DIGEST_QOP].length != 4) || strncasecmp(fields[DIGEST_QOP].value, "auth", 4)
+       || (fields[DIGEST_NC].length != 8) )
+  {
+    return -1;
+  }
+
+  const DigestField& algorithm = fields[DIGEST_ALGORITHM];
+
+  if ( !algorithm.value || ((algorithm.length == 3) && !strncasecmp(algorithm.value, "MD5", 3)) )
+    return WiFiDigestHash::HASH_MD5;
+
+  if ( (algorithm.length == 7) && !strncasecmp(algorithm.value, "SHA-256", 7) )
+    return WiFiDigestHash::HASH_SHA256;
+
+  return -1;
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_digestVerify(const DigestField* fields, uint8_t algorithm, const uint8_t* ha1)
+{
+  const DigestField& uri = fields[DIGEST_URI];
+
+  _digestStale = false;
+
+  // The uri answered must be this request's, with or without its query
+  if ( (uri.length < _currentUri.length()) || strncmp(uri.value, _currentUri.c_str(), _currentUri.length())
+       || ( (uri.length > _currentUri.length()) && (uri.value[_currentUri.length()] != '?') ) )
+  {
+    return false;
+  }
+
+  // response = H(HA1:nonce:nc:cnonce:qop:H(method:uri)), all digests in hex
+  WiFiDigestHash  hash(algorithm);
+  char            ha2[2 * WS_DIGEST_MAX_SIZE + 1];
+  char            expected[2 * WS_DIGEST_MAX_SIZE + 1];
+
+  hash.update(_methodName());
+  hash.update(":");
+  hash.update(uri.value, uri.length);
+  hash.finishHex(ha2);
+
+  WiFiDigestHash::toHex(ha1, hash.size(), expected);
+
+  hash.update(expected);
+
+  static const uint8_t kParts[] = { DIGEST_NONCE, DIGEST_NC, DIGEST_CNONCE, DIGEST_QOP };
 
-      delete[] toencode;
-      delete[] encoded;
+  for (uint8_t i = 0; i < sizeof(kParts); i++)
+  {
+    hash.update(":");
+    hash.update(fields[kParts[i]].value, fields[kParts[i]].length);
+  }
+
+  hash.update(":");
+  hash.update(ha2);
+  hash.finishHex(expected);
+
+  const DigestField&  response  = fields[DIGEST_RESPONSE];
+  size_t              length    = strlen(expected);
+
+  if ( _constantTimeDiff(response.value, response.length, expected, length) || (response.length != length) )
+    return false;
+
+  // A right answer to a nonce we didn't issue, or issued too long ago, asks for stale=true
+  char      nc[9];
+  uint32_t  count;
+
+  memcpy(nc, fields[DIGEST_NC].value, 8);
+  nc[8] = '\0';
+  count = strtoul(nc, NULL, 16);
+
+  for (uint8_t i = 0; i < WEBSERVER_MAX_NONCES; i++)
+  {
+    DigestNonce& nonce = _nonces[i];
+
+    if ( (nonce.value[0] == '\0') || (fields[DIGEST_NONCE].length != strlen(nonce.value))
+         || strncmp(fields[DIGEST_NONCE].value, nonce.value, fields[DIGEST_NONCE].length) )
+    {
+      continue;
+    }
+
+    // Right for another realm than the nonce was issued for isn't right, nor stale
+    if (nonce.realm != _realmHash(fields[DIGEST_REALM].value, fields[DIGEST_REALM].length))
+      return false;
+
+    if ((unsigned long) (millis() - nonce.issued) > WEBSERVER_NONCE_LIFETIME)
+    {
+      nonce.value[0] = '\0';
+      break;
     }
 
-    authReq = String();
+    // Each nc is accepted once, so a captured request can't be replayed
+    if (count <= nonce.count)
+      return false;
+
+    nonce.count = count;
+
+    return true;
   }
 
+  _digestStale = true;
+
   return false;
 }
 
 ////////////////////////////////////////
 
-void WiFiWebServer::requestAuthentication()
+const char* WiFiWebServer::_newNonce(const char* realm)
+{
+  DigestNonce*  slot = &_nonces[0];
+
+  for (uint8_t i = 0; i < WEBSERVER_MAX_NONCES; i++)
+  {
+    if (_nonces[i].value[0] == '\0')
+    {
+      slot = &_nonces[i];
+      break;
+    }
+
+    if ((unsigned long) (millis() - _nonces[i].issued) > (unsigned long) (millis() - slot->issued))
+      slot = &_nonces[i];
+  }
+
+  // random() alone repeats after a reset, so the sequence and the time go in too
+  WiFiDigestHash  hash;
+  uint32_t        seed[4] = { (uint32_t) random(0x7FFFFFFF), (uint32_t) micros(), ++_nonceSequence, (uint32_t) random(0x7FFFFFFF) };
+
+  hash.update(seed, sizeof(seed));
+  hash.finishHex(slot->value);
+
+  slot->issued = millis();
+  slot->count  = 0;
+  slot->realm  = _realmHash(realm, strlen(realm));
+
+  return slot->value;
+}
+
+////////////////////////////////////////
+
+uint32_t WiFiWebServer::_realmHash(const char* realm, size_t length)
+{
+  uint32_t hash = 2166136261UL;
+
+  while (length--)
+  {
+    hash ^= (uint8_t) *realm++;
+    hash *= 16777619UL;
+  }
+
+  return hash;
+}
+
+////////////////////////////////////////
+
+const char* WiFiWebServer::_methodName() const
+{
+  switch (_currentMethod)
+  {
+    case HTTP_HEAD:
+      return "HEAD";
+
+    case HTTP_POST:
+      return "POST";
+
+    case HTTP_PUT:
+      return "PUT";
+
+    case HTTP_PATCH:
+      return "PATCH";
+
+    case HTTP_DELETE:
+      return "DELETE";
+
+    case HTTP_OPTIONS:
+      return "OPTIONS";
+
+    default:
+      return "GET";
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::requestAuthentication(HTTPAuthMethod mode, const char* realm, const String& authFailMsg)
+{
+  if (!realm)
+    realm = WEBSERVER_AUTH_REALM;
+
+  String challenge;
+
+  if (mode == BASIC_AUTH)
+  {
+    challenge.reserve(16 + strlen(realm));
+    challenge  = F("Basic realm=\"");
+    challenge += realm;
+    challenge += '"';
+
+    sendHeader("WWW-Authenticate", challenge);
+  }
+  else
+  {
+    const char* nonce = _newNonce(realm);
+
+    // Strongest first, clients pick the first they support. One nonce serves both
+    static const uint8_t kAlgorithms[] = { WiFiDigestHash::HASH_SHA256, WiFiDigestHash::HASH_MD5 };
+
+    for (uint8_t i = 0; i < sizeof(kAlgorithms); i++)
+    {
+      challenge.reserve(96 + strlen(realm));
+      challenge  = F("Digest realm=\"");
+      challenge += realm;
+      challenge += F("\", qop=\"auth\", algorithm=");
+      challenge += (kAlgorithms[i] == WiFiDigestHash::HASH_SHA256) ? F("SHA-256") : F("MD5");
+      challenge += F(", nonce=\"");
+      challenge += nonce;
+      challenge += '"';
+
+      if (_digestStale)
+        challenge += F(", stale=true");
+
+      sendHeader("WWW-Authenticate", challenge);
+    }
+
+    _digestStale = false;
+  }
+
+  if (authFailMsg.length())
+    send(401, "text/html", authFailMsg);
+  else
+    send(401);
+}
+
+////////////////////////////////////////
+
+#endif    // #if WEBSERVER_SUPPORT_AUTH
+
+////////////////////////////////////////
+
+RequestHandler& WiFiWebServer::on(const String &uri, WiFiWebServer::THandlerFunction handler)
+{
+  return on(uri, HTTP_ANY, handler);
+}
+
+////////////////////////////////////////
+
+RequestHandler& WiFiWebServer::on(const String &uri, HTTPMethod method, WiFiWebServer::THandlerFunction fn)
 {
-  sendHeader("WWW-Authenticate", "Basic realm=\"Login Required\"");
-  send(401);
+#if WEBSERVER_SUPPORT_UPLOAD
+  return on(uri, method, fn, _fileUploadHandler);
+#else
+  return on(uri, method, fn, THandlerFunction());
+#endif
 }
 
 ////////////////////////////////////////
 
-void WiFiWebServer::on(const String &uri, WiFiWebServer::THandlerFunction handler)
+RequestHandler& WiFiWebServer::on(const String &uri, HTTPMethod method, WiFiWebServer::THandlerFunction fn,
+                       WiFiWebServer::THandlerFunction ufn)
 {
-  on(uri, HTTP_ANY, handler);
+  RequestHandler* handler = new FunctionRequestHandler(fn, ufn, uri, method);
+
+#if WIFI_WEBSERVER_METRICS
+  _metrics.addRoute(handler, uri.c_str(), method);
+#endif
+
+  _addRequestHandler(handler);
+
+  return *handler;
 }
 
 ////////////////////////////////////////
 
-void WiFiWebServer::on(const String &uri, HTTPMethod method, WiFiWebServer::THandlerFunction fn)
-{
-  on(uri, method, fn, _fileUploadHandler);
-}
+void WiFiWebServer::addHandler(RequestHandler* handler)
+{
+  _addRequestHandler(handler);
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_addRequestHandler(RequestHandler* handler)
+{
+  if (!_lastHandler)
+  {
+    _firstHandler = handler;
+    _lastHandler = handler;
+  }
+  else
+  {
+    _lastHandler->next(handler);
+    _lastHandler = handler;
+  }
+}
+
+////////////////////////////////////////
+
+#if USE_NEW_WEBSERVER_VERSION
+
+void WiFiWebServer::handleClient()
+{
+  _serviceDeferred();
+
+  if (_currentStatus == HC_NONE)
+  {
+    WiFiClient client = _server.available();
+
+    if (!client)
+    {
+      // Idle, print pending deferred log records
+      WS_LOG_FLUSH(WS_LOG_FLUSH_RECORDS);
+
+      if (_nullDelay)
+      {
+        delay(1);
+      }
+
+      return;
+    }
+
+    WS_LOGDEBUG(F("handleClient: New Client"));
+
+    _currentClient = client;
+    _currentStatus = HC_WAIT_READ;
+    _statusChange = millis();
+
+#if WIFI_WEBSERVER_METRICS
+    _metrics.accepted();
+    _metrics.clearRoute();
+    _parseStart = micros();
+#endif
+
+    WS_MEMORY_HOOK(memoryBegin);
+    WS_TRACE(ACCEPT, 0);
+  }
+
+  bool keepCurrentClient = false;
+  bool callYield = false;
+
+  if (_currentClient.connected() || _currentClient.available())
+  {
+    switch (_currentStatus)
+    {
+      case HC_NONE:
+        // No-op to avoid C++ compiler warning
+        break;
+
+      case HC_WAIT_READ:
+
+        // Wait for data from client to become available
+        if (_currentClient.available())
+        {
+          if (_parseRequest(_currentClient))
+          {
+#if WIFI_WEBSERVER_METRICS
+            _metrics.parseTime(micros() - _parseStart);
+#endif
+
+            keepCurrentClient = _handleParsedRequest();
+          }
+        }
+        else
+        {
+          // !_currentClient.available()
+          if (millis() - _statusChange <= HTTP_MAX_DATA_WAIT)
+          {
+            keepCurrentClient = true;
+          }
+          else
+          {
+#if WIFI_WEBSERVER_METRICS
+            _metrics.timeout(WiFiServerMetrics::TIMEOUT_DATA_WAIT);
+#endif
+
+            WS_TRACE(TIMEOUT, HTTP_MAX_DATA_WAIT);
+          }
+
+          callYield = true;
+        }
+
+        break;
+
+      case HC_WAIT_CLOSE:
+
+        // Wait for client to close the connection
+        if (millis() - _statusChange <= HTTP_MAX_CLOSE_WAIT)
+        {
+          keepCurrentClient = true;
+          callYield = true;
+        }
+        else
+        {
+#if WIFI_WEBSERVER_METRICS
+          _metrics.timeout(WiFiServerMetrics::TIMEOUT_CLOSE_WAIT);
+#endif
+
+          WS_TRACE(TIMEOUT, HTTP_MAX_CLOSE_WAIT);
+        }
+    }
+  }
+
+  if (!keepCurrentClient)
+  {
+    WS_LOGDEBUG(F("handleClient: Don't keepCurrentClient"));
+    WS_TRACE(CLOSE, 0);
+    _currentClient = WiFiClient();
+    _currentStatus = HC_NONE;
+    // KH
+    //_currentUpload.reset();
+  }
+
+  if (callYield)
+  {
+    yield();
+  }
+
+#if (USE_WIFI_NINA || WIFI_USE_PORTENTA_H7)
+  // KH, fix bug relating to New NINA FW 1.4.0. Have to close the connection
+  _currentClient.stop();
+  WS_LOGDEBUG(F("handleClient: Client disconnected"));
+#endif
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::handleClient(uint32_t budget_us)
+{
+  unsigned long start = micros();
+
+  _serviceDeferred();
+
+  if (_currentStatus == HC_NONE)
+  {
+    WiFiClient client = _server.available();
+
+    if (!client)
+    {
+      // Idle, print pending deferred log records
+      WS_LOG_FLUSH(WS_LOG_FLUSH_RECORDS);
+
+      return;
+    }
+
+    WS_LOGDEBUG(F("handleClient: New Client"));
+
+    _currentClient  = client;
+    _currentStatus  = HC_WAIT_READ;
+    _statusChange   = millis();
+    _parseStage     = PARSE_REQUEST_LINE;
+    _parseLine      = "";
+
+#if WIFI_WEBSERVER_METRICS
+    _metrics.accepted();
+    _metrics.clearRoute();
+    _parseStart = micros();
+#endif
+
+    WS_MEMORY_HOOK(memoryBegin);
+    WS_TRACE(ACCEPT, 0);
+  }
+
+  bool keepCurrentClient  = false;
+  bool requestPending     = false;
+
+  if (_currentClient.connected() || _currentClient.available())
+  {
+    switch (_currentStatus)
+    {
+      case HC_NONE:
+        // No-op to avoid C++ compiler warning
+        break;
+
+      case HC_WAIT_READ:
+      {
+        int result = _parseRequestStep(_currentClient, start, budget_us);
+
+        if (result > 0)
+        {
+#if WIFI_WEBSERVER_METRICS
+          _metrics.parseTime(micros() - _parseStart);
+#endif
+
+          keepCurrentClient = _handleParsedRequest();
+        }
+        else if (result == 0)
+        {
+          // _statusChange is moved on by every received byte
+          unsigned long maxWait = (_parseStage == PARSE_BODY) ? HTTP_MAX_POST_WAIT : HTTP_MAX_DATA_WAIT;
+
+          if (millis() - _statusChange <= maxWait)
+          {
+            keepCurrentClient = true;
+            requestPending    = true;
+          }
+          else
+          {
+#if WIFI_WEBSERVER_METRICS
+            _metrics.timeout(WiFiServerMetrics::TIMEOUT_DATA_WAIT);
+#endif
+
+            WS_TRACE(TIMEOUT, HTTP_MAX_DATA_WAIT);
+          }
+        }
+
+        break;
+      }
+
+      case HC_WAIT_CLOSE:
+
+        // Wait for client to close the connection
+        if (millis() - _statusChange <= HTTP_MAX_CLOSE_WAIT)
+        {
+          keepCurrentClient = true;
+        }
+        else
+        {
+#if WIFI_WEBSERVER_METRICS
+          _metrics.timeout(WiFiServerMetrics::TIMEOUT_CLOSE_WAIT);
+#endif
+
+          WS_TRACE(TIMEOUT, HTTP_MAX_CLOSE_WAIT);
+        }
+    }
+  }
+
+  if (!keepCurrentClient)
+  {
+    WS_LOGDEBUG(F("handleClient: Don't keepCurrentClient"));
+    WS_TRACE(CLOSE, 0);
+    _currentClient  = WiFiClient();
+    _currentStatus  = HC_NONE;
+    _parseLine      = String();
+    _plainBuf       = String();
+
+#if WEBSERVER_SUPPORT_MULTIPART
+    // A form cut short still tells the upload handler, and gives back the buffer
+    _abortFormBody();
+#endif
+  }
+
+#if USE_WIFI_NINA
+  // Same as handleClient(), but not while the request is still being read
+  if (!requestPending)
+  {
+    _currentClient.stop();
+    WS_LOGDEBUG(F("handleClient: Client disconnected"));
+  }
+#else
+  (void) requestPending;
+#endif
+}
+
+////////////////////////////////////////
+
+bool WiFiWebServer::_handleParsedRequest()
+{
+  _currentClient.setTimeout(HTTP_MAX_SEND_WAIT);
+  _contentLength = CONTENT_LENGTH_NOT_SET;
+  _handleRequest();
+
+  if (_deferSlot >= 0)
+  {
+    // The handler called deferResponse(), the slot now owns the connection and the request
+    _parkRequest(_deferSlot);
+    _deferSlot = -1;
+
+    return false;
+  }
+
+#if USE_WIFI_NINA || ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_SAMD_NANO_33_IOT) )
+
+  // Fix for issue with Chrome based browsers: https://github.com/espressif/arduino-esp32/issues/3652
+  // Remove this will hang boards using WiFNINA, such as
+  // Nano_RP2040_Connect with arduino_pico core, Nano_33_IoT
+  if (_currentClient.connected())
+  {
+    _currentStatus = HC_WAIT_CLOSE;
+    _statusChange = millis();
+
+    return true;
+  }
+
+#endif
+
+  return false;
+}
+
+////////////////////////////////////////
+
+int WiFiWebServer::deferResponse(THandlerFunction onResume, uint32_t timeout_ms)
+{
+  // Only from inside a handler, once per request, and not from onResume
+  if ( (_currentStatus != HC_WAIT_READ) || (_deferSlot >= 0) || _resuming )
+  {
+    return -1;
+  }
+
+  for (int i = 0; i < WEBSERVER_MAX_DEFERRED; i++)
+  {
+    DeferredResponse& deferred = _deferred[i];
+
+    if (!deferred.inUse)
+    {
+      deferred.onResume = onResume;
+      deferred.start    = millis();
+      deferred.timeout  = timeout_ms;
+      deferred.version  = _currentVersion;
+      deferred.sequence++;
+      deferred.ready    = false;
+      deferred.inUse    = true;
+
+      _deferSlot = i;
+
+#if WIFI_WEBSERVER_METRICS
+      deferred.route = _metricsRoute;
+
+      uint8_t inUse = 0;
+
+      for (int j = 0; j < WEBSERVER_MAX_DEFERRED; j++)
+      {
+        if (_deferred[j].inUse)
+          inUse++;
+      }
+
+      _metrics.deferred(inUse);
+#endif
+
+      WS_LOGDEBUG1(F("deferResponse: slot = "), i);
+      WS_TRACE(DEFER, (deferred.sequence << 8) | i);
+
+      return (deferred.sequence << 8) | i;
+    }
+  }
+
+  WS_LOGDEBUG(F("deferResponse: No free slot"));
+
+  return -1;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::resume(int handle)
+{
+  if (handle < 0)
+    return;
+
+  int slot = handle & 0xFF;
+
+  if ( (slot < WEBSERVER_MAX_DEFERRED) && _deferred[slot].inUse && (_deferred[slot].sequence == ((handle >> 8) & 0xFF)) )
+  {
+    _deferred[slot].ready = true;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_parkRequest(int slot)
+{
+  DeferredResponse& deferred = _deferred[slot];
+
+  deferred.client   = _currentClient;
+  deferred.method   = _currentMethod;
+  deferred.uri      = _currentUri;
+  deferred.handler  = _currentHandler;
+
+  // The args move to the slot, the next request allocates its own
+  deferred.argCount = _currentArgCount;
+  deferred.args     = _currentArgs;
+  _currentArgCount  = 0;
+  _currentArgs      = nullptr;
+
+#if WEBSERVER_SUPPORT_HEADERS
+  // The header keys stay with the server, the slot keeps a copy of the values
+  if (_headerKeysCount > 0)
+  {
+    deferred.headerCount  = _headerKeysCount;
+    deferred.headers      = new RequestArgument[_headerKeysCount];
+
+    for (int i = 0; i < _headerKeysCount; i++)
+    {
+      deferred.headers[i] = _currentHeaders[i];
+    }
+  }
+#endif
+
+  _currentClient = WiFiClient();
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_releaseDeferred(int slot)
+{
+  DeferredResponse& deferred = _deferred[slot];
+
+  if (deferred.args)
+    delete[] deferred.args;
+
+  deferred.args     = nullptr;
+  deferred.argCount = 0;
+
+#if WEBSERVER_SUPPORT_HEADERS
+  if (deferred.headers)
+    delete[] deferred.headers;
+
+  deferred.headers      = nullptr;
+  deferred.headerCount  = 0;
+#endif
+
+  deferred.uri      = String();
+  deferred.handler  = nullptr;
+  deferred.client   = WiFiClient();
+  deferred.onResume = THandlerFunction();
+  deferred.inUse    = false;
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::_serviceDeferred()
+{
+  for (int i = 0; i < WEBSERVER_MAX_DEFERRED; i++)
+  {
+    DeferredResponse& deferred = _deferred[i];
+
+    if (!deferred.inUse)
+      continue;
+
+    bool connected = deferred.client.connected();
+
+    if ( connected && !deferred.ready && (millis() - deferred.start <= deferred.timeout) )
+      continue;
+
+    if (connected)
+    {
+      // Answer on the parked connection with the parked request, then give the current request its context back
+      WiFiClient        client          = _currentClient;
+      uint8_t           version         = _currentVersion;
+      size_t            contentLength   = _contentLength;
+      bool              chunked         = _chunked;
+      String            responseHeaders = _responseHeaders;
+      HTTPMethod        method          = _currentMethod;
+      String            uri             = _currentUri;
+      RequestHandler*   handler         = _currentHandler;
+      int               argCount        = _currentArgCount;
+      RequestArgument*  args            = _currentArgs;
+
+      _currentClient    = deferred.client;
+      _currentVersion   = deferred.version;
+      _contentLength    = CONTENT_LENGTH_NOT_SET;
+      _chunked          = false;
+      _responseHeaders  = String();
+      _currentMethod    = deferred.method;
+      _currentUri       = deferred.uri;
+      _currentHandler   = deferred.handler;
+      _currentArgCount  = deferred.argCount;
+      _currentArgs      = deferred.args;
+
+#if WEBSERVER_SUPPORT_HEADERS
+      int               headerCount     = _headerKeysCount;
+      RequestArgument*  headers         = _currentHeaders;
+
+      if (deferred.headers)
+      {
+        _headerKeysCount  = deferred.headerCount;
+        _currentHeaders   = deferred.headers;
+      }
+#endif
+
+#if WIFI_WEBSERVER_METRICS
+      _metrics.selectRoute(deferred.route);
+#endif
+
+      if (deferred.ready)
+      {
+        WS_LOGDEBUG1(F("_serviceDeferred: resume slot = "), i);
+        WS_TRACE(RESUME, i);
+
+        _resuming = true;
+        deferred.onResume();
+        _resuming = false;
+      }
+      else
+      {
+#if (ESP32 || ESP8266)
+        using namespace mime_esp;
+#else
+        using namespace mime;
+#endif
+
+        WS_LOGDEBUG1(F("_serviceDeferred: timeout slot = "), i);
+
+#if WIFI_WEBSERVER_METRICS
+        _metrics.timeout(WiFiServerMetrics::TIMEOUT_DEFERRED);
+#endif
+
+        WS_TRACE(TIMEOUT, deferred.timeout);
 
-////////////////////////////////////////
+        send(504, mimeTable[html].mimeType, String("Gateway Time-out"));
+      }
 
-void WiFiWebServer::on(const String &uri, HTTPMethod method, WiFiWebServer::THandlerFunction fn,
-                       WiFiWebServer::THandlerFunction ufn)
-{
-  _addRequestHandler(new FunctionRequestHandler(fn, ufn, uri, method));
-}
+      _finalizeResponse();
+      _currentClient.stop();
+
+      WS_TRACE(CLOSE, 0);
+
+      _currentClient    = client;
+      _currentVersion   = version;
+      _contentLength    = contentLength;
+      _chunked          = chunked;
+      _responseHeaders  = responseHeaders;
+      _currentMethod    = method;
+      _currentUri       = uri;
+      _currentHandler   = handler;
+      _currentArgCount  = argCount;
+      _currentArgs      = args;
+
+#if WEBSERVER_SUPPORT_HEADERS
+      _headerKeysCount  = headerCount;
+      _currentHeaders   = headers;
+#endif
 
-////////////////////////////////////////
+#if WIFI_WEBSERVER_METRICS
+      _metrics.selectRoute(_metricsRoute);
+#endif
+    }
 
-void WiFiWebServer::addHandler(RequestHandler* handler)
-{
-  _addRequestHandler(handler);
+    _releaseDeferred(i);
+  }
 }
 
 ////////////////////////////////////////
 
-void WiFiWebServer::_addRequestHandler(RequestHandler* handler)
+#if WIFI_WEBSERVER_METRICS
+
+void WiFiWebServer::enableMetrics(const char* uri)
 {
-  if (!_lastHandler)
-  {
-    _firstHandler = handler;
-    _lastHandler = handler;
-  }
-  else
+  on(uri, HTTP_GET, [this]()
   {
-    _lastHandler->next(handler);
-    _lastHandler = handler;
-  }
+    _sendMetrics();
+  });
 }
 
 ////////////////////////////////////////
 
-#if USE_NEW_WEBSERVER_VERSION
-
-void WiFiWebServer::handleClient()
+void WiFiWebServer::_sendMetrics()
 {
-  if (_currentStatus == HC_NONE)
-  {
-    WiFiClient client = _server.available();
+  // The request being served, plus parked ones whose client hasn't gone. A parked request
+  // keeps its slot until resumed or timed out, even once its client has disconnected
+  uint8_t connectionsActive = (_currentStatus != HC_NONE) ? 1 : 0;
+  uint8_t deferredActive    = 0;
 
-    if (!client)
+  for (int i = 0; i < WEBSERVER_MAX_DEFERRED; i++)
+  {
+    if (_deferred[i].inUse)
     {
-      if (_nullDelay)
-      {
-        delay(1);
-      }
+      deferredActive++;
 
-      return;
+      if (_deferred[i].client.connected())
+        connectionsActive++;
     }
-
-    WS_LOGDEBUG(F("handleClient: New Client"));
-
-    _currentClient = client;
-    _currentStatus = HC_WAIT_READ;
-    _statusChange = millis();
   }
 
-  bool keepCurrentClient = false;
-  bool callYield = false;
-
-  if (_currentClient.connected() || _currentClient.available())
-  {
-    switch (_currentStatus)
-    {
-      case HC_NONE:
-        // No-op to avoid C++ compiler warning
-        break;
-
-      case HC_WAIT_READ:
-
-        // Wait for data from client to become available
-        if (_currentClient.available())
-        {
-          if (_parseRequest(_currentClient))
-          {
-            _currentClient.setTimeout(HTTP_MAX_SEND_WAIT);
-            _contentLength = CONTENT_LENGTH_NOT_SET;
-            _handleRequest();
-
-#if USE_WIFI_NINA || ( defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_SAMD_NANO_33_IOT) )
+  WiFiResponseStream out(*this, 200, "text/plain; version=0.0.4");
 
-            // Fix for issue with Chrome based browsers: https://github.com/espressif/arduino-esp32/issues/3652
-            // Remove this will hang boards using WiFNINA, such as
-            // Nano_RP2040_Connect with arduino_pico core, Nano_33_IoT
-            if (_currentClient.connected())
-            {
-              _currentStatus = HC_WAIT_CLOSE;
-              _statusChange = millis();
-              keepCurrentClient = true;
-            }
+  _metrics.render(out, connectionsActive, deferredActive);
+}
 
 #endif
-          }
-        }
-        else
-        {
-          // !_currentClient.available()
-          if (millis() - _statusChange <= HTTP_MAX_DATA_WAIT)
-          {
-            keepCurrentClient = true;
-          }
-
-          callYield = true;
-        }
-
-        break;
 
-      case HC_WAIT_CLOSE:
+////////////////////////////////////////
 
-        // Wait for client to close the connection
-        if (millis() - _statusChange <= HTTP_MAX_CLOSE_WAIT)
-        {
-          keepCurrentClient = true;
-          callYield = true;
-        }
-    }
-  }
+#if WIFI_WEBSERVER_TRACE
 
-  if (!keepCurrentClient)
+void WiFiWebServer::enableTrace(const char* uri)
+{
+  on(uri, HTTP_GET, [this]()
   {
-    WS_LOGDEBUG(F("handleClient: Don't keepCurrentClient"));
-    _currentClient = WiFiClient();
-    _currentStatus = HC_NONE;
-    // KH
-    //_currentUpload.reset();
-  }
+    WiFiResponseStream out(*this, 200, "text/plain");
 
-  if (callYield)
-  {
-    yield();
-  }
+    _trace.dump(out);
+  });
+}
 
-#if (USE_WIFI_NINA || WIFI_USE_PORTENTA_H7)
-  // KH, fix bug relating to New NINA FW 1.4.0. Have to close the connection
-  _currentClient.stop();
-  WS_LOGDEBUG(F("handleClient: Client disconnected"));
 #endif
-}
 
 ////////////////////////////////////////
 
@@ -469,6 +1459,9 @@ void WiFiWebServer::handleClient()
 
     if (!client)
     {
+      // Idle, print pending deferred log records
+      WS_LOG_FLUSH(WS_LOG_FLUSH_RECORDS);
+
       return;
     }
 
@@ -562,6 +1555,18 @@ stopClient:
 #endif
 }
 
+////////////////////////////////////////
+
+// Portenta_H7 handleClient() has no delay() and already returns while waiting for data
+void WiFiWebServer::handleClient(uint32_t budget_us)
+{
+  (void) budget_us;
+
+  handleClient();
+}
+
+////////////////////////////////////////
+
 #endif    // #if USE_NEW_WEBSERVER_VERSION
 
 ////////////////////////////////////////
@@ -574,8 +1579,10 @@ void WiFiWebServer::close()
 
   _currentStatus = HC_NONE;
 
+#if WEBSERVER_SUPPORT_HEADERS
   if (!_headerKeysCount)
     collectHeaders(0, 0);
+#endif
 }
 
 ////////////////////////////////////////
@@ -624,6 +1631,10 @@ void WiFiWebServer::_prepareHeader(String& response, int code, const char* conte
   aResponse += fromString(_responseCodeToString(code));
   aResponse += RETURN_NEWLINE;
 
+#if WIFI_WEBSERVER_METRICS
+  _metrics.status(code);
+#endif
+
 #if (ESP32 || ESP8266)
   using namespace mime_esp;
 #else
@@ -652,12 +1663,14 @@ void WiFiWebServer::_prepareHeader(String& response, int code, const char* conte
     sendHeader("Transfer-Encoding", "chunked");
   }
 
+#if WEBSERVER_SUPPORT_CORS
   if (_corsEnabled)
   {
     sendHeader("Access-Control-Allow-Origin",  "*");
     sendHeader("Access-Control-Allow-Methods", "*");
     sendHeader("Access-Control-Allow-Headers", "*");
   }
+#endif
 
   WS_LOGDEBUG(F("_prepareHeader sendHeader Conn close"));
 
@@ -681,6 +1694,10 @@ void WiFiWebServer::_prepareHeader(WWString& response, int code, const char* con
   response += fromString(_responseCodeToString(code));
   response += RETURN_NEWLINE;
 
+#if WIFI_WEBSERVER_METRICS
+  _metrics.status(code);
+#endif
+
 #if (ESP32 || ESP8266)
   using namespace mime_esp;
 #else
@@ -721,12 +1738,14 @@ void WiFiWebServer::_prepareHeader(WWString& response, int code, const char* con
     sendHeader("Transfer-Encoding", "chunked");
   }
 
+#if WEBSERVER_SUPPORT_CORS
   if (_corsEnabled)
   {
     sendHeader("Access-Control-Allow-Origin",  "*");
     sendHeader("Access-Control-Allow-Methods", "*");
     sendHeader("Access-Control-Allow-Headers", "*");
   }
+#endif
 
   WS_LOGDEBUG(F("_prepareHeader sendHeader Conn close"));
 
@@ -746,7 +1765,7 @@ void WiFiWebServer::send(int code, const char* content_type, const String& conte
 
   _prepareHeader(header, code, content_type, content.length());
 
-  _currentClient.write((const uint8_t *)header.c_str(), header.length());
+  _currentClientWrite(header.c_str(), header.length());
 
   if (content.length())
   {
@@ -765,7 +1784,7 @@ void WiFiWebServer::send(int code, char* content_type, const String& content, si
   memccpy((void*)type, content_type, 0, sizeof(type));
   _prepareHeader(header, code, (const char* )type, contentLength);
 
-  _currentClient.write((const uint8_t *) header.c_str(), header.length());
+  _currentClientWrite(header.c_str(), header.length());
 
   if (contentLength)
   {
@@ -804,7 +1823,7 @@ void WiFiWebServer::send(int code, const char* content_type, const char* content
 
   _prepareHeader(header, code, content_type, contentLength);
 
-  _currentClient.write((const uint8_t *) header.c_str(), header.length());
+  _currentClientWrite(header.c_str(), header.length());
 
   if (contentLength)
   {
@@ -825,14 +1844,14 @@ void WiFiWebServer::sendContent(const char* content, size_t contentLength)
     WS_LOGDEBUG1(F("sendContent_char: _chunked, _currentVersion ="), _currentVersion);
 
     sprintf(chunkSize, "%x%s", contentLength, footer);
-    _currentClient.write(chunkSize, strlen(chunkSize));
+    _currentClientWrite(chunkSize, strlen(chunkSize));
   }
 
-  _currentClient.write(content, contentLength);
+  _currentClientWrite(content, contentLength);
 
   if (_chunked)
   {
-    _currentClient.write(footer, 2);
+    _currentClientWrite(footer, 2);
 
     if (contentLength == 0)
     {
@@ -858,6 +1877,8 @@ void WiFiWebServer::sendContent(const String& content, size_t contentLength)
 ////////////////////////////////////////
 
 // KH, Restore PROGMEM commands
+#if WEBSERVER_SUPPORT_PROGMEM
+
 void WiFiWebServer::send_P(int code, PGM_P content_type, PGM_P content)
 {
   size_t contentLength = 0;
@@ -880,7 +1901,7 @@ void WiFiWebServer::send_P(int code, PGM_P content_type, PGM_P content)
   WS_LOGDEBUG1(F("header = "), header);
 #endif
 
-  _currentClient.write((const uint8_t *) header.c_str(), header.length());
+  _currentClientWrite(header.c_str(), header.length());
 
   if (contentLength)
   {
@@ -906,7 +1927,7 @@ void WiFiWebServer::send_P(int code, PGM_P content_type, PGM_P content, size_t c
   WS_LOGDEBUG1(F("header = "), fromWWString(header));
 #endif
 
-  _currentClient.write((const uint8_t *) header.c_str(), header.length());
+  _currentClientWrite(header.c_str(), header.length());
 
   if (contentLength)
   {
@@ -916,6 +1937,87 @@ void WiFiWebServer::send_P(int code, PGM_P content_type, PGM_P content, size_t c
 
 ////////////////////////////////////////
 
+void WiFiWebServer::send_P_template(int code, PGM_P content_type, PGM_P tmpl, TTemplateResolver resolver)
+{
+  char type[64];
+
+  memccpy_P((void*)type, (PGM_VOID_P)content_type, 0, sizeof(type));
+
+  WiFiResponseStream out(*this, code, type);
+
+  if (!tmpl)
+    return;
+
+  char    block[WS_TEMPLATE_BLOCK_SZ];
+  char    name[WS_TEMPLATE_MAX_NAME_LEN + 1];
+  int     nameLen = -1;     // -1 when not inside a placeholder
+  size_t  len     = strlen_P(tmpl);
+
+  for (size_t pos = 0; pos < len; )
+  {
+    size_t n = (len - pos < sizeof(block)) ? (len - pos) : sizeof(block);
+
+    memcpy_P(block, &tmpl[pos], n);
+    pos += n;
+
+    // Start of the literal span not yet sent
+    size_t start = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+      char c = block[i];
+
+      if (nameLen < 0)
+      {
+        if (c == '%')
+        {
+          out.write((const uint8_t*) &block[start], i - start);
+          nameLen = 0;
+        }
+      }
+      else if (c == '%')
+      {
+        if (nameLen == 0)
+        {
+          out.write('%');
+        }
+        else if (resolver)
+        {
+          name[nameLen] = 0;
+          resolver(name, out);
+        }
+
+        nameLen = -1;
+        start   = i + 1;
+      }
+      else if ( (isAlphaNumeric(c) || (c == '_')) && (nameLen < WS_TEMPLATE_MAX_NAME_LEN) )
+      {
+        name[nameLen++] = c;
+      }
+      else
+      {
+        // Not a placeholder, e.g. "width:100%;". Send it as is and continue from this char
+        out.write('%');
+        out.write((const uint8_t*) name, nameLen);
+        nameLen = -1;
+        start   = i;
+      }
+    }
+
+    if (nameLen < 0)
+      out.write((const uint8_t*) &block[start], n - start);
+  }
+
+  // Unterminated placeholder at the end
+  if (nameLen >= 0)
+  {
+    out.write('%');
+    out.write((const uint8_t*) name, nameLen);
+  }
+}
+
+////////////////////////////////////////
+
 void WiFiWebServer::sendContent_P(PGM_P content)
 {
   sendContent_P(content, strlen_P(content));
@@ -934,7 +2036,7 @@ void WiFiWebServer::sendContent_P(PGM_P content, size_t contentLength)
     WS_LOGDEBUG1(F("sendContent_P: _chunked, _currentVersion ="), _currentVersion);
 
     sprintf(chunkSize, "%x%s", contentLength, footer);
-    _currentClient.write(chunkSize, strlen(chunkSize));
+    _currentClientWrite(chunkSize, strlen(chunkSize));
   }
 
   uint8_t* _sendContentBuffer = new uint8_t[SENDCONTENT_P_BUFFER_SZ];
@@ -949,11 +2051,11 @@ void WiFiWebServer::sendContent_P(PGM_P content, size_t contentLength)
     {
       /* code */
       memcpy_P(_sendContentBuffer, &content[i * SENDCONTENT_P_BUFFER_SZ], SENDCONTENT_P_BUFFER_SZ);
-      _currentClient.write(_sendContentBuffer, SENDCONTENT_P_BUFFER_SZ);
+      _currentClientWrite((const char*) _sendContentBuffer, SENDCONTENT_P_BUFFER_SZ);
     }
 
     memcpy_P(_sendContentBuffer, &content[i * SENDCONTENT_P_BUFFER_SZ], remainder);
-    _currentClient.write(_sendContentBuffer, remainder);
+    _currentClientWrite((const char*) _sendContentBuffer, remainder);
 
     delete [] _sendContentBuffer;
   }
@@ -966,7 +2068,7 @@ void WiFiWebServer::sendContent_P(PGM_P content, size_t contentLength)
 
   if (_chunked)
   {
-    _currentClient.write(footer, 2);
+    _currentClientWrite(footer, 2);
 
     _chunked = false;
   }
@@ -974,6 +2076,97 @@ void WiFiWebServer::sendContent_P(PGM_P content, size_t contentLength)
 
 ////////////////////////////////////////
 
+#endif    // #if WEBSERVER_SUPPORT_PROGMEM
+
+////////////////////////////////////////
+
+WiFiResponseStream::WiFiResponseStream(WiFiWebServer& server, int code, const char* content_type)
+  : _server(server)
+  , _len(0)
+  , _ended(false)
+{
+  _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  _server.send(code, content_type, (const char*) nullptr, 0);
+}
+
+////////////////////////////////////////
+
+WiFiResponseStream::~WiFiResponseStream()
+{
+  end();
+}
+
+////////////////////////////////////////
+
+size_t WiFiResponseStream::write(uint8_t c)
+{
+  if (_ended)
+    return 0;
+
+  if (_len == sizeof(_buffer))
+    flush();
+
+  _buffer[_len++] = c;
+
+  return 1;
+}
+
+////////////////////////////////////////
+
+size_t WiFiResponseStream::write(const uint8_t* buffer, size_t size)
+{
+  if (_ended)
+    return 0;
+
+  size_t written = size;
+
+  while (size)
+  {
+    if (_len == sizeof(_buffer))
+      flush();
+
+    size_t room = sizeof(_buffer) - _len;
+
+    if (room > size)
+      room = size;
+
+    memcpy(&_buffer[_len], buffer, room);
+    _len    += room;
+    buffer  += room;
+    size    -= room;
+  }
+
+  return written;
+}
+
+////////////////////////////////////////
+
+void WiFiResponseStream::flush()
+{
+  // A zero-length chunk would end the body
+  if (_len)
+  {
+    _server.sendContent(_buffer, _len);
+    _len = 0;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiResponseStream::end()
+{
+  if (_ended)
+    return;
+
+  flush();
+
+  // Zero-length last chunk, writes nothing if the response is not chunked
+  _server.sendContent("", 0);
+  _ended = true;
+}
+
+////////////////////////////////////////
+
 #if (ESP32 || ESP8266)
 
 #include "FS.h"
@@ -982,7 +2175,13 @@ void WiFiWebServer::sendContent_P(PGM_P content, size_t contentLength)
 
 void WiFiWebServer::serveStatic(const char* uri, FS& fs, const char* path, const char* cache_header)
 {
-  _addRequestHandler(new StaticFileRequestHandler(fs, path, uri, cache_header));
+  RequestHandler* handler = new StaticFileRequestHandler(fs, path, uri, cache_header);
+
+#if WIFI_WEBSERVER_METRICS
+  _metrics.addRoute(handler, uri, HTTP_GET);
+#endif
+
+  _addRequestHandler(handler);
 }
 
 ////////////////////////////////////////
@@ -1065,6 +2264,8 @@ bool WiFiWebServer::hasArg(const String& name)
 
 ////////////////////////////////////////
 
+#if WEBSERVER_SUPPORT_HEADERS
+
 String WiFiWebServer::header(const String& name)
 {
   for (int i = 0; i < _headerKeysCount; ++i)
@@ -1136,6 +2337,10 @@ bool WiFiWebServer::hasHeader(const String& name)
 
 ////////////////////////////////////////
 
+#endif    // #if WEBSERVER_SUPPORT_HEADERS
+
+////////////////////////////////////////
+
 String WiFiWebServer::hostHeader()
 {
   return _hostHeader;
@@ -1143,6 +2348,8 @@ String WiFiWebServer::hostHeader()
 
 ////////////////////////////////////////
 
+#if WEBSERVER_SUPPORT_UPLOAD
+
 void WiFiWebServer::onFileUpload(THandlerFunction fn)
 {
   _fileUploadHandler = fn;
@@ -1150,6 +2357,36 @@ void WiFiWebServer::onFileUpload(THandlerFunction fn)
 
 ////////////////////////////////////////
 
+#endif    // #if WEBSERVER_SUPPORT_UPLOAD
+
+////////////////////////////////////////
+
+#if USE_NEW_WEBSERVER_VERSION
+
+void WiFiWebServer::enableJsonArgs(bool value)
+{
+  if (value && !_jsonTokenizer)
+  {
+    _jsonTokenizer = new WiFiJsonTokenizer(_jsonValueCallback, this);
+  }
+  else if (!value && _jsonTokenizer)
+  {
+    delete _jsonTokenizer;
+    _jsonTokenizer = nullptr;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiWebServer::onJsonArrayElement(TJsonElementFunction fn)
+{
+  _jsonElementHandler = fn;
+}
+
+#endif
+
+////////////////////////////////////////
+
 void WiFiWebServer::onNotFound(THandlerFunction fn)
 {
   _notFoundHandler = fn;
@@ -1161,6 +2398,19 @@ void WiFiWebServer::_handleRequest()
 {
   bool handled = false;
 
+#if WIFI_WEBSERVER_METRICS
+  _metricsRoute = _metrics.beginRoute(_currentHandler, _requestBytesIn);
+#endif
+
+  // Request parsed
+  WS_MEMORY_HOOK(memorySample);
+
+#if (WIFI_WEBSERVER_METRICS || WIFI_WEBSERVER_TRACE)
+  unsigned long handlerStart = micros();
+#endif
+
+  WS_TRACE(HANDLER_START, _currentHandler ? 1 : 0);
+
   if (!_currentHandler)
   {
     WS_LOGDEBUG(F("_handleRequest: request handler not found"));
@@ -1203,6 +2453,9 @@ void WiFiWebServer::_handleRequest()
     handled = true;
   }
 
+  // Handler done
+  WS_MEMORY_HOOK(memorySample);
+
   if (handled)
   {
     WS_LOGDEBUG(F("_handleRequest: _finalizeResponse"));
@@ -1210,6 +2463,14 @@ void WiFiWebServer::_handleRequest()
     _finalizeResponse();
   }
 
+  WS_MEMORY_HOOK(memoryEnd);
+
+#if WIFI_WEBSERVER_METRICS
+  _metrics.endHandler(micros() - handlerStart);
+#endif
+
+  WS_TRACE(HANDLER_END, micros() - handlerStart);
+
 #if WIFI_USE_PORTENTA_H7
   WS_LOGDEBUG(F("_handleRequest: Clear _currentUri"));
   //_currentUri = String();
@@ -1337,6 +2598,9 @@ String WiFiWebServer::_responseCodeToString(int code)
     case 417:
       return F("Expectation Failed");
 
+    case 431:
+      return F("Request Header Fields Too Large");
+
     case 500:
       return F("Internal Server Error");
 
@@ -0,0 +1,41 @@
+/****************************************************************************************************************************
+  WiFiWebServer.cpp - Server implementation compiled once, with WIFI_WEBSERVER_SEPARATE_IMPL
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+// Built only when the compiler flag WIFI_WEBSERVER_SEPARATE_IMPL=true is set, and then WiFiWebServer.h
+// declares the server without pulling in its implementation. Every other define the server reads
+// (board, WiFi library, _WIFI_LOGLEVEL_, WEBSERVER_*, WIFI_WEBSERVER_*) must be a compiler flag too,
+// as this file doesn't see the sketch
+#if WIFI_WEBSERVER_SEPARATE_IMPL
+
+  // A custom WiFi library is included by the sketch before the server, so name its header here,
+  // e.g. -DWIFI_WEBSERVER_CUSTOM_WIFI_H="<WiFiEspAT.h>"
+  #if (USE_WIFI_CUSTOM && !USE_WIFI_NINA)
+    #if defined(WIFI_WEBSERVER_CUSTOM_WIFI_H)
+      #include WIFI_WEBSERVER_CUSTOM_WIFI_H
+    #else
+      #error USE_WIFI_CUSTOM with WIFI_WEBSERVER_SEPARATE_IMPL needs WIFI_WEBSERVER_CUSTOM_WIFI_H
+    #endif
+  #endif
+
+  #include "WiFiWebServer.hpp"
+  #include "WiFiWebServer-impl.h"
+  #include "Parsing-impl.h"
+
+#endif    // #if WIFI_WEBSERVER_SEPARATE_IMPL
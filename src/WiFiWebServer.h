@@ -49,9 +49,18 @@
   #define WIFI_WEBSERVER_VERSION_INT      1010001
 #endif
 
+// With the compiler flag WIFI_WEBSERVER_SEPARATE_IMPL=true the implementation is built once in
+// WiFiWebServer.cpp, and this header may be included from as many files as needed
+#ifndef WIFI_WEBSERVER_SEPARATE_IMPL
+  #define WIFI_WEBSERVER_SEPARATE_IMPL      false
+#endif
+
 #include "WiFiWebServer.hpp"
-#include "WiFiWebServer-impl.h"
-#include "Parsing-impl.h"
+
+#if !WIFI_WEBSERVER_SEPARATE_IMPL
+  #include "WiFiWebServer-impl.h"
+  #include "Parsing-impl.h"
+#endif
 
 
 #endif    // WiFiWebServer_H
@@ -259,8 +259,57 @@
 
 ////////////////////////////////////////
 
+#include "utility/WiFiFeatures.h"
 #include "utility/mimetable.h"
 #include "utility/RingBuffer.h"
+#include "utility/JsonTokenizer.h"
+#include "utility/JsonWriter.h"
+#include "utility/Base64Codec.h"
+#include "utility/DigestHash.h"
+#include "utility/UploadBufferPool.h"
+
+// Opt-in request counters and latency histograms, see enableMetrics()
+#ifndef WIFI_WEBSERVER_METRICS
+  #define WIFI_WEBSERVER_METRICS      false
+#elif (WIFI_WEBSERVER_METRICS && !USE_NEW_WEBSERVER_VERSION)
+  #undef WIFI_WEBSERVER_METRICS
+  #define WIFI_WEBSERVER_METRICS      false
+  
+  #warning WIFI_WEBSERVER_METRICS not supported on Portenta_H7
+#endif
+
+#if WIFI_WEBSERVER_METRICS
+  #include "utility/ServerMetrics.h"
+#endif
+
+// Set true to add heap / stack probes around each request to the metrics
+#ifndef WS_METRICS_MEMORY
+  #define WS_METRICS_MEMORY           false
+#endif
+
+#if (WIFI_WEBSERVER_METRICS && WS_METRICS_MEMORY)
+  #define WS_MEMORY_HOOK(hook)        _metrics.hook()
+#else
+  #define WS_MEMORY_HOOK(hook)
+#endif
+
+// Opt-in stage tracing into a RAM ring, see enableTrace()
+#ifndef WIFI_WEBSERVER_TRACE
+  #define WIFI_WEBSERVER_TRACE        false
+#elif (WIFI_WEBSERVER_TRACE && !USE_NEW_WEBSERVER_VERSION)
+  #undef WIFI_WEBSERVER_TRACE
+  #define WIFI_WEBSERVER_TRACE        false
+  
+  #warning WIFI_WEBSERVER_TRACE not supported on Portenta_H7
+#endif
+
+#if WIFI_WEBSERVER_TRACE
+  #include "utility/ServerTrace.h"
+  
+  #define WS_TRACE(stage, arg)        _trace.record(WiFiServerTrace::stage, (arg))
+#else
+  #define WS_TRACE(stage, arg)
+#endif
 
 ////////////////////////////////////////
 
@@ -293,6 +342,29 @@
 
 ////////////////////////////////////////
 
+// Permit redefinition of WS_RESPONSE_STREAM_BUFFER_SZ in sketch. Stack buffer of WiFiResponseStream,
+// each full buffer is sent as one chunk. Minimum is 16 bytes
+#ifndef WS_RESPONSE_STREAM_BUFFER_SZ
+  #define WS_RESPONSE_STREAM_BUFFER_SZ    256
+#elif (WS_RESPONSE_STREAM_BUFFER_SZ < 16)
+  #undef WS_RESPONSE_STREAM_BUFFER_SZ
+  #define WS_RESPONSE_STREAM_BUFFER_SZ    16
+#endif
+
+////////////////////////////////////////
+
+// Permit redefinition in sketch. send_P_template() reads the flash template in blocks of WS_TEMPLATE_BLOCK_SZ,
+// placeholders longer than WS_TEMPLATE_MAX_NAME_LEN are sent literally
+#ifndef WS_TEMPLATE_BLOCK_SZ
+  #define WS_TEMPLATE_BLOCK_SZ        64
+#endif
+
+#ifndef WS_TEMPLATE_MAX_NAME_LEN
+  #define WS_TEMPLATE_MAX_NAME_LEN    32
+#endif
+
+////////////////////////////////////////
+
 #ifndef PGM_VOID_P
   #define PGM_VOID_P const void *
 #endif
@@ -336,7 +408,8 @@ enum HTTPAuthMethod
 
 #define HTTP_DOWNLOAD_UNIT_SIZE 1460
 
-// Permit user to increase HTTP_UPLOAD_BUFLEN larger than default 2K
+// Permit user to increase HTTP_UPLOAD_BUFLEN larger than default 2K. Routes may ask for
+// another size with on(...).setUploadBufferSize(size)
 //#define HTTP_UPLOAD_BUFLEN 2048
 #if !defined(HTTP_UPLOAD_BUFLEN)
   #define HTTP_UPLOAD_BUFLEN 2048
@@ -347,6 +420,53 @@ enum HTTPAuthMethod
 #define HTTP_MAX_SEND_WAIT    5000 //ms to wait for data chunk to be ACKed
 #define HTTP_MAX_CLOSE_WAIT   2000 //ms to wait for the client to close the connection
 
+// Permit redefinition in sketch. Default deadline and number of requests parked by deferResponse()
+#ifndef HTTP_MAX_DEFER_WAIT
+  #define HTTP_MAX_DEFER_WAIT         5000 //ms to wait for resume() before answering 504
+#endif
+
+#ifndef WEBSERVER_MAX_DEFERRED
+  #define WEBSERVER_MAX_DEFERRED      4
+#elif (WEBSERVER_MAX_DEFERRED < 1)
+  #undef WEBSERVER_MAX_DEFERRED
+  #define WEBSERVER_MAX_DEFERRED      1
+#endif
+
+// Permit redefinition in sketch. Longest request or header line accepted by handleClient(budget_us),
+// longer ones are answered with 414 or 431
+#ifndef WEBSERVER_MAX_LINE_LEN
+  #define WEBSERVER_MAX_LINE_LEN      1024
+#endif
+
+// Permit redefinition in sketch. Users kept by setCredentials(), and longest "username:password" of each
+#ifndef WEBSERVER_MAX_CREDENTIALS
+  #define WEBSERVER_MAX_CREDENTIALS         2
+#elif (WEBSERVER_MAX_CREDENTIALS < 1)
+  #undef WEBSERVER_MAX_CREDENTIALS
+  #define WEBSERVER_MAX_CREDENTIALS         1
+#endif
+
+#ifndef WEBSERVER_MAX_CREDENTIAL_LENGTH
+  #define WEBSERVER_MAX_CREDENTIAL_LENGTH   64
+#endif
+
+// Permit redefinition in sketch. Realm of requestAuthentication() and setCredentials() when none is given
+#ifndef WEBSERVER_AUTH_REALM
+  #define WEBSERVER_AUTH_REALM              "Login Required"
+#endif
+
+// Permit redefinition in sketch. Digest nonces outstanding at once, and how long each is accepted
+#ifndef WEBSERVER_MAX_NONCES
+  #define WEBSERVER_MAX_NONCES              4
+#elif (WEBSERVER_MAX_NONCES < 1)
+  #undef WEBSERVER_MAX_NONCES
+  #define WEBSERVER_MAX_NONCES              1
+#endif
+
+#ifndef WEBSERVER_NONCE_LIFETIME
+  #define WEBSERVER_NONCE_LIFETIME          300000 //ms a Digest nonce is accepted before it is stale
+#endif
+
 #define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
 #define CONTENT_LENGTH_NOT_SET ((size_t) -2)
 
@@ -376,7 +496,8 @@ typedef struct
   size_t  totalSize;      // file size
   size_t  currentSize;    // size of data currently in buf
   size_t  contentLength;  // size of entire post request, file size + headers and other request data.
-  uint8_t buf[HTTP_UPLOAD_BUFLEN];
+  uint8_t* buf;           // from WiFiUploadBufferPool, only while the upload is in flight
+  size_t  bufSize;        // size of buf, HTTP_UPLOAD_BUFLEN unless the route set another
 } HTTPUpload;
 
 ////////////////////////////////////////
@@ -408,23 +529,91 @@ class WiFiWebServer
 #endif
         
     virtual void handleClient();
+    
+    // Never calls delay() and returns once budget_us is spent, a partly read request is resumed on the next call.
+    // Handlers still run to completion and multipart uploads are read in one go
+    void handleClient(uint32_t budget_us);
 
     virtual void close();
     void stop();
 
+#if WEBSERVER_SUPPORT_AUTH
+    // Basic or Digest (RFC 7616, MD5 or SHA-256 with qop=auth) credentials of the request
     bool authenticate(const char * username, const char * password);
-    void requestAuthentication();
+
+    // Send 401 with a Basic challenge, or Digest challenges for SHA-256 and MD5 with a fresh nonce
+    void requestAuthentication(HTTPAuthMethod mode = BASIC_AUTH, const char* realm = NULL, const String& authFailMsg = String(""));
+
+    // Add a user for authenticate(). The Basic token of "username:password" and the Digest HA1 of both
+    // algorithms for realm are computed once, here. Returns false if all WEBSERVER_MAX_CREDENTIALS are
+    // in use or the pair is longer than WEBSERVER_MAX_CREDENTIAL_LENGTH
+    bool setCredentials(const char * username, const char * password, const char * realm = NULL);
+    void clearCredentials();
+
+    // Check Basic or Digest credentials against the users of setCredentials(), in constant time and without allocating
+    bool authenticate();
+#endif
 
     typedef vl::Func<void(void)> THandlerFunction;
     //typedef std::function<void(void)> THandlerFunction;
     //typedef void (*THandlerFunction)(void);
 
-    void on(const String &uri, THandlerFunction handler);
-    void on(const String &uri, HTTPMethod method, THandlerFunction fn);
-    void on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+    // The handler returned may be tuned, e.g. on("/upload", HTTP_POST, fn, ufn).setUploadBufferSize(512)
+    RequestHandler& on(const String &uri, THandlerFunction handler);
+    RequestHandler& on(const String &uri, HTTPMethod method, THandlerFunction fn);
+    RequestHandler& on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
     void addHandler(RequestHandler* handler);
     void onNotFound(THandlerFunction fn);   //called when handler is not assigned
+#if WEBSERVER_SUPPORT_UPLOAD
     void onFileUpload(THandlerFunction fn); //handle file uploads
+#endif
+
+#if USE_NEW_WEBSERVER_VERSION
+    // path, index in the innermost array, value
+    typedef vl::Func<void(const char*, int, const char*)> TJsonElementFunction;
+
+    // Tokenize application/json bodies as they stream in. Scalar fields become args,
+    // e.g. arg("config.ssid"), and the body is no longer kept in arg("plain"). An invalid
+    // or incomplete body is answered with 400 and no handler is called
+    void enableJsonArgs(bool value = true);
+
+    // Called for each scalar inside a JSON array, instead of storing it as an arg
+    void onJsonArrayElement(TJsonElementFunction fn);
+
+    // Call from inside a handler to answer later. The connection is parked and onResume is called from handleClient()
+    // after resume(handle), or 504 is sent after timeout_ms. onResume sees the parked request's uri(), method(), args
+    // and headers. Returns -1 if all WEBSERVER_MAX_DEFERRED slots are in use, or if called from onResume
+    int  deferResponse(THandlerFunction onResume, uint32_t timeout_ms = HTTP_MAX_DEFER_WAIT);
+
+    // Mark a deferred request as ready. Only sets a flag, safe to call from an ISR
+    void resume(int handle);
+
+#if WIFI_WEBSERVER_METRICS
+    // Serve the counters and histograms as Prometheus text on GET uri
+    void enableMetrics(const char* uri = "/metrics");
+
+    inline WiFiServerMetrics& metrics()
+    {
+      return _metrics;
+    }
+#endif
+
+#if WIFI_WEBSERVER_TRACE
+    // Serve the trace ring as text on GET uri
+    void enableTrace(const char* uri = "/debug/trace");
+
+    // Print the trace ring, oldest first, e.g. dumpTrace(Serial)
+    inline void dumpTrace(Print& out)
+    {
+      _trace.dump(out);
+    }
+
+    inline void clearTrace()
+    {
+      _trace.clear();
+    }
+#endif
+#endif
 
 		////////////////////////////////////////
 
@@ -449,12 +638,7 @@ class WiFiWebServer
 
 		////////////////////////////////////////
     
-#if USE_NEW_WEBSERVER_VERSION
-    inline HTTPUpload& upload() 
-    {
-      return *_currentUpload;
-    }
-#else
+#if WEBSERVER_SUPPORT_UPLOAD
     inline HTTPUpload& upload() 
     {
       return _currentUpload;
@@ -471,12 +655,14 @@ class WiFiWebServer
   
     int     args();                         // get arguments count
     bool    hasArg(const String& name);     // check if argument exists
+#if WEBSERVER_SUPPORT_HEADERS
     void    collectHeaders(const char* headerKeys[], const size_t headerKeysCount); // set the request headers to collect
     String  header(const String& name);     // get request header value by name
     String  header(int i);                  // get request header value by number
     String  headerName(int i);              // get request header name by number
     int     headers();                      // get header count
     bool    hasHeader(const String& name);  // check if header exists
+#endif
 
 		////////////////////////////////////////
     
@@ -508,6 +694,7 @@ class WiFiWebServer
     	_nullDelay = value;
     }
 
+#if WEBSERVER_SUPPORT_CORS
 		////////////////////////////////////////
         
 		inline void enableCORS(bool value = true) 
@@ -521,6 +708,7 @@ class WiFiWebServer
 		{
 			enableCORS(value);
 		}
+#endif
 
 		////////////////////////////////////////
         
@@ -533,6 +721,7 @@ class WiFiWebServer
     void sendContent(const char* content, size_t contentLength);
     //////
 
+#if WEBSERVER_SUPPORT_PROGMEM
     // KH, Restore PROGMEM commands
     void send_P(int code, PGM_P content_type, PGM_P content);
     void send_P(int code, PGM_P content_type, PGM_P content, size_t contentLength);
@@ -541,6 +730,13 @@ class WiFiWebServer
     void sendContent_P(PGM_P content, size_t contentLength);
     //////
 
+    // Called for each %NAME% placeholder, prints its value to out
+    typedef vl::Func<void(const char* name, Print& out)> TTemplateResolver;
+
+    // Stream a PROGMEM template, replacing %NAME% (letters, digits, '_') with what resolver prints. "%%" is a literal '%'
+    void send_P_template(int code, PGM_P content_type, PGM_P tmpl, TTemplateResolver resolver);
+#endif
+
     static String urlDecode(const String& text);
 
 		////////////////////////////////////////
@@ -558,7 +754,15 @@ class WiFiWebServer
       
       send(200, contentType, "");
       
-      return _currentClient.write(file);
+      size_t sent = _currentClient.write(file);
+      
+#if WIFI_WEBSERVER_METRICS
+      _metrics.bytesOut(sent);
+#endif
+
+      WS_TRACE(WRITE, sent);
+
+      return sent;
     }
 
 		////////////////////////////////////////
@@ -583,7 +787,15 @@ class WiFiWebServer
       {
 				_streamFileCore(file.size(), file.name(), contentType, code);
 				
-    		return _currentClient.write(file);     
+    		size_t sent = _currentClient.write(file);
+    		
+#if WIFI_WEBSERVER_METRICS
+        _metrics.bytesOut(sent);
+#endif
+
+        WS_TRACE(WRITE, sent);
+
+        return sent;
       }
 
 		////////////////////////////////////////
@@ -596,12 +808,18 @@ class WiFiWebServer
   
 		virtual size_t _currentClientWrite(const char* buffer, size_t length) 
 		{ 
+#if WIFI_WEBSERVER_METRICS
+			_metrics.bytesOut(length);
+#endif
+
+			WS_TRACE(WRITE, length);
+
 			return _currentClient.write( buffer, length ); 
 		}
 
 		////////////////////////////////////////
 
-#if (ESP32 || ESP8266)		
+#if ( (ESP32 || ESP8266) && WEBSERVER_SUPPORT_PROGMEM )
 		virtual size_t _currentClientWrite_P(PGM_P buffer, size_t length) 
 		{ 
 			return _currentClient.write_P( buffer, length ); 
@@ -618,16 +836,60 @@ class WiFiWebServer
 #if USE_NEW_WEBSERVER_VERSION
     void _parseArguments(const String& data);
     int  _parseArgumentsPrivate(const String& data, vl::Func<void(String&,String&,const String&,int,int,int,int)> handler);
+#if WEBSERVER_SUPPORT_MULTIPART
     bool _parseForm(WiFiClient& client, const String& boundary, uint32_t len);
+    void _beginFormBody();
+    bool _formBodyWrite(const uint8_t* data, size_t length);
+    bool _formLine();
+    void _formDataByte(uint8_t c);
+    void _formData(uint8_t c);
+    bool _endFormBody();
+    void _abortFormBody();
+#endif
+    bool _parseJsonBody(WiFiClient& client, uint32_t len);
+    void _beginJsonBody();
+    bool _endJsonBody();
+    void _mergePostArgs();
+    void _sendParseError(int code);
+    
+    int  _parseRequestStep(WiFiClient& client, unsigned long start, uint32_t budget_us);
+    bool _parseRequestLine(const String& req);
+    bool _parseHeaderLine(const String& req);
+    void _parseBodyArgs();
+    void _endParseRequest(WiFiClient& client);
+    bool _handleParsedRequest();
+    void _serviceDeferred();
+    void _parkRequest(int slot);
+    void _releaseDeferred(int slot);
+    
+#if WIFI_WEBSERVER_METRICS
+    void _sendMetrics();
+#endif
+    
+    inline bool _requestHasBody()
+    {
+      return ( (_currentMethod == HTTP_POST) || (_currentMethod == HTTP_PUT) || (_currentMethod == HTTP_PATCH)
+               || (_currentMethod == HTTP_DELETE) );
+    }
+    
+    static void _jsonValueCallback(void* context, const char* path, int index, const char* value);
 #else
     void _parseArguments(const String& data);
+#if WEBSERVER_SUPPORT_MULTIPART
     bool _parseForm(WiFiClient& client, const String& boundary, uint32_t len);
+#endif
 #endif
     
     static String _responseCodeToString(int code);    
-    bool          _parseFormUploadAborted();
+#if WEBSERVER_SUPPORT_MULTIPART
+    // Without WEBSERVER_SUPPORT_UPLOAD these only skip the file
+    bool          _uploadStart(const String& name, const String& filename, const String& type, uint32_t len);
     void          _uploadWriteByte(uint8_t b);
+    void          _uploadEnd();
+    bool          _parseFormUploadAborted();
+    void          _uploadRelease();
     int       		_uploadReadByte(WiFiClient& client);
+#endif
     void          _prepareHeader(String& response, int code, const char* content_type, size_t contentLength);
     void          _prepareHeader(WWString& response, int code, const char* content_type, size_t contentLength);
     bool          _collectHeader(const char* headerName, const char* headerValue);
@@ -647,7 +909,7 @@ class WiFiWebServer
       // read up to sizeof(buffer) bytes
       while ((bytesRead = file.readBytes(buffer, sizeof(buffer))) > 0)
       {
-        _currentClient.write(buffer, bytesRead);
+        _currentClientWrite(buffer, bytesRead);
         contentLength += bytesRead;
       }
 
@@ -664,7 +926,9 @@ class WiFiWebServer
       String value;
     };
     
-    bool    					_corsEnabled;
+#if WEBSERVER_SUPPORT_CORS
+    bool    					_corsEnabled      = false;
+#endif
     
     WiFiServer  			_server;
 
@@ -681,21 +945,166 @@ class WiFiWebServer
     RequestHandler*   _firstHandler     = nullptr;
     RequestHandler*   _lastHandler      = nullptr;
     THandlerFunction  _notFoundHandler;
-    THandlerFunction  _fileUploadHandler;
 
     int               _currentArgCount;
     RequestArgument*  _currentArgs      = nullptr;
 
+#if WEBSERVER_SUPPORT_UPLOAD
+    THandlerFunction  _fileUploadHandler;
+
+    // Its buf is only held between the start of a file and the end of its form
+    HTTPUpload        _currentUpload    = {};
+#endif
+
 #if USE_NEW_WEBSERVER_VERSION
-    HTTPUpload*       _currentUpload    = nullptr;
     int               _postArgsLen;
-    RequestArgument*  _postArgs         = nullptr;    
-#else
-    HTTPUpload        _currentUpload;
+    RequestArgument*  _postArgs         = nullptr;
+    
+    WiFiJsonTokenizer*    _jsonTokenizer    = nullptr;
+    TJsonElementFunction  _jsonElementHandler;
+
+    // Request parsing state, kept between handleClient(budget_us) calls
+    enum { PARSE_REQUEST_LINE, PARSE_HEADERS, PARSE_BODY };
+    enum { BODY_PLAIN, BODY_ENCODED, BODY_FORM, BODY_JSON };
+
+    uint8_t           _parseStage       = PARSE_REQUEST_LINE;
+    uint8_t           _bodyType         = BODY_PLAIN;
+    uint32_t          _bodyLength       = 0;
+    uint32_t          _bodyRead         = 0;
+    String            _parseLine;
+    String            _searchStr;
+#if WEBSERVER_SUPPORT_MULTIPART
+    String            _boundaryStr;
+
+    // Multipart body fed by handleClient(budget_us). Lines go to _parseLine, field values to _plainBuf
+    enum { FORM_PREAMBLE, FORM_HEADERS, FORM_DATA, FORM_DELIMITER, FORM_DONE };
+
+    uint8_t           _formState        = FORM_DONE;
+    bool              _formIsFile       = false;
+    uint16_t          _formMatch        = 0;      // bytes of "\r\n--" + boundary matched so far
+    String            _formName;
+    String            _formFilename;
+    String            _formType;
+#endif
+    String            _plainBuf;
+
+    struct DeferredResponse
+    {
+      WiFiClient        client;
+      THandlerFunction  onResume;
+      unsigned long     start         = 0;
+      uint32_t          timeout       = 0;
+      uint8_t           version       = 0;
+      uint8_t           sequence      = 0;        // part of the handle, so a stale resume() can't hit a reused slot
+      volatile bool     ready         = false;
+      volatile bool     inUse         = false;
+
+      // The request, swapped back in while onResume runs
+      HTTPMethod        method        = HTTP_ANY;
+      String            uri;
+      RequestHandler*   handler       = nullptr;
+      int               argCount      = 0;
+      RequestArgument*  args          = nullptr;
+#if WEBSERVER_SUPPORT_HEADERS
+      int               headerCount   = 0;
+      RequestArgument*  headers       = nullptr;
+#endif
+      
+#if WIFI_WEBSERVER_METRICS
+      int               route         = 0;
+#endif
+    };
+
+    DeferredResponse  _deferred[WEBSERVER_MAX_DEFERRED];
+    int               _deferSlot        = -1;    // slot claimed by the running handler
+    bool              _resuming         = false; // an onResume is running, it can't defer again
+
+#if WIFI_WEBSERVER_METRICS
+    WiFiServerMetrics _metrics;
+    int               _metricsRoute     = 0;
+    uint32_t          _requestBytesIn   = 0;
+    unsigned long     _parseStart       = 0;
+#endif
+
+#if WIFI_WEBSERVER_TRACE
+    WiFiServerTrace   _trace;
+#endif
 #endif
     
-    int               _headerKeysCount;
+#if WEBSERVER_SUPPORT_AUTH
+    // Points token at the credentials following scheme in the Authorization header, without copying them
+    bool _authorization(const char* scheme, const char*& token, size_t& length);
+
+    // Non-zero if received differs from expected over expected's length. Takes the same time whatever the content
+    static uint8_t _constantTimeDiff(const char* received, size_t receivedLength, const char* expected, size_t expectedLength);
+
+    // Fields of a Digest Authorization header, pointing into the header itself
+    enum
+    {
+      DIGEST_USERNAME,
+      DIGEST_REALM,
+      DIGEST_NONCE,
+      DIGEST_URI,
+      DIGEST_RESPONSE,
+      DIGEST_ALGORITHM,
+      DIGEST_QOP,
+      DIGEST_NC,
+      DIGEST_CNONCE,
+      DIGEST_FIELDS
+    };
+
+    typedef struct
+    {
+      const char* value;
+      size_t      length;
+    } DigestField;
+
+    typedef struct
+    {
+      char          value[2 * 16 + 1];
+      unsigned long issued;
+      uint32_t      count;            // Highest nc accepted with this nonce
+      uint32_t      realm;            // _realmHash() of the realm challenged with it
+    } DigestNonce;
+
+    typedef struct
+    {
+      char          token[WS_BASE64_ENCODED_LENGTH(WEBSERVER_MAX_CREDENTIAL_LENGTH) + 1];
+      uint16_t      usernameLength;
+      uint8_t       ha1Md5[16];
+      uint8_t       ha1Sha256[32];
+    } Credential;
+
+    // Splits a Digest header into fields. Returns the hash algorithm, or -1 if a field is missing or not supported
+    int _digestFields(const char* params, size_t length, DigestField* fields);
+
+    // Checks the response of fields against ha1 (binary, of the header's algorithm) and the nonce table
+    bool _digestVerify(const DigestField* fields, uint8_t algorithm, const uint8_t* ha1);
+
+    // Issues a nonce for realm in the least recently used slot
+    const char* _newNonce(const char* realm);
+
+    // FNV-1a, enough to tell the realms of one server apart without keeping them
+    static uint32_t _realmHash(const char* realm, size_t length);
+
+    const char* _methodName() const;
+#endif
+
+#if WEBSERVER_SUPPORT_HEADERS
+    int               _headerKeysCount  = 0;
     RequestArgument*  _currentHeaders   = nullptr;
+#endif
+
+#if WEBSERVER_SUPPORT_AUTH
+    // Basic token and Digest HA1 of each user added by setCredentials()
+    Credential        _credentials[WEBSERVER_MAX_CREDENTIALS];
+    uint8_t           _credentialsCount = 0;
+
+    DigestNonce       _nonces[WEBSERVER_MAX_NONCES] = {};
+    uint32_t          _nonceSequence    = 0;
+    bool              _digestStale      = false;
+#endif
+
     size_t            _contentLength;
     int              	_clientContentLength;				// "Content-Length" from header of incoming POST or GET request
     String            _responseHeaders;
@@ -703,4 +1112,33 @@ class WiFiWebServer
     bool              _chunked;
 };
 
+////////////////////////////////////////
+
+// Buffered response body. Sends the header on construction, then coalesces print() / write() calls
+// into WS_RESPONSE_STREAM_BUFFER_SZ blocks, each sent as one chunk to HTTP/1.1 clients
+class WiFiResponseStream : public Print
+{
+  public:
+
+    WiFiResponseStream(WiFiWebServer& server, int code, const char* content_type);
+    ~WiFiResponseStream();
+
+    virtual size_t write(uint8_t c);
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    using Print::write;
+
+    // Send what is buffered as one chunk
+    void flush();
+
+    // Flush and terminate the body. Called by the destructor if not done before
+    void end();
+
+  private:
+
+    WiFiWebServer&  _server;
+    uint16_t        _len;
+    bool            _ended;
+    char            _buffer[WS_RESPONSE_STREAM_BUFFER_SZ];
+};
+
 #endif    // WiFiWebServer_HPP
@@ -0,0 +1,1021 @@
+/****************************************************************************************************************************
+  WiFi_Deflate.cpp - Small-memory raw deflate and inflate for WebSocket permessage-deflate
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "utility/WiFiFeatures.h"
+
+// Compiler flag WEBSERVER_SUPPORT_HTTP_CLIENT=false drops the client from the build
+#if WEBSERVER_SUPPORT_HTTP_CLIENT
+
+#include "WiFi_HTTPClient/WiFi_Deflate.h"
+
+WS_LAYOUT_DEFINE(WiFiDeflate, WS_DEFLATE_HASH_BITS);
+
+////////////////////////////////////////
+
+static const uint16_t kLengthBase[29] PROGMEM =
+{
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8_t kLengthExtra[29] PROGMEM =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const uint16_t kDistanceBase[30] PROGMEM =
+{
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+  4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static const uint8_t kDistanceExtra[30] PROGMEM =
+{
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static const uint8_t kCodeLengthOrder[19] PROGMEM =
+{
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+////////////////////////////////////////
+// WiFiDeflate
+////////////////////////////////////////
+
+WiFiDeflate::WiFiDeflate()
+  : _output(NULL), _context(NULL), _window(NULL), _mask(0), _windowBits(0), _maxMatch(0)
+{
+}
+
+////////////////////////////////////////
+
+WiFiDeflate::~WiFiDeflate()
+{
+  end();
+}
+
+////////////////////////////////////////
+
+bool WiFiDeflate::begin(uint8_t aWindowBits, TDeflateOutputFunction aOutput, void* aContext)
+{
+  end();
+
+  aWindowBits = constrain(aWindowBits, 8, WS_DEFLATE_MAX_WINDOW_BITS);
+
+  _window = (uint8_t*) malloc(1UL << aWindowBits);
+
+  if (!_window)
+  {
+    return false;
+  }
+
+  _windowBits = aWindowBits;
+  _mask       = (1UL << aWindowBits) - 1;
+
+  // Half the window for the bytes being matched, half for the history they match
+  _maxMatch   = min((uint32_t) WS_DEFLATE_MAX_MATCH, (_mask + 1) / 2);
+
+  _output     = aOutput;
+  _context    = aContext;
+
+  reset();
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::end()
+{
+  if (_window)
+  {
+    free(_window);
+    _window = NULL;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::reset()
+{
+  _position   = 0;
+  _end        = 0;
+  _bitBuffer  = 0;
+  _bitCount   = 0;
+  _blockOpen  = false;
+  _outLength  = 0;
+
+  memset(_head, 0, sizeof(_head));
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::write(const uint8_t* aData, size_t aLength)
+{
+  if (!_window)
+    return;
+
+  while (aLength)
+  {
+    // Fill the lookahead up to the longest match, then compress
+    size_t room = _maxMatch - (_end - _position);
+
+    if (room > aLength)
+      room = aLength;
+
+    aLength -= room;
+
+    while (room--)
+    {
+      _window[_end++ & _mask] = *aData++;
+    }
+
+    if (_end - _position >= _maxMatch)
+    {
+      _process(false);
+    }
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::finishMessage()
+{
+  if (!_window)
+    return;
+
+  _process(true);
+
+  if (_blockOpen)
+  {
+    // End of block
+    _putSymbol(256);
+    _blockOpen = false;
+  }
+
+  // Empty stored block, byte-aligned. Its LEN and NLEN are the tail the receiver adds back
+  _putBits(0, 3);
+
+  if (_bitCount)
+  {
+    _putBits(0, 8 - _bitCount);
+  }
+
+  _flushOutput();
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::_process(bool flush)
+{
+  while (true)
+  {
+    uint32_t lookahead = _end - _position;
+
+    if ( flush ? (lookahead == 0) : (lookahead < _maxMatch) )
+      break;
+
+    uint16_t matchLength    = 0;
+    uint32_t matchDistance  = 0;
+
+    if (lookahead >= 3)
+    {
+      uint16_t hash     = _hash(_position);
+      uint32_t distance = (uint16_t) (_position - _head[hash]);
+
+      _head[hash] = (uint16_t) _position;
+
+      // The match must still be in the window, which also holds the lookahead
+      if ( (distance > 0) && (distance <= _position) && (distance <= _mask + 1 - lookahead) )
+      {
+        uint32_t  candidate = _position - distance;
+        uint32_t  limit     = min(lookahead, (uint32_t) _maxMatch);
+        uint16_t  length    = 0;
+
+        while ( (length < limit) && (_window[(candidate + length) & _mask] == _window[(_position + length) & _mask]) )
+        {
+          length++;
+        }
+
+        if (length >= 3)
+        {
+          matchLength   = length;
+          matchDistance = distance;
+        }
+      }
+    }
+
+    if (!_blockOpen)
+    {
+      // BFINAL 0, BTYPE 01 fixed Huffman codes
+      _putBits(2, 3);
+      _blockOpen = true;
+    }
+
+    if (matchLength)
+    {
+      uint16_t  value = matchLength - 3;
+      uint8_t   extraBits = 0;
+
+      if (matchLength == 258)
+      {
+        _putSymbol(285);
+      }
+      else if (value < 8)
+      {
+        _putSymbol(257 + value);
+      }
+      else
+      {
+        uint8_t top = 31 - __builtin_clz(value);
+
+        extraBits = top - 2;
+        _putSymbol(257 + 4 * (top - 1) + ((value >> extraBits) & 3));
+        _putBits(value & ((1 << extraBits) - 1), extraBits);
+      }
+
+      value = matchDistance - 1;
+
+      if (value < 4)
+      {
+        _putCode(value, 5);
+      }
+      else
+      {
+        uint8_t top = 31 - __builtin_clz(value);
+
+        extraBits = top - 1;
+        _putCode(2 * top + ((value >> extraBits) & 1), 5);
+        _putBits(value & ((1 << extraBits) - 1), extraBits);
+      }
+
+      // Hash the bytes inside the match too, for later matches
+      for (uint16_t i = 1; i < matchLength; i++)
+      {
+        uint32_t position = _position + i;
+
+        if (_end - position >= 3)
+          _head[_hash(position)] = (uint16_t) position;
+      }
+
+      _position += matchLength;
+    }
+    else
+    {
+      _putSymbol(_window[_position & _mask]);
+      _position++;
+    }
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::_putBits(uint32_t bits, uint8_t count)
+{
+  _bitBuffer |= bits << _bitCount;
+  _bitCount  += count;
+
+  while (_bitCount >= 8)
+  {
+    _out[_outLength++] = (uint8_t) _bitBuffer;
+
+    if (_outLength == sizeof(_out))
+      _flushOutput();
+
+    _bitBuffer >>= 8;
+    _bitCount   -= 8;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::_putCode(uint16_t code, uint8_t length)
+{
+  // Huffman codes go most significant bit first
+  uint16_t reversed = 0;
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    reversed  = (reversed << 1) | (code & 1);
+    code    >>= 1;
+  }
+
+  _putBits(reversed, length);
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::_putSymbol(uint16_t symbol)
+{
+  // Fixed literal/length codes, RFC 1951 3.2.6
+  if (symbol < 144)
+    _putCode(0x30 + symbol, 8);
+  else if (symbol < 256)
+    _putCode(0x190 + symbol - 144, 9);
+  else if (symbol < 280)
+    _putCode(symbol - 256, 7);
+  else
+    _putCode(0xC0 + symbol - 280, 8);
+}
+
+////////////////////////////////////////
+
+void WiFiDeflate::_flushOutput()
+{
+  if (_outLength && _output)
+  {
+    _output(_context, _out, _outLength);
+  }
+
+  _outLength = 0;
+}
+
+////////////////////////////////////////
+// WiFiInflate
+////////////////////////////////////////
+
+WiFiInflate::WiFiInflate()
+  : _window(NULL), _mask(0)
+{
+}
+
+////////////////////////////////////////
+
+WiFiInflate::~WiFiInflate()
+{
+  end();
+}
+
+////////////////////////////////////////
+
+bool WiFiInflate::begin(uint8_t aWindowBits)
+{
+  end();
+
+  aWindowBits = constrain(aWindowBits, 8, WS_DEFLATE_MAX_WINDOW_BITS);
+
+  _window = (uint8_t*) malloc(1UL << aWindowBits);
+
+  if (!_window)
+  {
+    return false;
+  }
+
+  _mask = (1UL << aWindowBits) - 1;
+
+  reset();
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiInflate::end()
+{
+  if (_window)
+  {
+    free(_window);
+    _window = NULL;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiInflate::reset()
+{
+  _writePos = 0;
+  _readPos  = 0;
+  _history  = 0;
+
+  beginMessage();
+}
+
+////////////////////////////////////////
+
+void WiFiInflate::beginMessage()
+{
+  _state      = STATE_BLOCK_HEADER;
+  _finalBlock = false;
+  _inLength   = 0;
+  _inPos      = 0;
+  _tailLeft   = 0;
+  _finishing  = false;
+  _bitBuffer  = 0;
+  _bitCount   = 0;
+  _readPos    = _writePos;
+}
+
+////////////////////////////////////////
+
+size_t WiFiInflate::write(const uint8_t* aData, size_t aLength)
+{
+  if (_inPos)
+  {
+    memmove(_in, _in + _inPos, _inLength - _inPos);
+    _inLength -= _inPos;
+    _inPos     = 0;
+  }
+
+  size_t length = min(aLength, sizeof(_in) - _inLength);
+
+  memcpy(_in + _inLength, aData, length);
+  _inLength += length;
+
+  return length;
+}
+
+////////////////////////////////////////
+
+void WiFiInflate::finishMessage()
+{
+  if (!_finishing)
+  {
+    _finishing  = true;
+    _tailLeft   = 4;
+  }
+}
+
+////////////////////////////////////////
+
+int WiFiInflate::available()
+{
+  if (!_window)
+    return 0;
+
+  _decode();
+
+  return _writePos - _readPos;
+}
+
+////////////////////////////////////////
+
+int WiFiInflate::read(uint8_t* aBuffer, size_t aSize)
+{
+  if (!_window)
+    return -1;
+
+  size_t total = 0;
+
+  while (total < aSize)
+  {
+    _decode();
+
+    size_t length = min((size_t) (_writePos - _readPos), aSize - total);
+
+    if (length == 0)
+      break;
+
+    // Up to the end of the window, then from its start
+    size_t start  = _readPos & _mask;
+    size_t first  = min(length, (size_t) (_mask + 1 - start));
+
+    memcpy(aBuffer + total, _window + start, first);
+    memcpy(aBuffer + total + first, _window, length - first);
+
+    _readPos  += length;
+    total     += length;
+  }
+
+  if ( (total == 0) && error() )
+    return -1;
+
+  return total;
+}
+
+////////////////////////////////////////
+
+int WiFiInflate::peek()
+{
+  if ( !_window || (available() == 0) )
+    return -1;
+
+  return _window[_readPos & _mask];
+}
+
+////////////////////////////////////////
+
+bool WiFiInflate::done()
+{
+  return (_state == STATE_DONE) && (_writePos == _readPos);
+}
+
+////////////////////////////////////////
+
+bool WiFiInflate::_need(uint8_t bits)
+{
+  while (_bitCount <= 24)
+  {
+    uint8_t c;
+
+    if (_inPos < _inLength)
+    {
+      c = _in[_inPos++];
+    }
+    else if (_finishing && _tailLeft)
+    {
+      c = (_tailLeft > 2) ? 0x00 : 0xFF;
+      _tailLeft--;
+    }
+    else
+    {
+      break;
+    }
+
+    _bitBuffer |= (uint32_t) c << _bitCount;
+    _bitCount  += 8;
+  }
+
+  return (_bitCount >= bits);
+}
+
+////////////////////////////////////////
+
+uint32_t WiFiInflate::_getBits(uint8_t bits)
+{
+  uint32_t value = _bitBuffer & ((1UL << bits) - 1);
+
+  _bitBuffer >>= bits;
+  _bitCount   -= bits;
+
+  return value;
+}
+
+////////////////////////////////////////
+
+int WiFiInflate::_peekSymbol(const uint16_t* count, const uint16_t* symbol, uint8_t& length)
+{
+  // Canonical Huffman decoding a bit at a time, without consuming the bits
+  int code  = 0;
+  int first = 0;
+  int index = 0;
+
+  for (uint8_t len = 1; len <= 15; len++)
+  {
+    if (len > _bitCount)
+    {
+      // -2: wait for more input
+      return _inputDone() ? -1 : -2;
+    }
+
+    code |= (_bitBuffer >> (len - 1)) & 1;
+
+    int n = count[len];
+
+    if (code - n < first)
+    {
+      length = len;
+
+      return symbol[index + (code - first)];
+    }
+
+    index  += n;
+    first  += n;
+    first <<= 1;
+    code  <<= 1;
+  }
+
+  return -1;
+}
+
+////////////////////////////////////////
+
+bool WiFiInflate::_build(uint16_t* count, uint16_t* symbol, const uint8_t* lengths, uint16_t n)
+{
+  uint16_t offsets[16];
+
+  memset(count, 0, 16 * sizeof(uint16_t));
+
+  for (uint16_t i = 0; i < n; i++)
+  {
+    count[lengths[i]]++;
+  }
+
+  // No more codes than the lengths allow
+  int left = 1;
+
+  for (uint8_t len = 1; len < 16; len++)
+  {
+    left <<= 1;
+    left  -= count[len];
+
+    if (left < 0)
+      return false;
+  }
+
+  offsets[1] = 0;
+
+  for (uint8_t len = 1; len < 15; len++)
+  {
+    offsets[len + 1] = offsets[len] + count[len];
+  }
+
+  for (uint16_t i = 0; i < n; i++)
+  {
+    if (lengths[i])
+      symbol[offsets[lengths[i]]++] = i;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiInflate::_buildFixed()
+{
+  uint16_t i = 0;
+
+  while (i < 144)
+    _lengths[i++] = 8;
+
+  while (i < 256)
+    _lengths[i++] = 9;
+
+  while (i < 280)
+    _lengths[i++] = 7;
+
+  while (i < 288)
+    _lengths[i++] = 8;
+
+  _build(_literal.count, _literal.symbol, _lengths, 288);
+
+  memset(_lengths, 5, 30);
+  _build(_distanceCodes.count, _distanceCodes.symbol, _lengths, 30);
+}
+
+////////////////////////////////////////
+
+void WiFiInflate::_decode()
+{
+  while (true)
+  {
+    switch (_state)
+    {
+      case STATE_BLOCK_HEADER:
+        if (!_need(3))
+        {
+          // Only the padding after the last block is left
+          if (_inputDone())
+            _state = STATE_DONE;
+
+          return;
+        }
+
+        _finalBlock = _getBits(1);
+
+        switch (_getBits(2))
+        {
+          case 0:
+            _state = STATE_STORED_HEADER;
+            break;
+
+          case 1:
+            _buildFixed();
+            _state = STATE_SYMBOL;
+            break;
+
+          case 2:
+            _state = STATE_TABLE_COUNTS;
+            break;
+
+          default:
+            _state = STATE_ERROR;
+            break;
+        }
+
+        break;
+
+      case STATE_STORED_HEADER:
+        // Skip to a byte boundary, then LEN and NLEN
+        _getBits(_bitCount & 7);
+
+        if (!_need(32))
+        {
+          if (_inputDone())
+            _state = STATE_ERROR;
+
+          return;
+        }
+
+        _copyLength = _getBits(16);
+
+        if (_copyLength != (uint16_t) ~_getBits(16))
+        {
+          _state = STATE_ERROR;
+          break;
+        }
+
+        _state = STATE_STORED_COPY;
+
+        break;
+
+      case STATE_STORED_COPY:
+        while (_copyLength)
+        {
+          if (_space() == 0)
+            return;
+
+          if (!_need(8))
+          {
+            if (_inputDone())
+              _state = STATE_ERROR;
+
+            return;
+          }
+
+          _put(_getBits(8));
+          _copyLength--;
+        }
+
+        _state = _finalBlock ? STATE_DONE : STATE_BLOCK_HEADER;
+
+        break;
+
+      case STATE_TABLE_COUNTS:
+        if (!_need(14))
+        {
+          if (_inputDone())
+            _state = STATE_ERROR;
+
+          return;
+        }
+
+        _literals     = _getBits(5) + 257;
+        _distances    = _getBits(5) + 1;
+        _codeLengths  = _getBits(4) + 4;
+
+        if ( (_literals > 286) || (_distances > 30) )
+        {
+          _state = STATE_ERROR;
+          break;
+        }
+
+        memset(_lengths, 0, 19);
+        _index = 0;
+        _state = STATE_TABLE_CODE_LENGTHS;
+
+        break;
+
+      case STATE_TABLE_CODE_LENGTHS:
+        while (_index < _codeLengths)
+        {
+          if (!_need(3))
+          {
+            if (_inputDone())
+              _state = STATE_ERROR;
+
+            return;
+          }
+
+          _lengths[pgm_read_byte(&kCodeLengthOrder[_index++])] = _getBits(3);
+        }
+
+        if (!_build(_lengthCodes.count, _lengthCodes.symbol, _lengths, 19))
+        {
+          _state = STATE_ERROR;
+          break;
+        }
+
+        _index = 0;
+        _state = STATE_TABLE_LENGTHS;
+
+        break;
+
+      case STATE_TABLE_LENGTHS:
+        while (_index < _literals + _distances)
+        {
+          uint8_t length;
+
+          _need(14);
+
+          int symbol = _peekSymbol(_lengthCodes.count, _lengthCodes.symbol, length);
+
+          if (symbol < 0)
+          {
+            if (symbol == -1)
+              _state = STATE_ERROR;
+
+            return;
+          }
+
+          uint8_t extraBits = (symbol < 16) ? 0 : ( (symbol == 16) ? 2 : ( (symbol == 17) ? 3 : 7 ) );
+
+          if (_bitCount < length + extraBits)
+          {
+            if (_inputDone())
+              _state = STATE_ERROR;
+
+            return;
+          }
+
+          _getBits(length);
+
+          if (symbol < 16)
+          {
+            _lengths[_index++] = symbol;
+          }
+          else
+          {
+            uint8_t value = 0;
+            uint8_t repeat;
+
+            if (symbol == 16)
+            {
+              if (_index == 0)
+              {
+                _state = STATE_ERROR;
+                return;
+              }
+
+              value   = _lengths[_index - 1];
+              repeat  = 3 + _getBits(2);
+            }
+            else if (symbol == 17)
+            {
+              repeat  = 3 + _getBits(3);
+            }
+            else
+            {
+              repeat  = 11 + _getBits(7);
+            }
+
+            if (_index + repeat > _literals + _distances)
+            {
+              _state = STATE_ERROR;
+              return;
+            }
+
+            while (repeat--)
+            {
+              _lengths[_index++] = value;
+            }
+          }
+        }
+
+        // The end of block code must exist
+        if ( (_lengths[256] == 0) || !_build(_literal.count, _literal.symbol, _lengths, _literals)
+             || !_build(_distanceCodes.count, _distanceCodes.symbol, _lengths + _literals, _distances) )
+        {
+          _state = STATE_ERROR;
+          break;
+        }
+
+        _state = STATE_SYMBOL;
+
+        break;
+
+      case STATE_SYMBOL:
+      {
+        // Room for the longest match
+        if (_space() < 258)
+          return;
+
+        uint8_t length;
+
+        _need(20);
+
+        int symbol = _peekSymbol(_literal.count, _literal.symbol, length);
+
+        if (symbol < 0)
+        {
+          if (symbol == -1)
+            _state = STATE_ERROR;
+
+          return;
+        }
+
+        if (symbol < 256)
+        {
+          _getBits(length);
+          _put(symbol);
+
+          break;
+        }
+
+        if (symbol == 256)
+        {
+          _getBits(length);
+          _state = _finalBlock ? STATE_DONE : STATE_BLOCK_HEADER;
+
+          break;
+        }
+
+        symbol -= 257;
+
+        if (symbol >= 29)
+        {
+          _state = STATE_ERROR;
+          break;
+        }
+
+        uint8_t extraBits = pgm_read_byte(&kLengthExtra[symbol]);
+
+        if (_bitCount < length + extraBits)
+        {
+          if (_inputDone())
+            _state = STATE_ERROR;
+
+          return;
+        }
+
+        _getBits(length);
+        _copyLength = pgm_read_word(&kLengthBase[symbol]) + _getBits(extraBits);
+        _state      = STATE_DISTANCE;
+
+        break;
+      }
+
+      case STATE_DISTANCE:
+      {
+        uint8_t length;
+
+        _need(15);
+
+        int symbol = _peekSymbol(_distanceCodes.count, _distanceCodes.symbol, length);
+
+        if (symbol < 0)
+        {
+          if (symbol == -1)
+            _state = STATE_ERROR;
+
+          return;
+        }
+
+        if (symbol >= 30)
+        {
+          _state = STATE_ERROR;
+          break;
+        }
+
+        _getBits(length);
+        _distanceSymbol = symbol;
+        _state          = STATE_DISTANCE_EXTRA;
+
+        break;
+      }
+
+      case STATE_DISTANCE_EXTRA:
+      {
+        uint8_t extraBits = pgm_read_byte(&kDistanceExtra[_distanceSymbol]);
+
+        if (!_need(extraBits))
+        {
+          if (_inputDone())
+            _state = STATE_ERROR;
+
+          return;
+        }
+
+        _distance = pgm_read_word(&kDistanceBase[_distanceSymbol]) + _getBits(extraBits);
+
+        if (_distance > _history)
+        {
+          _state = STATE_ERROR;
+          break;
+        }
+
+        _state = STATE_COPY;
+
+        break;
+      }
+
+      case STATE_COPY:
+        while (_copyLength)
+        {
+          if (_space() == 0)
+            return;
+
+          _put(_window[(_writePos - _distance) & _mask]);
+          _copyLength--;
+        }
+
+        _state = STATE_SYMBOL;
+
+        break;
+
+      default:
+        // STATE_DONE, STATE_ERROR
+        return;
+    }
+  }
+}
+
+////////////////////////////////////////
+
+#endif    // #if WEBSERVER_SUPPORT_HTTP_CLIENT
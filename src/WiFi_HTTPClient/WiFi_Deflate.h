@@ -0,0 +1,283 @@
+/****************************************************************************************************************************
+  WiFi_Deflate.h - Small-memory raw deflate and inflate for WebSocket permessage-deflate
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef WiFi_Deflate_H
+#define WiFi_Deflate_H
+
+#include <Arduino.h>
+
+#include "utility/WiFiLayout.h"
+
+////////////////////////////////////////
+
+// RFC 7692 window sizes, 8 to 15 bits. zlib won't compress with 8, so 9 is the smallest offered
+#define WS_DEFLATE_MIN_WINDOW_BITS    9
+#define WS_DEFLATE_MAX_WINDOW_BITS    15
+
+// Longest match the compressor looks for, at most 258. Windows under 2 * 258 bytes use half the window
+#define WS_DEFLATE_MAX_MATCH          258
+
+// Hash table of 2^bits positions. It sizes WiFiDeflate, which WiFi_Deflate.cpp also uses,
+// so redefine it as a compiler flag (e.g. build_flags). The link fails on a sketch-only value
+#ifndef WS_DEFLATE_HASH_BITS
+  #define WS_DEFLATE_HASH_BITS        8
+#endif
+
+////////////////////////////////////////
+
+typedef void (*TDeflateOutputFunction)(void* aContext, const uint8_t* aData, size_t aLength);
+
+////////////////////////////////////////
+
+/** Raw deflate compressor: greedy LZ77 on a hash of the last 3 bytes, fixed Huffman
+    codes. RAM is the 2^windowBits byte window plus a 512 byte hash table
+*/
+class WiFiDeflate
+{
+  public:
+    WiFiDeflate();
+    ~WiFiDeflate();
+
+    /** Allocate the window, 2^aWindowBits bytes
+      @return false if out of memory
+    */
+    bool begin(uint8_t aWindowBits, TDeflateOutputFunction aOutput, void* aContext);
+
+    void end();
+
+    /** Forget the history, for messages compressed without context takeover
+    */
+    void reset();
+
+    /** Compress aData, output goes to the output function as it is produced
+    */
+    void write(const uint8_t* aData, size_t aLength);
+
+    /** Compress what is left and end the message byte-aligned, as a deflate sync flush
+        without its 00 00 FF FF tail (RFC 7692 7.2.1)
+    */
+    void finishMessage();
+
+    uint8_t windowBits() const
+    {
+      return _windowBits;
+    }
+
+  protected:
+
+    void _process(bool flush);
+    void _putBits(uint32_t bits, uint8_t count);
+    void _putCode(uint16_t code, uint8_t length);
+    void _putSymbol(uint16_t symbol);
+    void _flushOutput();
+
+    uint16_t _hash(uint32_t position)
+    {
+      uint32_t key = ((uint32_t) _window[position & _mask] << 16) | ((uint32_t) _window[(position + 1) & _mask] << 8)
+                     | _window[(position + 2) & _mask];
+
+      return (uint32_t) (key * 2654435761UL) >> (32 - WS_DEFLATE_HASH_BITS);
+    }
+
+    TDeflateOutputFunction  _output;
+    void*                   _context;
+
+    uint8_t*  _window;
+    uint32_t  _mask;
+    uint8_t   _windowBits;
+    uint16_t  _maxMatch;
+
+    // Next byte to compress, and end of the input, as absolute positions
+    uint32_t  _position;
+    uint32_t  _end;
+
+    uint32_t  _bitBuffer;
+    uint8_t   _bitCount;
+    bool      _blockOpen;
+
+    uint8_t   _outLength;
+    uint8_t   _out[32];
+
+    // Low 16 bits of the last position with each hash
+    uint16_t  _head[1 << WS_DEFLATE_HASH_BITS];
+};
+
+WS_LAYOUT_CHECK(WiFiDeflate, WS_DEFLATE_HASH_BITS);
+
+////////////////////////////////////////
+
+/** Raw deflate decompressor for stored, fixed and dynamic Huffman blocks. Input is
+    written as it arrives and decoding resumes where it stopped, so it never waits.
+    RAM is the 2^windowBits byte window plus about 1.3KB of tables
+*/
+class WiFiInflate
+{
+  public:
+    WiFiInflate();
+    ~WiFiInflate();
+
+    /** Allocate the window, 2^aWindowBits bytes. The peer must not use a larger one
+      @return false if out of memory
+    */
+    bool begin(uint8_t aWindowBits);
+
+    void end();
+
+    /** Forget the history
+    */
+    void reset();
+
+    /** Start a message, keeping the history of the previous ones
+    */
+    void beginMessage();
+
+    /** Queue compressed input
+      @return bytes taken, up to inputSpace()
+    */
+    size_t write(const uint8_t* aData, size_t aLength);
+
+    size_t inputSpace() const
+    {
+      return sizeof(_in) - (_inLength - _inPos);
+    }
+
+    /** All compressed input of the message is written, add the 00 00 FF FF tail
+    */
+    void finishMessage();
+
+    /** Decode as far as the input and room in the window allow
+      @return bytes ready to read
+    */
+    int available();
+
+    /** Read decoded bytes
+      @return bytes read, 0 if more input is needed, -1 on a corrupt stream
+    */
+    int read(uint8_t* aBuffer, size_t aSize);
+
+    /** Next decoded byte, without reading it
+      @return the byte, or -1 if none is ready
+    */
+    int peek();
+
+    /** @return true once the whole message is decoded and read
+    */
+    bool done();
+
+    bool error() const
+    {
+      return (_state == STATE_ERROR);
+    }
+
+  protected:
+
+    typedef enum
+    {
+      STATE_BLOCK_HEADER,
+      STATE_STORED_HEADER,
+      STATE_STORED_COPY,
+      STATE_TABLE_COUNTS,
+      STATE_TABLE_CODE_LENGTHS,
+      STATE_TABLE_LENGTHS,
+      STATE_SYMBOL,
+      STATE_DISTANCE,
+      STATE_DISTANCE_EXTRA,
+      STATE_COPY,
+      STATE_DONE,
+      STATE_ERROR
+    } State;
+
+    typedef struct
+    {
+      uint16_t  count[16];
+      uint16_t  symbol[288];
+    } Huffman;
+
+    typedef struct
+    {
+      uint16_t  count[16];
+      uint16_t  symbol[32];
+    } HuffmanShort;
+
+    void _decode();
+    bool _need(uint8_t bits);
+    bool _inputDone() const
+    {
+      return _finishing && (_tailLeft == 0) && (_inPos >= _inLength);
+    }
+
+    uint32_t _space() const
+    {
+      return (_mask + 1) - (_writePos - _readPos);
+    }
+
+    uint32_t _getBits(uint8_t bits);
+    int  _peekSymbol(const uint16_t* count, const uint16_t* symbol, uint8_t& length);
+    bool _build(uint16_t* count, uint16_t* symbol, const uint8_t* lengths, uint16_t n);
+    void _buildFixed();
+    void _put(uint8_t c)
+    {
+      _window[_writePos++ & _mask] = c;
+
+      if (_history < _mask + 1)
+        _history++;
+    }
+
+    uint8_t*  _window;
+    uint32_t  _mask;
+
+    // Decoded and read positions in the window
+    uint32_t  _writePos;
+    uint32_t  _readPos;
+    // Bytes of history a distance may reach back to
+    uint32_t  _history;
+
+    State     _state;
+    bool      _finalBlock;
+
+    // Compressed input not decoded yet
+    uint8_t   _in[64];
+    uint8_t   _inLength;
+    uint8_t   _inPos;
+    // 00 00 FF FF tail bytes still to feed, once the message is finished
+    uint8_t   _tailLeft;
+    bool      _finishing;
+
+    uint32_t  _bitBuffer;
+    uint8_t   _bitCount;
+
+    // Block and table state, kept across calls
+    uint16_t  _copyLength;
+    uint16_t  _distance;
+    uint16_t  _literals;
+    uint8_t   _distances;
+    uint8_t   _codeLengths;
+    uint16_t  _index;
+    uint8_t   _distanceSymbol;
+
+    Huffman       _literal;
+    HuffmanShort  _distanceCodes;
+    HuffmanShort  _lengthCodes;
+    uint8_t       _lengths[288 + 32];
+};
+
+#endif    // WiFi_Deflate_H
@@ -0,0 +1,151 @@
+/****************************************************************************************************************************
+  WiFi_DnsCache.cpp - Host name to IPAddress cache for WiFiHttpClient
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "utility/WiFiFeatures.h"
+
+// Compiler flag WEBSERVER_SUPPORT_HTTP_CLIENT=false drops the client from the build
+#if WEBSERVER_SUPPORT_HTTP_CLIENT
+
+#include "WiFi_HTTPClient/WiFi_DnsCache.h"
+
+#include "utility/WiFiDebug.h"
+
+WS_LAYOUT_DEFINE(WiFiDnsCache, WS_DNS_CACHE_ENTRIES, WS_DNS_CACHE_TTL, WS_DNS_CACHE_NEGATIVE_TTL, WS_DNS_CACHE_MAX_HOST_LEN);
+
+////////////////////////////////////////
+
+WiFiDnsCache::WiFiDnsCache(THostResolverFunction aResolver)
+  : _resolver(aResolver), _ttl(WS_DNS_CACHE_TTL), _negativeTTL(WS_DNS_CACHE_NEGATIVE_TTL), _hits(0), _misses(0)
+{
+  clear();
+}
+
+////////////////////////////////////////
+
+int WiFiDnsCache::resolve(const char* aHostName, IPAddress& aResult)
+{
+  Entry* entry = _find(aHostName);
+
+  if (entry)
+  {
+    _hits++;
+
+    if (entry->resolved)
+    {
+      aResult = entry->address;
+    }
+
+    return entry->resolved ? 1 : 0;
+  }
+
+  _misses++;
+
+  IPAddress address;
+  bool resolved = _resolver && (_resolver(aHostName, address) == 1);
+
+  WS_LOGDEBUG3(F("WiFiDnsCache::resolve:"), aHostName, F(", resolved ="), resolved);
+
+  // A longer name is still resolved, just not cached
+  if (strlen(aHostName) <= WS_DNS_CACHE_MAX_HOST_LEN)
+  {
+    // Take a free or expired entry, else the one expiring first
+    unsigned long now = millis();
+    Entry* slot = &_entries[0];
+
+    for (uint8_t i = 0; i < WS_DNS_CACHE_ENTRIES; i++)
+    {
+      Entry& e = _entries[i];
+
+      if ( !e.host[0] || ((long) (e.expires - now) <= 0) )
+      {
+        slot = &e;
+        break;
+      }
+
+      if ((long) (e.expires - slot->expires) < 0)
+        slot = &e;
+    }
+
+    strcpy(slot->host, aHostName);
+    slot->address   = address;
+    slot->resolved  = resolved;
+    slot->expires   = now + (resolved ? _ttl : _negativeTTL);
+  }
+
+  if (resolved)
+  {
+    aResult = address;
+  }
+
+  return resolved ? 1 : 0;
+}
+
+////////////////////////////////////////
+
+void WiFiDnsCache::invalidate(const char* aHostName)
+{
+  Entry* entry = _find(aHostName);
+
+  if (entry)
+  {
+    entry->host[0] = 0;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiDnsCache::clear()
+{
+  for (uint8_t i = 0; i < WS_DNS_CACHE_ENTRIES; i++)
+  {
+    _entries[i].host[0]   = 0;
+    _entries[i].resolved  = false;
+    _entries[i].expires   = 0;
+  }
+}
+
+////////////////////////////////////////
+
+WiFiDnsCache::Entry* WiFiDnsCache::_find(const char* aHostName)
+{
+  unsigned long now = millis();
+
+  for (uint8_t i = 0; i < WS_DNS_CACHE_ENTRIES; i++)
+  {
+    Entry& e = _entries[i];
+
+    if (e.host[0] && (strcmp(e.host, aHostName) == 0))
+    {
+      if ((long) (e.expires - now) > 0)
+        return &e;
+
+      // Expired
+      e.host[0] = 0;
+
+      return NULL;
+    }
+  }
+
+  return NULL;
+}
+
+////////////////////////////////////////
+
+#endif    // #if WEBSERVER_SUPPORT_HTTP_CLIENT
@@ -0,0 +1,117 @@
+/****************************************************************************************************************************
+  WiFi_DnsCache.h - Host name to IPAddress cache for WiFiHttpClient
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef WiFi_DnsCache_H
+#define WiFi_DnsCache_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+#include "utility/WiFiLayout.h"
+
+////////////////////////////////////////
+
+// These are compiled into WiFi_DnsCache.cpp too, so redefine them as compiler flags
+// (e.g. build_flags). Defined in the sketch only, they fail to link
+
+#ifndef WS_DNS_CACHE_ENTRIES
+  #define WS_DNS_CACHE_ENTRIES          4
+#endif
+
+// Arduino resolvers don't return the record TTL, so cached addresses live this long (ms)
+#ifndef WS_DNS_CACHE_TTL
+  #define WS_DNS_CACHE_TTL              300000UL
+#endif
+
+// Failed lookups are remembered this long (ms), so an unknown host fails fast
+#ifndef WS_DNS_CACHE_NEGATIVE_TTL
+  #define WS_DNS_CACHE_NEGATIVE_TTL     10000UL
+#endif
+
+#ifndef WS_DNS_CACHE_MAX_HOST_LEN
+  #define WS_DNS_CACHE_MAX_HOST_LEN     63
+#endif
+
+////////////////////////////////////////
+
+// Resolve aHostName into aResult, returning 1 on success, as WiFi.hostByName() does
+typedef int (*THostResolverFunction)(const char* aHostName, IPAddress& aResult);
+
+////////////////////////////////////////
+
+class WiFiDnsCache
+{
+  public:
+    WiFiDnsCache(THostResolverFunction aResolver);
+
+    /** Look aHostName up in the cache, else through the resolver
+      @return 1 if aResult holds the address, 0 if the host can't be resolved
+    */
+    int resolve(const char* aHostName, IPAddress& aResult);
+
+    /** Forget aHostName, e.g. after connecting to its cached address failed
+    */
+    void invalidate(const char* aHostName);
+
+    void clear();
+
+    void setTTL(unsigned long aTTL, unsigned long aNegativeTTL = WS_DNS_CACHE_NEGATIVE_TTL)
+    {
+      _ttl          = aTTL;
+      _negativeTTL  = aNegativeTTL;
+    }
+
+    // Lookups answered from the cache, including cached failures
+    uint32_t hits() const
+    {
+      return _hits;
+    }
+
+    // Lookups which went to the resolver
+    uint32_t misses() const
+    {
+      return _misses;
+    }
+
+  protected:
+
+    typedef struct
+    {
+      char          host[WS_DNS_CACHE_MAX_HOST_LEN + 1];
+      IPAddress     address;
+      bool          resolved;
+      unsigned long expires;
+    } Entry;
+
+    Entry* _find(const char* aHostName);
+
+    THostResolverFunction _resolver;
+    Entry                 _entries[WS_DNS_CACHE_ENTRIES];
+    unsigned long         _ttl;
+    unsigned long         _negativeTTL;
+    uint32_t              _hits;
+    uint32_t              _misses;
+};
+
+WS_LAYOUT_CHECK(WiFiDnsCache, WS_DNS_CACHE_ENTRIES, WS_DNS_CACHE_TTL, WS_DNS_CACHE_NEGATIVE_TTL, WS_DNS_CACHE_MAX_HOST_LEN);
+
+#endif    // WiFi_DnsCache_H
@@ -41,8 +41,15 @@
 #define _WIFI_LOGLEVEL_     0
 
 
+#include "utility/WiFiFeatures.h"
+
+// Compiler flag WEBSERVER_SUPPORT_HTTP_CLIENT=false drops the client from the build
+#if WEBSERVER_SUPPORT_HTTP_CLIENT
+
 #include "WiFi_HTTPClient/WiFi_HttpClient.h"
-#include "libb64/base64.h"
+#include "utility/Base64Codec.h"
+
+#include <limits.h>
 
 #include "utility/WiFiDebug.h"
 
@@ -52,6 +59,9 @@
 const char* WiFiHttpClient::kUserAgent = "Arduino/2.2.0";
 const char* WiFiHttpClient::kContentLengthPrefix = HTTP_HEADER_CONTENT_LENGTH ": ";
 const char* WiFiHttpClient::kTransferEncodingChunked = HTTP_HEADER_TRANSFER_ENCODING ": " HTTP_HEADER_VALUE_CHUNKED;
+const char* WiFiHttpClient::kStatusPrefix = "HTTP/*.* ";
+
+WS_LAYOUT_DEFINE(WiFiHttpClient, kHttpWaitForDataDelay, kHttpBodyBlockSize);
 
 ////////////////////////////////////////
 
@@ -80,6 +90,51 @@ WiFiHttpClient::WiFiHttpClient(Client& aClient, const IPAddress& aServerAddress,
 
 ////////////////////////////////////////
 
+WiFiHttpClient::WiFiHttpClient(WiFiHttpConnectionPool& aPool, const char* aServerName, uint16_t aServerPort)
+  : iClient(nullptr), iPool(&aPool), iServerName(aServerName), iServerAddress(), iServerPort(aServerPort),
+    iConnectionClose(false), iSendDefaultRequestHeaders(true)
+{
+  resetState();
+}
+
+////////////////////////////////////////
+
+WiFiHttpClient::WiFiHttpClient(WiFiHttpConnectionPool& aPool, const String& aServerName, uint16_t aServerPort)
+  : WiFiHttpClient(aPool, aServerName.c_str(), aServerPort)
+{
+}
+
+////////////////////////////////////////
+
+WiFiHttpClient::WiFiHttpClient(WiFiHttpConnectionPool& aPool, const IPAddress& aServerAddress, uint16_t aServerPort)
+  : iClient(nullptr), iPool(&aPool), iServerName(NULL), iServerAddress(aServerAddress), iServerPort(aServerPort),
+    iConnectionClose(false), iSendDefaultRequestHeaders(true)
+{
+  resetState();
+}
+
+////////////////////////////////////////
+
+WiFiHttpClient::~WiFiHttpClient()
+{
+  releaseConnection();
+}
+
+////////////////////////////////////////
+
+void WiFiHttpClient::releaseConnection()
+{
+  if (iPool && iClient)
+  {
+    iPool->release(iClient, !iConnectionClose && endOfBodyReached());
+
+    iClient = nullptr;
+    resetState();
+  }
+}
+
+////////////////////////////////////////
+
 void WiFiHttpClient::resetState()
 {
   iState          = eIdle;
@@ -92,6 +147,7 @@ void WiFiHttpClient::resetState()
 
   iIsChunked            = false;
   iChunkLength          = 0;
+  iChunkExtension       = false;
   iHttpResponseTimeout  = kHttpResponseTimeout;
 }
 
@@ -99,7 +155,11 @@ void WiFiHttpClient::resetState()
 
 void WiFiHttpClient::stop()
 {
-  iClient->stop();
+  if (iClient)
+  {
+    iClient->stop();
+  }
+
   resetState();
 }
 
@@ -129,7 +189,7 @@ void WiFiHttpClient::beginRequest()
 int WiFiHttpClient::startRequest(const char* aURLPath, const char* aHttpMethod,
                                  const char* aContentType, int aContentLength, const byte aBody[])
 {
-  if (iState == eReadingBody || iState == eReadingChunkLength || iState == eReadingBodyChunk)
+  if (endOfHeadersReached())
   {
     flushClientRx();
 
@@ -143,9 +203,42 @@ int WiFiHttpClient::startRequest(const char* aURLPath, const char* aHttpMethod,
     return HTTP_ERROR_API;
   }
 
+  if (iPool && !iClient)
+  {
+    iClient = iServerName ? iPool->lease(iServerName, iServerPort) : iPool->lease(iServerAddress, iServerPort);
+
+    if (!iClient)
+    {
+      WS_LOGDEBUG(F("WiFiHttpClient::startRequest: No free pooled connection"));
+
+      return HTTP_ERROR_CONNECTION_FAILED;
+    }
+  }
+
   if (iConnectionClose || !iClient->connected())
   {
-    if (iServerName)
+    if (iServerName && iDnsCache)
+    {
+      IPAddress address;
+
+      if (!iDnsCache->resolve(iServerName, address))
+      {
+        WS_LOGDEBUG(F("WiFiHttpClient::startRequest: DNS lookup failed"));
+
+        return HTTP_ERROR_CONNECTION_FAILED;
+      }
+
+      if (! ( iClient->connect(address, iServerPort) > 0) )
+      {
+        WS_LOGDEBUG(F("WiFiHttpClient::startRequest: Connection failed"));
+
+        // The host may have moved, look it up again next time
+        iDnsCache->invalidate(iServerName);
+
+        return HTTP_ERROR_CONNECTION_FAILED;
+      }
+    }
+    else if (iServerName)
     {
       if (! ( iClient->connect(iServerName, iServerPort) > 0) )
       {
@@ -209,6 +302,11 @@ int WiFiHttpClient::sendInitialHeaders(const char* aURLPath, const char* aHttpMe
 {
   WS_LOGDEBUG(F("WiFiHttpClient::startRequest: Connected"));
 
+  if (!iClient)
+  {
+    return HTTP_ERROR_API;
+  }
+
   // Send the HTTP command, i.e. "GET /somepath/ HTTP/1.0"
   iClient->print(aHttpMethod);
   iClient->print(" ");
@@ -255,6 +353,11 @@ int WiFiHttpClient::sendInitialHeaders(const char* aURLPath, const char* aHttpMe
 
 void WiFiHttpClient::sendHeader(const char* aHeader)
 {
+  if (!iClient)
+  {
+    return;
+  }
+
   iClient->println(aHeader);
 }
 
@@ -262,6 +365,11 @@ void WiFiHttpClient::sendHeader(const char* aHeader)
 
 void WiFiHttpClient::sendHeader(const char* aHeaderName, const char* aHeaderValue)
 {
+  if (!iClient)
+  {
+    return;
+  }
+
   iClient->print(aHeaderName);
   iClient->print(": ");
   iClient->println(aHeaderValue);
@@ -271,6 +379,11 @@ void WiFiHttpClient::sendHeader(const char* aHeaderName, const char* aHeaderValu
 
 void WiFiHttpClient::sendHeader(const char* aHeaderName, const int aHeaderValue)
 {
+  if (!iClient)
+  {
+    return;
+  }
+
   iClient->print(aHeaderName);
   iClient->print(": ");
   iClient->println(aHeaderValue);
@@ -280,53 +393,45 @@ void WiFiHttpClient::sendHeader(const char* aHeaderName, const int aHeaderValue)
 
 void WiFiHttpClient::sendBasicAuth(const char* aUser, const char* aPassword)
 {
+  if (!iClient)
+  {
+    return;
+  }
+
   // Send the initial part of this header line
   iClient->print("Authorization: Basic ");
-  // Now Base64 encode "aUser:aPassword" and send that
-  // This seems trickier than it should be but it's mostly to avoid either
-  // (a) some arbitrarily sized buffer which hopes to be big enough, or
-  // (b) allocating and freeing memory
-  // ...so we'll loop through 3 bytes at a time, outputting the results as we
-  // go.
-  // In Base64, each 3 bytes of unencoded data become 4 bytes of encoded data
-  unsigned char input[3];
-  unsigned char output[5]; // Leave space for a '\0' terminator so we can easily print
-
-  int userLen     = strlen(aUser);
-  int passwordLen = strlen(aPassword);
-  int inputOffset = 0;
-
-  for (int i = 0; i < (userLen + 1 + passwordLen); i++)
-  {
-    // Copy the relevant input byte into the input
-    if (i < userLen)
-    {
-      input[inputOffset++] = aUser[i];
-    }
-    else if (i == userLen)
-    {
-      input[inputOffset++] = ':';
-    }
-    else
-    {
-      input[inputOffset++] = aPassword[i - (userLen + 1)];
-    }
 
-    // See if we've got a chunk to encode
-    if ( (inputOffset == 3) || (i == userLen + passwordLen) )
+  // Now Base64 encode "aUser:aPassword" and send that, a block at a time so
+  // there's no buffer sized for the credentials and nothing allocated
+  static const size_t kBlockSize = 24;
+
+  WiFiBase64Encoder encoder;
+  // Leave space for a '\0' terminator so we can easily print
+  char              output[WS_BASE64_ENCODED_LENGTH(kBlockSize + 2) + 1];
+
+  const char* parts[] = { aUser, ":", aPassword };
+
+  for (uint8_t i = 0; i < sizeof(parts) / sizeof(parts[0]); i++)
+  {
+    const uint8_t*  input = (const uint8_t*) parts[i];
+    size_t          length = strlen(parts[i]);
+
+    while (length)
     {
-      // We've either got to a 3-byte boundary, or we've reached then end
-      base64_encode(input, inputOffset, output, 4);
-      // NUL-terminate the output string
-      output[4] = '\0';
-      // And write it out
-      iClient->print((char*)output);
-      // FIXME We might want to fill output with '=' characters if base64_encode doesn't
-      // FIXME do it for us when we're encoding the final chunk
-      inputOffset = 0;
+      size_t  block   = min(length, kBlockSize);
+      size_t  encoded = encoder.update(input, block, output);
+
+      output[encoded] = '\0';
+      iClient->print(output);
+
+      input  += block;
+      length -= block;
     }
   }
 
+  encoder.finish(output);
+  iClient->print(output);
+
   // And end the header we've sent
   iClient->println();
 }
@@ -335,15 +440,43 @@ void WiFiHttpClient::sendBasicAuth(const char* aUser, const char* aPassword)
 
 void WiFiHttpClient::finishHeaders()
 {
+  if (!iClient)
+  {
+    return;
+  }
+
   iClient->println();
   iState = eRequestSent;
 }
 
 ////////////////////////////////////////
 
+bool WiFiHttpClient::waitForData()
+{
+  if (!iClient)
+  {
+    // Pooled client without a leased connection
+    return false;
+  }
+
+  // Nothing more will arrive once the server has closed and we've read everything
+  if (!iClient->connected())
+  {
+    return (iClient->available() > 0);
+  }
+
+  // We haven't got any data, so let's pause to allow some to
+  // arrive. delay() also yields to the WiFi stack on ESP and RTOS cores
+  delay(kHttpWaitForDataDelay);
+
+  return true;
+}
+
+////////////////////////////////////////
+
 void WiFiHttpClient::flushClientRx()
 {
-  while (iClient->available())
+  while (iClient && iClient->available())
   {
     iClient->read();
   }
@@ -532,127 +665,301 @@ int WiFiHttpClient::responseStatusCode()
     return HTTP_ERROR_API;
   }
 
-  // The first line will be of the form Status-Line:
-  //   HTTP-Version SP Status-Code SP Reason-Phrase CRLF
-  // Where HTTP-Version is of the form:
-  //   HTTP-Version   = "HTTP" "/" 1*DIGIT "." 1*DIGIT
+  // Make sure the status code is reset, and likewise the state.  This
+  // lets us easily cope with 1xx informational responses by just
+  // ignoring them really, and reading the next line for a proper response
+  iStatusCode = 0;
+  iState      = eRequestSent;
+  iStatusPtr  = kStatusPrefix;
 
-  int c = '\0';
+  unsigned long timeoutStart = millis();
 
-  do
+  // Whilst we haven't timed out & haven't reached the end of the status line
+  while ( (millis() - timeoutStart) < iHttpResponseTimeout )
   {
-    // Make sure the status code is reset, and likewise the state.  This
-    // lets us easily cope with 1xx informational responses by just
-    // ignoring them really, and reading the next line for a proper response
-    iStatusCode = 0;
-    iState      = eRequestSent;
+    if (available())
+    {
+      int c = read();
 
-    unsigned long timeoutStart = millis();
+      if (c != -1)
+      {
+        int ret = readStatusChar(c);
 
-    // Psuedo-regexp we're expecting before the status-code
-    const char* statusPrefix  = "HTTP/*.* ";
-    const char* statusPtr     = statusPrefix;
+        if (ret == HTTP_SUCCESS)
+        {
+          // We've read the status-line successfully
+          return iStatusCode;
+        }
+        else if (ret != HTTP_IN_PROGRESS)
+        {
+          return ret;
+        }
 
-    // Whilst we haven't timed out & haven't reached the end of the headers
-    while ((c != '\n') && ( (millis() - timeoutStart) < iHttpResponseTimeout ))
+        // We read something, reset the timeout counter
+        timeoutStart = millis();
+      }
+    }
+    else if (!waitForData())
     {
-      if (available())
-      {
-        c = read();
+      break;
+    }
+  }
+
+  // We must've timed out before we reached the end of the line
+  return HTTP_ERROR_TIMED_OUT;
+}
+
+////////////////////////////////////////
+
+int WiFiHttpClient::readStatusChar(int c)
+{
+  if ( (iState == eRequestSent) && (iStatusPtr == kStatusPrefix) && ( (c == '\r') || (c == '\n') ) )
+  {
+    // Blank line ending a 1xx response, before the next status line
+    return HTTP_IN_PROGRESS;
+  }
 
-        // KH test
-        WS_LOGDEBUG1(F("WiFiHttpClient::startRequest: c ="), String(c));
-        //////
+  switch (iState)
+  {
+    case eRequestSent:
 
-        if (c != -1)
+      // We haven't reached the status code yet
+      if ( (*iStatusPtr == '*') || (*iStatusPtr == c) )
+      {
+        // This character matches, just move along
+        iStatusPtr++;
+
+        if (*iStatusPtr == '\0')
         {
-          switch (iState)
-          {
-            case eRequestSent:
-
-              // We haven't reached the status code yet
-              if ( (*statusPtr == '*') || (*statusPtr == c) )
-              {
-                // This character matches, just move along
-                statusPtr++;
-
-                if (*statusPtr == '\0')
-                {
-                  // We've reached the end of the prefix
-                  iState = eReadingStatusCode;
-                }
-              }
-              else
-              {
-                return HTTP_ERROR_INVALID_RESPONSE;
-              }
-
-              break;
-
-            case eReadingStatusCode:
-              if (isdigit(c))
-              {
-                // This assumes we won't get more than the 3 digits we
-                // want
-                iStatusCode = iStatusCode * 10 + (c - '0');
-              }
-              else
-              {
-                // We've reached the end of the status code
-                // We could sanity check it here or double-check for ' '
-                // rather than anything else, but let's be lenient
-                iState = eStatusCodeRead;
-              }
-
-              break;
-
-            case eStatusCodeRead:
-              // We're just waiting for the end of the line now
-              break;
-
-            default:
-              break;
-          };
-
-          // We read something, reset the timeout counter
-          timeoutStart = millis();
+          // We've reached the end of the prefix
+          iState = eReadingStatusCode;
         }
       }
       else
       {
-        // We haven't got any data, so let's pause to allow some to
-        // arrive
-        delay(kHttpWaitForDataDelay);
+        return HTTP_ERROR_INVALID_RESPONSE;
+      }
+
+      break;
+
+    case eReadingStatusCode:
+      if (isdigit(c))
+      {
+        // This assumes we won't get more than the 3 digits we
+        // want
+        iStatusCode = iStatusCode * 10 + (c - '0');
+      }
+      else
+      {
+        // We've reached the end of the status code
+        // We could sanity check it here or double-check for ' '
+        // rather than anything else, but let's be lenient
+        iState = eStatusCodeRead;
+      }
+
+      break;
+
+    case eStatusCodeRead:
+      // We're just waiting for the end of the line now
+      break;
+
+    default:
+      break;
+  };
+
+  if (c != '\n')
+  {
+    return HTTP_IN_PROGRESS;
+  }
+
+  if (iState != eStatusCodeRead)
+  {
+    // This wasn't a properly formed status line, or at least not one we
+    // could understand
+    return HTTP_ERROR_INVALID_RESPONSE;
+  }
+
+  if (iStatusCode < 200 && iStatusCode != 101)
+  {
+    // We've reached the end of an informational status line,
+    // go back to read the next one
+    iStatusCode = 0;
+    iState      = eRequestSent;
+    iStatusPtr  = kStatusPrefix;
+
+    return HTTP_IN_PROGRESS;
+  }
+
+  return HTTP_SUCCESS;
+}
+
+////////////////////////////////////////
+
+int WiFiHttpClient::startRequestAsync(const char* aURLPath, const char* aHttpMethod,
+                                      const char* aContentType, int aContentLength, const byte aBody[])
+{
+  if (asyncBusy())
+  {
+    return HTTP_ERROR_API;
+  }
+
+  if (endOfHeadersReached())
+  {
+    // Previous response not read to the end
+    flushClientRx();
+
+    resetState();
+  }
+
+  if (iState != eIdle)
+  {
+    // Only the simple API, the request must be complete once sent
+    return HTTP_ERROR_API;
+  }
+
+  int ret = startRequest(aURLPath, aHttpMethod, aContentType, aContentLength, aBody);
+
+  if (ret == HTTP_SUCCESS)
+  {
+    iStatusCode         = 0;
+    iState              = eRequestSent;
+    iStatusPtr          = kStatusPrefix;
+    iAsyncState         = eAsyncStatus;
+    iAsyncTimeoutStart  = millis();
+  }
+
+  return ret;
+}
+
+////////////////////////////////////////
+
+int WiFiHttpClient::step()
+{
+  if (iAsyncState == eAsyncIdle)
+  {
+    return HTTP_ERROR_API;
+  }
+
+  if (!iClient)
+  {
+    // The connection went back to the pool
+    return endAsync(HTTP_ERROR_CONNECTION_FAILED);
+  }
+
+  // Bounded work per call: what has arrived so far
+  int clientAvailable = iClient->available();
+
+  if (clientAvailable > 0)
+  {
+    iAsyncTimeoutStart = millis();
+  }
+
+  if (iAsyncState == eAsyncStatus)
+  {
+    while (clientAvailable-- > 0)
+    {
+      int ret = readStatusChar(iClient->read());
+
+      if (ret == HTTP_SUCCESS)
+      {
+        iAsyncState = eAsyncHeaders;
+        break;
+      }
+      else if (ret != HTTP_IN_PROGRESS)
+      {
+        return endAsync(ret);
+      }
+    }
+  }
+
+  if (iAsyncState == eAsyncHeaders)
+  {
+    while (!endOfHeadersReached() && (iClient->available() > 0))
+    {
+      readHeader();
+    }
+
+    if (endOfHeadersReached())
+    {
+      iAsyncState = eAsyncBody;
+
+      if (iOnResponse)
+      {
+        iOnResponse(*this, iStatusCode, iOnResponseArg);
+      }
+    }
+  }
+
+  if (iAsyncState == eAsyncBody)
+  {
+    uint8_t buffer[kHttpBodyBlockSize];
+
+    while (!endOfBodyReached())
+    {
+      size_t wanted = sizeof(buffer);
+
+      if (!iIsChunked && (iContentLength != kNoContentLengthHeader))
+      {
+        wanted = min(wanted, (size_t) (iContentLength - iBodyLengthConsumed));
+      }
+
+      int avail = available();
+
+      if (avail <= 0)
+      {
+        break;
+      }
+
+      int len = read(buffer, min(wanted, (size_t) avail));
+
+      if (len <= 0)
+      {
+        break;
+      }
+
+      if (iOnBody)
+      {
+        iOnBody(*this, buffer, len, iOnBodyArg);
       }
     }
 
-    if ( (c == '\n') && (iStatusCode < 200 && iStatusCode != 101) )
+    if (endOfBodyReached() || (!iClient->connected() && (iClient->available() <= 0)))
     {
-      // We've reached the end of an informational status line
-      c = '\0'; // Clear c so we'll go back into the data reading loop
+      // Without Content-Length or chunking, the body ends when the server closes
+      return endAsync(HTTP_SUCCESS);
     }
   }
 
-  // If we've read a status code successfully but it's informational (1xx)
-  // loop back to the start
-  while ( (iState == eStatusCodeRead) && (iStatusCode < 200 && iStatusCode != 101) );
+  if (!iClient->connected() && (iClient->available() <= 0))
+  {
+    return endAsync(HTTP_ERROR_CONNECTION_FAILED);
+  }
 
-  if ( (c == '\n') && (iState == eStatusCodeRead) )
+  if (millis() - iAsyncTimeoutStart >= iHttpResponseTimeout)
   {
-    // We've read the status-line successfully
-    return iStatusCode;
+    return endAsync(HTTP_ERROR_TIMED_OUT);
   }
-  else if (c != '\n')
+
+  return HTTP_IN_PROGRESS;
+}
+
+////////////////////////////////////////
+
+int WiFiHttpClient::endAsync(int aResult)
+{
+  iAsyncState = eAsyncIdle;
+
+  if (iConnectionClose || (aResult != HTTP_SUCCESS))
   {
-    // We must've timed out before we reached the end of the line
-    return HTTP_ERROR_TIMED_OUT;
+    stop();
   }
-  else
+
+  if (iOnDone)
   {
-    // This wasn't a properly formed status line, or at least not one we
-    // could understand
-    return HTTP_ERROR_INVALID_RESPONSE;
+    iOnDone(*this, aResult, iOnDoneArg);
   }
+
+  return aResult;
 }
 
 ////////////////////////////////////////
@@ -671,11 +978,9 @@ int WiFiHttpClient::skipResponseHeaders()
       // We read something, reset the timeout counter
       timeoutStart = millis();
     }
-    else
+    else if (!waitForData())
     {
-      // We haven't got any data, so let's pause to allow some to
-      // arrive
-      delay(kHttpWaitForDataDelay);
+      break;
     }
   }
 
@@ -695,7 +1000,8 @@ int WiFiHttpClient::skipResponseHeaders()
 
 bool WiFiHttpClient::endOfHeadersReached()
 {
-  return (iState == eReadingBody || iState == eReadingChunkLength || iState == eReadingBodyChunk);
+  return (iState == eReadingBody || iState == eReadingChunkLength || iState == eReadingBodyChunk
+          || iState == eReadingChunkDataEnd || iState == eReadingChunkTrailer || iState == eChunkedBodyDone);
 };
 
 ////////////////////////////////////////
@@ -718,11 +1024,11 @@ String WiFiHttpClient::responseBody()
   int bodyLength = contentLength();
   String response;
 
-  WS_LOGDEBUG1(F("WiFiHttpClient::responseBody => bodyLength ="), String(bodyLength));
+  WS_LOGDEBUG1(F("WiFiHttpClient::responseBody => bodyLength ="), bodyLength);
 
   if (bodyLength > 0)
   {
-    // try to reserve bodyLength bytes
+    // Reserve once, the body is then appended without reallocation
     if (response.reserve(bodyLength) == 0)
     {
       // String reserve failed
@@ -730,31 +1036,20 @@ String WiFiHttpClient::responseBody()
     }
   }
 
-  // keep on timedRead'ing, until:
-  //  - we have a content length: body length equals consumed or no bytes
-  //                              available
-  //  - no content length:        no bytes are available
-  while (iBodyLengthConsumed != bodyLength)
-  {
-    // KH test
-    int c = timedRead();
-    //int c = iClient->read();
+  // One more for appendBlock()'s NUL
+  uint8_t buffer[kHttpBodyBlockSize + 1];
+  int     len;
 
-    WS_LOGDEBUG1(F("WiFiHttpClient::responseBody => c ="), String(c));
-    //////
-
-    if (c == -1)
-    {
-      // read timed out, done
-      break;
-    }
+  do
+  {
+    len = readBody(buffer, kHttpBodyBlockSize);
 
-    if (!response.concat((char)c))
+    if ( (len > 0) && !appendBlock(response, (char*) buffer, len) )
     {
-      // adding char failed
+      // adding block failed
       return String((const char*)NULL);
     }
-  }
+  } while (len == (int) kHttpBodyBlockSize);
 
   if (bodyLength > 0 && (unsigned int)bodyLength != response.length())
   {
@@ -767,8 +1062,110 @@ String WiFiHttpClient::responseBody()
 
 ////////////////////////////////////////
 
+int WiFiHttpClient::readBody(uint8_t* aBuffer, size_t aSize)
+{
+  // Skip the response headers, if they haven't been read already
+  int bodyLength = contentLength();
+
+  size_t total = 0;
+  unsigned long timeoutStart = millis();
+
+  while (total < aSize)
+  {
+    size_t wanted = aSize - total;
+
+    if (bodyLength != kNoContentLengthHeader)
+    {
+      if (iBodyLengthConsumed >= bodyLength)
+      {
+        // All of Content-Length read
+        break;
+      }
+
+      wanted = min(wanted, (size_t) (bodyLength - iBodyLengthConsumed));
+    }
+
+    int avail = available();
+
+    if (iState == eChunkedBodyDone)
+    {
+      break;
+    }
+
+    if (avail > 0)
+    {
+      // As much as the underlying client has, in one read
+      int len = read(aBuffer + total, min(wanted, (size_t) avail));
+
+      if (len > 0)
+      {
+        total += len;
+        timeoutStart = millis();
+
+        continue;
+      }
+    }
+    else if (iClient && (iClient->available() > 0))
+    {
+      // Only chunk framing was parsed, more is waiting
+      continue;
+    }
+
+    if (!waitForData())
+    {
+      // Closed by the server and nothing left
+      break;
+    }
+
+    if (millis() - timeoutStart >= _timeout)
+    {
+      if (total == 0)
+      {
+        return HTTP_ERROR_TIMED_OUT;
+      }
+
+      break;
+    }
+  }
+
+  return (int) total;
+}
+
+////////////////////////////////////////
+
+int WiFiHttpClient::readBody(Print& aSink)
+{
+  uint8_t buffer[kHttpBodyBlockSize];
+  int     total = 0;
+  int     len;
+
+  do
+  {
+    len = readBody(buffer, sizeof(buffer));
+
+    if (len < 0)
+    {
+      return (total > 0) ? total : len;
+    }
+
+    total += aSink.write(buffer, len);
+  } while (len == (int) sizeof(buffer));
+
+  return total;
+}
+
+////////////////////////////////////////
+
 bool WiFiHttpClient::endOfBodyReached()
 {
+  if (iIsChunked)
+  {
+    // Check for the last chunk without blocking
+    available();
+
+    return (iState == eChunkedBodyDone);
+  }
+
   if (endOfHeadersReached() && (contentLength() != kNoContentLengthHeader))
   {
     // We've got to the body and we know how long it will be
@@ -782,49 +1179,136 @@ bool WiFiHttpClient::endOfBodyReached()
 
 int WiFiHttpClient::available()
 {
-  if (iState == eReadingChunkLength)
+  if (!iClient)
   {
-    while (iClient->available())
-    {
-      char c = iClient->read();
-
-      if (c == '\n')
-      {
-        iState = eReadingBodyChunk;
-        break;
-      }
-      else if (c == '\r')
-      {
-        // no-op
-      }
-      else if (isHexadecimalDigit(c))
-      {
-        char digit[2] = {c, '\0'};
-
-        iChunkLength = (iChunkLength * 16) + strtol(digit, NULL, 16);
-      }
-    }
+    return 0;
   }
 
-  if (iState == eReadingBodyChunk && iChunkLength == 0)
+  if (iIsChunked && (iState != eReadingBodyChunk) && endOfHeadersReached())
   {
-    iState = eReadingChunkLength;
+    readChunkFraming();
   }
 
-  if (iState == eReadingChunkLength)
+  if (iState == eReadingBodyChunk)
+  {
+    return min(iClient->available(), iChunkLength);
+  }
+  else if (iIsChunked && endOfHeadersReached())
   {
+    // Between chunks, or past the last one
     return 0;
   }
 
-  int clientAvailable = iClient->available();
+  return iClient->available();
+}
 
-  if (iState == eReadingBodyChunk)
+////////////////////////////////////////
+
+bool WiFiHttpClient::appendBlock(String& aString, char* aBlock, int aLength)
+{
+  // concat(const char*, length) isn't public in every core, so the block is NUL terminated
+  aBlock[aLength] = '\0';
+
+  if (!memchr(aBlock, '\0', aLength))
   {
-    return min(clientAvailable, iChunkLength);
+    return aString.concat(aBlock);
   }
-  else
+
+  for (int i = 0; i < aLength; i++)
   {
-    return clientAvailable;
+    if (!aString.concat(aBlock[i]))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiHttpClient::readChunkFraming()
+{
+  int clientAvailable = iClient->available();
+
+  while ( (clientAvailable-- > 0) && (iState != eReadingBodyChunk) && (iState != eChunkedBodyDone) )
+  {
+    int c = iClient->read();
+
+    if (c < 0)
+    {
+      break;
+    }
+
+    switch (iState)
+    {
+      case eReadingChunkDataEnd:
+
+        // CRLF after the chunk data
+        if (c == '\n')
+        {
+          iState          = eReadingChunkLength;
+          iChunkLength    = 0;
+          iChunkExtension = false;
+        }
+
+        break;
+
+      case eReadingChunkLength:
+        if (c == '\n')
+        {
+          if (iChunkLength > 0)
+          {
+            iState = eReadingBodyChunk;
+          }
+          else
+          {
+            // Last chunk, skip any trailer headers up to the empty line
+            iState          = eReadingChunkTrailer;
+            iChunkExtension = false;
+          }
+        }
+        else if (!iChunkExtension && isHexadecimalDigit(c))
+        {
+          if (iChunkLength > (INT_MAX >> 4))
+          {
+            // Can't be a real chunk size, give up on the body
+            iState = eChunkedBodyDone;
+            break;
+          }
+
+          iChunkLength = (iChunkLength << 4) | ( (c <= '9') ? (c - '0') : ((c | 0x20) - 'a' + 10) );
+        }
+        else if (c != '\r')
+        {
+          // ";name=value" chunk extension, ignored up to the end of line
+          iChunkExtension = true;
+        }
+
+        break;
+
+      case eReadingChunkTrailer:
+
+        // iChunkExtension marks a trailer line with text
+        if (c == '\n')
+        {
+          if (!iChunkExtension)
+          {
+            iState = eChunkedBodyDone;
+          }
+
+          iChunkExtension = false;
+        }
+        else if (c != '\r')
+        {
+          iChunkExtension = true;
+        }
+
+        break;
+
+      default:
+        break;
+    }
   }
 }
 
@@ -832,6 +1316,11 @@ int WiFiHttpClient::available()
 
 int WiFiHttpClient::read()
 {
+  if (!iClient)
+  {
+    return -1;
+  }
+
   if (iIsChunked && !available())
   {
     return -1;
@@ -854,7 +1343,7 @@ int WiFiHttpClient::read()
 
       if (iChunkLength == 0)
       {
-        iState = eReadingChunkLength;
+        iState = eReadingChunkDataEnd;
       }
     }
   }
@@ -934,6 +1423,24 @@ String WiFiHttpClient::readHeaderValue()
 
 int WiFiHttpClient::read(uint8_t *buf, size_t size)
 {
+  if (!iClient)
+  {
+    return -1;
+  }
+
+  if (iIsChunked && endOfHeadersReached())
+  {
+    // Stay within the current chunk, one read for all of it that has arrived
+    int chunkAvailable = available();
+
+    if (chunkAvailable <= 0)
+    {
+      return -1;
+    }
+
+    size = min(size, (size_t) chunkAvailable);
+  }
+
   int ret = iClient->read(buf, size);
 
   if (endOfHeadersReached() && iContentLength > 0)
@@ -946,6 +1453,16 @@ int WiFiHttpClient::read(uint8_t *buf, size_t size)
     }
   }
 
+  if ( (iState == eReadingBodyChunk) && (ret > 0) )
+  {
+    iChunkLength -= ret;
+
+    if (iChunkLength == 0)
+    {
+      iState = eReadingChunkDataEnd;
+    }
+  }
+
   return ret;
 }
 
@@ -1034,6 +1551,7 @@ int WiFiHttpClient::readHeader()
         {
           iState = eReadingChunkLength;
           iChunkLength = 0;
+          iChunkExtension = false;
         }
         else
         {
@@ -1059,3 +1577,5 @@ int WiFiHttpClient::readHeader()
   // And return the character read to whoever wants it
   return c;
 }
+
+#endif    // #if WEBSERVER_SUPPORT_HTTP_CLIENT
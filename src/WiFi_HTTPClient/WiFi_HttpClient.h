@@ -48,6 +48,9 @@
 #include "Client.h"
 
 #include "utility/WiFiDebug.h"
+#include "utility/WiFiLayout.h"
+#include "WiFi_HTTPClient/WiFi_HttpConnectionPool.h"
+#include "WiFi_HTTPClient/WiFi_DnsCache.h"
 
 ////////////////////////////////////////
 
@@ -69,6 +72,9 @@ static const int HTTP_ERROR_TIMED_OUT = -3;
 // server?
 static const int HTTP_ERROR_INVALID_RESPONSE = -4;
 
+// Returned by step() while an async request is still running
+static const int HTTP_IN_PROGRESS = 1;
+
 ////////////////////////////////////////
 
 // Define some of the common methods and headers here
@@ -89,8 +95,19 @@ static const int HTTP_ERROR_INVALID_RESPONSE = -4;
 ////////////////////////////////////////
 
 // Number of milliseconds that we wait each time there isn't any data
-// available to be read (during status code and header processing)
-#define kHttpWaitForDataDelay     1000L
+// available to be read (during status code and header processing).
+// Kept short, the total wait is bounded by kHttpResponseTimeout. Only read by WiFi_HttpClient.cpp,
+// so redefine it as a compiler flag (e.g. build_flags). Set in the sketch only, it fails to link
+#ifndef kHttpWaitForDataDelay
+  #define kHttpWaitForDataDelay     1L
+#endif
+
+// Stack buffer used by readBody(Print&), responseBody(), step() and the WebSocket client. Only
+// read by the library's .cpp files, so redefine it as a compiler flag (e.g. build_flags). The link
+// fails if only the sketch defines it
+#ifndef kHttpBodyBlockSize
+  #define kHttpBodyBlockSize        128
+#endif
 
 // Number of milliseconds that we'll wait in total without receiveing any
 // data before returning HTTP_ERROR_TIMED_OUT (during status code and header
@@ -99,6 +116,15 @@ static const int HTTP_ERROR_INVALID_RESPONSE = -4;
 
 ////////////////////////////////////////
 
+class WiFiHttpClient;
+
+// Async request callbacks, see startRequestAsync()
+typedef void (*THttpResponseFunction)(WiFiHttpClient& aClient, int aStatusCode, void* aArg);
+typedef void (*THttpBodyFunction)(WiFiHttpClient& aClient, const uint8_t* aData, size_t aLength, void* aArg);
+typedef void (*THttpDoneFunction)(WiFiHttpClient& aClient, int aResult, void* aArg);
+
+////////////////////////////////////////
+
 class WiFiHttpClient : public Client
 {
   public:
@@ -113,6 +139,16 @@ class WiFiHttpClient : public Client
     WiFiHttpClient(Client& aClient, const String& aServerName, uint16_t aServerPort = kHttpPort);
     WiFiHttpClient(Client& aClient, const IPAddress& aServerAddress, uint16_t aServerPort = kHttpPort);
 
+    /** Lease the connection from aPool on the first request, kept alive.
+      It goes back to the pool in releaseConnection() or the destructor. Without a leased
+      connection, reads and writes fail (-1 or 0) and requests return an error
+    */
+    WiFiHttpClient(WiFiHttpConnectionPool& aPool, const char* aServerName, uint16_t aServerPort = kHttpPort);
+    WiFiHttpClient(WiFiHttpConnectionPool& aPool, const String& aServerName, uint16_t aServerPort = kHttpPort);
+    WiFiHttpClient(WiFiHttpConnectionPool& aPool, const IPAddress& aServerAddress, uint16_t aServerPort = kHttpPort);
+
+    virtual ~WiFiHttpClient();
+
     /** Start a more complex request.
         Use this when you need to send additional headers in the request,
         but you will also need to call endRequest() when you are finished.
@@ -226,6 +262,57 @@ class WiFiHttpClient : public Client
                      int aContentLength = -1,
                      const byte aBody[] = NULL);
 
+    /** Connect to the server and send the whole request, then return without
+      waiting for the response. Call step() from loop() until it no longer
+      returns HTTP_IN_PROGRESS. Only the connect itself can block, as
+      Client::connect() does
+      Parameters are the same as for startRequest()
+      @return 0 if successful, else error
+    */
+    int startRequestAsync(const char* aURLPath,
+                          const char* aHttpMethod,
+                          const char* aContentType = NULL,
+                          int aContentLength = -1,
+                          const byte aBody[] = NULL);
+
+    /** Advance the async request with whatever data has arrived, never waiting:
+      status line, headers, then body. Calls onResponse() once the headers are
+      read, onBody() for each block of the body and onDone() at the end
+      @return HTTP_IN_PROGRESS, HTTP_SUCCESS when done, else error
+    */
+    int step();
+
+    /** Called once status line and headers are read
+    */
+    void onResponse(THttpResponseFunction aFunction, void* aArg = NULL)
+    {
+      iOnResponse     = aFunction;
+      iOnResponseArg  = aArg;
+    }
+
+    /** Called with each block of the body. Without it the body is discarded
+    */
+    void onBody(THttpBodyFunction aFunction, void* aArg = NULL)
+    {
+      iOnBody     = aFunction;
+      iOnBodyArg  = aArg;
+    }
+
+    /** Called when the async request ends, with HTTP_SUCCESS or an error
+    */
+    void onDone(THttpDoneFunction aFunction, void* aArg = NULL)
+    {
+      iOnDone     = aFunction;
+      iOnDoneArg  = aArg;
+    }
+
+    /** @return true while an async request is running
+    */
+    bool asyncBusy()
+    {
+      return (iAsyncState != eAsyncIdle);
+    }
+
     /** Send an additional header line.  This can only be called in between the
       calls to beginRequest and endRequest.
       @param aHeader Header line to send, in its entirety (but without the
@@ -392,10 +479,43 @@ class WiFiHttpClient : public Client
     */
     String responseBody();
 
+    /** Read the response body into a caller-provided buffer, in blocks
+      Bounded by Content-Length, chunked bodies are decoded
+      Also skips response headers if they have not been read already
+      MUST be called after responseStatusCode()
+      @param aBuffer  Buffer to fill
+      @param aSize  Size of aBuffer
+      @return Number of bytes read, less than aSize only at the end of the body,
+      or HTTP_ERROR_TIMED_OUT if no data arrived within the Stream timeout
+    */
+    int readBody(uint8_t* aBuffer, size_t aSize);
+
+    /** Stream the response body into aSink, e.g. a File or Serial, without
+      holding all of it in RAM
+      Also skips response headers if they have not been read already
+      MUST be called after responseStatusCode()
+      @return Number of bytes written to aSink, or HTTP_ERROR_TIMED_OUT
+    */
+    int readBody(Print& aSink);
+
     /** Enables connection keep-alive mode
     */
     void connectionKeepAlive();
 
+    /** Give the pooled connection back to its pool. It stays open for the
+      next request if the whole response body was read, else it is closed
+    */
+    void releaseConnection();
+
+    /** Resolve the server name through aDnsCache and connect by address, so
+      repeated connects skip the DNS lookup. Not for TLS clients which need
+      the host name to connect (SNI, certificate check)
+    */
+    void setDnsCache(WiFiDnsCache* aDnsCache)
+    {
+      iDnsCache = aDnsCache;
+    }
+
     /** Disables sending the default request headers (Host and User Agent)
     */
     void noDefaultRequestHeaders();
@@ -412,6 +532,11 @@ class WiFiHttpClient : public Client
         finishHeaders();
       };
 
+      if (!iClient)
+      {
+        return 0;
+      }
+
       return iClient-> write(aByte);
     };
 
@@ -424,6 +549,11 @@ class WiFiHttpClient : public Client
         finishHeaders();
       };
 
+      if (!iClient)
+      {
+        return 0;
+      }
+
       return iClient->write(aBuffer, aSize);
     };
 
@@ -442,14 +572,17 @@ class WiFiHttpClient : public Client
 
     virtual int peek()
     {
-      return iClient->peek();
+      return iClient ? iClient->peek() : -1;
     };
 
     ////////////////////////////////////////
 
     virtual void flush()
     {
-      iClient->flush();
+      if (iClient)
+      {
+        iClient->flush();
+      }
     };
 
     ////////////////////////////////////////
@@ -457,14 +590,14 @@ class WiFiHttpClient : public Client
     // Inherited from Client
     virtual int connect(IPAddress ip, uint16_t port)
     {
-      return iClient->connect(ip, port);
+      return iClient ? iClient->connect(ip, port) : 0;
     };
 
     ////////////////////////////////////////
 
     virtual int connect(const char *host, uint16_t port)
     {
-      return iClient->connect(host, port);
+      return iClient ? iClient->connect(host, port) : 0;
     };
 
     ////////////////////////////////////////
@@ -475,7 +608,7 @@ class WiFiHttpClient : public Client
 
     virtual uint8_t connected()
     {
-      return iClient->connected();
+      return iClient ? iClient->connected() : 0;
     };
 
     ////////////////////////////////////////
@@ -522,8 +655,37 @@ class WiFiHttpClient : public Client
     */
     void flushClientRx();
 
+    /** Pause kHttpWaitForDataDelay ms for more response data to arrive
+      @return false if the connection is closed, so no more data will come
+    */
+    bool waitForData();
+
+    /** Feed one byte of the status line
+      @return HTTP_IN_PROGRESS, HTTP_SUCCESS at the end of a final (not 1xx)
+      status line, or HTTP_ERROR_INVALID_RESPONSE
+    */
+    int readStatusChar(int c);
+
+    /** End the async request and call onDone()
+    */
+    int endAsync(int aResult);
+
+    /** Consume chunk size lines and the CRLF around chunk data, as far as
+      already received, up to the next chunk data or the end of the body
+    */
+    void readChunkFraming();
+
+    /** Append aLength bytes of aBlock to aString. aBlock needs room for a NUL
+      after them, so a block goes in with one concat(). Only a block holding a
+      NUL itself is appended a byte at a time
+      @return false if out of memory
+    */
+    static bool appendBlock(String& aString, char* aBlock, int aLength);
+
     static const char* kContentLengthPrefix;
     static const char* kTransferEncodingChunked;
+    // Psuedo-regexp we're expecting before the status-code
+    static const char* kStatusPrefix;
 
     ////////////////////////////////////////
 
@@ -539,13 +701,28 @@ class WiFiHttpClient : public Client
       eLineStartingCRFound,
       eReadingBody,
       eReadingChunkLength,
-      eReadingBodyChunk
+      eReadingBodyChunk,
+      eReadingChunkDataEnd,
+      eReadingChunkTrailer,
+      eChunkedBodyDone
     } tHttpState;
 
+    typedef enum
+    {
+      eAsyncIdle,
+      eAsyncStatus,
+      eAsyncHeaders,
+      eAsyncBody
+    } tAsyncState;
+
     ////////////////////////////////////////
 
     // Client we're using
     Client* iClient = nullptr;
+    // Pool to lease iClient from, if any
+    WiFiHttpConnectionPool* iPool = nullptr;
+    // Cache to resolve iServerName through, if any
+    WiFiDnsCache* iDnsCache = nullptr;
     // Server we are connecting to
     const char* iServerName = nullptr;
     IPAddress iServerAddress;
@@ -567,10 +744,26 @@ class WiFiHttpClient : public Client
     bool iIsChunked;
     // Stores the value of the current chunk length, if present
     int iChunkLength;
+    // Past the chunk size digits, or in a trailer line with text
+    bool iChunkExtension;
     uint32_t iHttpResponseTimeout;
     bool iConnectionClose;
     bool iSendDefaultRequestHeaders;
     String iHeaderLine;
+    // How far through the "HTTP/*.* " status prefix we are
+    const char* iStatusPtr = nullptr;
+
+    // Async request
+    tAsyncState iAsyncState = eAsyncIdle;
+    unsigned long iAsyncTimeoutStart = 0;
+    THttpResponseFunction iOnResponse = nullptr;
+    void* iOnResponseArg = nullptr;
+    THttpBodyFunction iOnBody = nullptr;
+    void* iOnBodyArg = nullptr;
+    THttpDoneFunction iOnDone = nullptr;
+    void* iOnDoneArg = nullptr;
 };
 
+WS_LAYOUT_CHECK(WiFiHttpClient, kHttpWaitForDataDelay, kHttpBodyBlockSize);
+
 #endif    // WiFi_HttpClient_H
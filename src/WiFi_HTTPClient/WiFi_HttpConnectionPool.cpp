@@ -0,0 +1,260 @@
+/****************************************************************************************************************************
+  WiFi_HttpConnectionPool.cpp - Keep-alive connection pool for WiFiHttpClient
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "utility/WiFiFeatures.h"
+
+// Compiler flag WEBSERVER_SUPPORT_HTTP_CLIENT=false drops the client from the build
+#if WEBSERVER_SUPPORT_HTTP_CLIENT
+
+#include "WiFi_HTTPClient/WiFi_HttpConnectionPool.h"
+
+#include "utility/WiFiDebug.h"
+
+WS_LAYOUT_DEFINE(WiFiHttpConnectionPool, WS_HTTP_POOL_MAX_CONNECTIONS, WS_HTTP_POOL_IDLE_TIMEOUT, WS_HTTP_POOL_MAX_HOST_LEN);
+
+////////////////////////////////////////
+
+WiFiHttpConnectionPool::WiFiHttpConnectionPool()
+  : _count(0), _idleTimeout(WS_HTTP_POOL_IDLE_TIMEOUT), _hits(0), _misses(0)
+{
+}
+
+////////////////////////////////////////
+
+bool WiFiHttpConnectionPool::addClient(Client& aClient)
+{
+  if (_count >= WS_HTTP_POOL_MAX_CONNECTIONS)
+  {
+    WS_LOGERROR(F("WiFiHttpConnectionPool::addClient: Pool full"));
+
+    return false;
+  }
+
+  Slot& slot = _slots[_count++];
+
+  slot.client   = &aClient;
+  slot.host[0]  = 0;
+  slot.address  = IPAddress();
+  slot.port     = 0;
+  slot.leased   = false;
+  slot.reusable = false;
+  slot.lastUsed = 0;
+
+  return true;
+}
+
+////////////////////////////////////////
+
+Client* WiFiHttpConnectionPool::lease(const char* aServerName, uint16_t aServerPort)
+{
+  return _lease(aServerName, IPAddress(), aServerPort);
+}
+
+////////////////////////////////////////
+
+Client* WiFiHttpConnectionPool::lease(const IPAddress& aServerAddress, uint16_t aServerPort)
+{
+  return _lease(NULL, aServerAddress, aServerPort);
+}
+
+////////////////////////////////////////
+
+Client* WiFiHttpConnectionPool::_lease(const char* aServerName, const IPAddress& aServerAddress, uint16_t aServerPort)
+{
+  evictIdle();
+
+  Slot* spare = NULL;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    Slot& slot = _slots[i];
+
+    if (slot.leased)
+      continue;
+
+    bool sameServer = (slot.port == aServerPort) && ( aServerName ? (strcmp(slot.host, aServerName) == 0)
+                                                      : ( !slot.host[0] && (slot.address == aServerAddress) ) );
+
+    if (sameServer && slot.port)
+    {
+      if (_alive(slot))
+      {
+        slot.leased = true;
+        _hits++;
+
+        WS_LOGDEBUG3(F("WiFiHttpConnectionPool::lease: Reuse slot"), i, F(", port ="), aServerPort);
+
+        return slot.client;
+      }
+
+      // The server closed it
+      _close(slot);
+    }
+
+    // Prefer a closed client, else the least recently used idle one
+    if ( !spare || ( spare->port && ( !slot.port || (slot.lastUsed < spare->lastUsed) ) ) )
+    {
+      spare = &slot;
+    }
+  }
+
+  if (!spare)
+  {
+    WS_LOGDEBUG(F("WiFiHttpConnectionPool::lease: All clients leased"));
+
+    return NULL;
+  }
+
+  _close(*spare);
+
+  spare->reusable = true;
+
+  if (aServerName)
+  {
+    if (strlen(aServerName) <= WS_HTTP_POOL_MAX_HOST_LEN)
+    {
+      strcpy(spare->host, aServerName);
+    }
+    else
+    {
+      // A cut name would never match again, or match another host. Connect once, don't keep it
+      WS_LOGWARN1(F("WiFiHttpConnectionPool::lease: Host name too long to keep alive:"), aServerName);
+
+      spare->reusable = false;
+    }
+  }
+  else
+  {
+    spare->address = aServerAddress;
+  }
+
+  spare->port   = aServerPort;
+  spare->leased = true;
+  _misses++;
+
+  return spare->client;
+}
+
+////////////////////////////////////////
+
+void WiFiHttpConnectionPool::release(Client* aClient, bool aKeepAlive)
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    Slot& slot = _slots[i];
+
+    if (slot.client == aClient)
+    {
+      slot.leased = false;
+
+      if (aKeepAlive && slot.reusable && slot.client->connected())
+      {
+        slot.lastUsed = millis();
+      }
+      else
+      {
+        _close(slot);
+      }
+
+      return;
+    }
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiHttpConnectionPool::evictIdle()
+{
+  unsigned long now = millis();
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    Slot& slot = _slots[i];
+
+    if (!slot.leased && slot.port && (now - slot.lastUsed >= _idleTimeout))
+    {
+      WS_LOGDEBUG1(F("WiFiHttpConnectionPool::evictIdle: Close slot"), i);
+
+      _close(slot);
+    }
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiHttpConnectionPool::closeIdle()
+{
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (!_slots[i].leased)
+      _close(_slots[i]);
+  }
+}
+
+////////////////////////////////////////
+
+uint8_t WiFiHttpConnectionPool::hitRate() const
+{
+  uint32_t leases = _hits + _misses;
+
+  return leases ? (uint8_t) ( ((uint64_t) _hits * 100) / leases ) : 0;
+}
+
+////////////////////////////////////////
+
+uint8_t WiFiHttpConnectionPool::connections()
+{
+  uint8_t open = 0;
+
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    if (_slots[i].leased || (_slots[i].port && _slots[i].client->connected()))
+      open++;
+  }
+
+  return open;
+}
+
+////////////////////////////////////////
+
+bool WiFiHttpConnectionPool::_alive(Slot& slot)
+{
+  // An idle keep-alive connection has nothing to read. Data here is a late close
+  // notice or the rest of an unread response, either way the connection can't be reused
+  return slot.client->connected() && (slot.client->available() <= 0);
+}
+
+////////////////////////////////////////
+
+void WiFiHttpConnectionPool::_close(Slot& slot)
+{
+  if (slot.port)
+  {
+    slot.client->stop();
+  }
+
+  slot.host[0]  = 0;
+  slot.address  = IPAddress();
+  slot.port     = 0;
+}
+
+////////////////////////////////////////
+
+#endif    // #if WEBSERVER_SUPPORT_HTTP_CLIENT
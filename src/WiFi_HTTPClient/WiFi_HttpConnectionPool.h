@@ -0,0 +1,141 @@
+/****************************************************************************************************************************
+  WiFi_HttpConnectionPool.h - Keep-alive connection pool for WiFiHttpClient
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef WiFi_HttpConnectionPool_H
+#define WiFi_HttpConnectionPool_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include <IPAddress.h>
+
+#include "utility/WiFiLayout.h"
+
+////////////////////////////////////////
+
+// The values below are compiled into WiFi_HttpConnectionPool.cpp too, so redefine them as
+// compiler flags (e.g. build_flags). The WS_LAYOUT_CHECK below rejects sketch-only values at link time
+
+// Sockets the pool may hold. WiFiNINA, WiFi101 and ESP-AT firmware only have a handful,
+// shared with WiFiWebServer, so keep this small
+#ifndef WS_HTTP_POOL_MAX_CONNECTIONS
+  #define WS_HTTP_POOL_MAX_CONNECTIONS      3
+#endif
+
+// An idle connection older than this is closed, as servers drop them after a while anyway
+#ifndef WS_HTTP_POOL_IDLE_TIMEOUT
+  #define WS_HTTP_POOL_IDLE_TIMEOUT         15000UL
+#endif
+
+// Connections to longer host names are still leased, but closed on release instead of kept
+#ifndef WS_HTTP_POOL_MAX_HOST_LEN
+  #define WS_HTTP_POOL_MAX_HOST_LEN         63
+#endif
+
+////////////////////////////////////////
+
+class WiFiHttpConnectionPool
+{
+  public:
+    WiFiHttpConnectionPool();
+
+    /** Give the pool a client to manage, e.g. a WiFiClient or WiFiSSLClient
+      @return false if the pool is full
+    */
+    bool addClient(Client& aClient);
+
+    /** Lease a client for host:port. A kept-alive connection to the same server is
+      returned first, after checking it is still open. Otherwise a free client, or
+      the least recently used idle one, is closed and returned to be connected again
+      @return the client, or NULL if all are leased
+    */
+    Client* lease(const char* aServerName, uint16_t aServerPort);
+    Client* lease(const IPAddress& aServerAddress, uint16_t aServerPort);
+
+    /** Give a leased client back. With aKeepAlive it stays open for the next lease
+      to the same server, else it is closed
+    */
+    void release(Client* aClient, bool aKeepAlive);
+
+    /** Close idle connections older than the idle timeout. Also done by lease()
+    */
+    void evictIdle();
+
+    /** Close all connections which are not leased
+    */
+    void closeIdle();
+
+    void setIdleTimeout(unsigned long aIdleTimeout)
+    {
+      _idleTimeout = aIdleTimeout;
+    }
+
+    // Leases served by an open connection
+    uint32_t hits() const
+    {
+      return _hits;
+    }
+
+    // Leases which need a new connection
+    uint32_t misses() const
+    {
+      return _misses;
+    }
+
+    // Hits in percent of all leases
+    uint8_t hitRate() const;
+
+    void resetStats()
+    {
+      _hits   = 0;
+      _misses = 0;
+    }
+
+    // Open connections, leased or idle
+    uint8_t connections();
+
+  protected:
+
+    typedef struct
+    {
+      Client*       client;
+      char          host[WS_HTTP_POOL_MAX_HOST_LEN + 1];
+      IPAddress     address;
+      uint16_t      port;
+      bool          leased;
+      bool          reusable;       // false if host didn't fit
+      unsigned long lastUsed;
+    } Slot;
+
+    Client* _lease(const char* aServerName, const IPAddress& aServerAddress, uint16_t aServerPort);
+    bool    _alive(Slot& slot);
+    void    _close(Slot& slot);
+
+    Slot          _slots[WS_HTTP_POOL_MAX_CONNECTIONS];
+    uint8_t       _count;
+    unsigned long _idleTimeout;
+    uint32_t      _hits;
+    uint32_t      _misses;
+};
+
+WS_LAYOUT_CHECK(WiFiHttpConnectionPool, WS_HTTP_POOL_MAX_CONNECTIONS, WS_HTTP_POOL_IDLE_TIMEOUT, WS_HTTP_POOL_MAX_HOST_LEN);
+
+#endif    // WiFi_HttpConnectionPool_H
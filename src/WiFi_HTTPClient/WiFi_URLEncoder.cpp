@@ -40,6 +40,11 @@
 
 #define _WIFI_LOGLEVEL_     0
 
+#include "utility/WiFiFeatures.h"
+
+// Compiler flag WEBSERVER_SUPPORT_HTTP_CLIENT=false drops the client from the build
+#if WEBSERVER_SUPPORT_HTTP_CLIENT
+
 #include "utility/WiFiDebug.h"
 #include "WiFi_HTTPClient/WiFi_URLEncoder.h"
 
@@ -105,3 +110,5 @@ String WiFiURLEncoderClass::encode(const char* str, int length)
 ////////////////////////////////////////
 
 WiFiURLEncoderClass WiFiURLEncoder;
+
+#endif    // #if WEBSERVER_SUPPORT_HTTP_CLIENT
@@ -39,17 +39,28 @@
 
 #define _WIFI_LOGLEVEL_     0
 
-#include "libb64/base64.h"
+#include "utility/WiFiFeatures.h"
+
+// Compiler flag WEBSERVER_SUPPORT_HTTP_CLIENT=false drops the client from the build
+#if WEBSERVER_SUPPORT_HTTP_CLIENT
+
+#include "utility/Base64Codec.h"
 
 #include "utility/WiFiDebug.h"
 #include "WiFi_HTTPClient/WiFi_WebSocketClient.h"
 
+WS_LAYOUT_DEFINE(WiFiWebSocketClient, kWebSocketTxBufferSize);
+
 ////////////////////////////////////////
 
 WiFiWebSocketClient::WiFiWebSocketClient(Client& aClient, const char* aServerName, uint16_t aServerPort)
   : WiFiHttpClient(aClient, aServerName, aServerPort),
     iTxStarted(false),
-    iRxSize(0)
+    iRxOpCode(0),
+    iRxSize(0),
+    iRxHeaderLength(0),
+    iRxControlOpCode(0),
+    iRxPong(false)
 {
 }
 
@@ -58,7 +69,11 @@ WiFiWebSocketClient::WiFiWebSocketClient(Client& aClient, const char* aServerNam
 WiFiWebSocketClient::WiFiWebSocketClient(Client& aClient, const String& aServerName, uint16_t aServerPort)
   : WiFiHttpClient(aClient, aServerName, aServerPort),
     iTxStarted(false),
-    iRxSize(0)
+    iRxOpCode(0),
+    iRxSize(0),
+    iRxHeaderLength(0),
+    iRxControlOpCode(0),
+    iRxPong(false)
 {
 }
 
@@ -67,7 +82,11 @@ WiFiWebSocketClient::WiFiWebSocketClient(Client& aClient, const String& aServerN
 WiFiWebSocketClient::WiFiWebSocketClient(Client& aClient, const IPAddress& aServerAddress, uint16_t aServerPort)
   : WiFiHttpClient(aClient, aServerAddress, aServerPort),
     iTxStarted(false),
-    iRxSize(0)
+    iRxOpCode(0),
+    iRxSize(0),
+    iRxHeaderLength(0),
+    iRxControlOpCode(0),
+    iRxPong(false)
 {
 }
 
@@ -81,10 +100,13 @@ int WiFiWebSocketClient::begin(const char* aPath)
 
   int status = get(aPath);
 
+  iDeflateActive  = false;
+  iRxCompressed   = false;
+
   if (status == 0)
   {
     uint8_t randomKey[16];
-    char base64RandomKey[25];
+    char base64RandomKey[WS_BASE64_ENCODED_LENGTH(16) + 1];
 
     // create a random key for the connection upgrade
     for (int i = 0; i < (int)sizeof(randomKey); i++)
@@ -92,25 +114,83 @@ int WiFiWebSocketClient::begin(const char* aPath)
       randomKey[i] = random(0x01, 0xff);
     }
 
-    memset(base64RandomKey, 0x00, sizeof(base64RandomKey));
-    base64_encode(randomKey, sizeof(randomKey), (unsigned char*)base64RandomKey, sizeof(base64RandomKey));
+    WiFiBase64Encoder::encode(randomKey, sizeof(randomKey), base64RandomKey);
 
     // start the connection upgrade sequence
     sendHeader("Upgrade", "websocket");
     sendHeader("Connection", "Upgrade");
     sendHeader("Sec-WebSocket-Key", base64RandomKey);
     sendHeader("Sec-WebSocket-Version", "13");
+
+    // allocate the windows first, so only what fits is offered
+    bool offerDeflate = iDeflate && iDeflate->begin(iDeflateWindowBits, deflateOutput, this)
+                        && iInflate->begin(iDeflateWindowBits);
+
+    if (offerDeflate)
+    {
+      String offer = "permessage-deflate; client_max_window_bits=";
+
+      offer += iDeflateWindowBits;
+      offer += "; server_max_window_bits=";
+      offer += iDeflateWindowBits;
+
+      if (!iDeflateContextTakeover)
+      {
+        offer += "; client_no_context_takeover; server_no_context_takeover";
+      }
+
+      sendHeader("Sec-WebSocket-Extensions", offer.c_str());
+    }
+
     endRequest();
 
     status = responseStatusCode();
 
     if (status > 0)
     {
-      skipResponseHeaders();
+      // as skipResponseHeaders(), looking for the accepted extension on the way
+      String line;
+      unsigned long timeoutStart = millis();
+
+      while ((!endOfHeadersReached()) && ( (millis() - timeoutStart) < iHttpResponseTimeout ))
+      {
+        if (available())
+        {
+          int c = readHeader();
+
+          if (c == '\n')
+          {
+            if (offerDeflate)
+            {
+              acceptDeflate(line);
+            }
+
+            line = "";
+          }
+          else if (c != '\r')
+          {
+            line += (char) c;
+          }
+
+          timeoutStart = millis();
+        }
+        else if (!waitForData())
+        {
+          break;
+        }
+      }
+    }
+
+    if (!iDeflateActive && iDeflate)
+    {
+      iDeflate->end();
+      iInflate->end();
     }
   }
 
   iRxSize = 0;
+  iRxHeaderLength = 0;
+  iRxControlOpCode = 0;
 
   // status code of 101 means success
   return (status == 101) ? 0 : status;
@@ -125,6 +205,101 @@ int WiFiWebSocketClient::begin(const String& aPath)
 
 ////////////////////////////////////////
 
+void WiFiWebSocketClient::enableDeflate(WiFiDeflate& aDeflate, WiFiInflate& aInflate, uint8_t aWindowBits,
+                                        bool aContextTakeover)
+{
+  iDeflate                = &aDeflate;
+  iInflate                = &aInflate;
+  iDeflateWindowBits      = constrain(aWindowBits, WS_DEFLATE_MIN_WINDOW_BITS, WS_DEFLATE_MAX_WINDOW_BITS);
+  iDeflateContextTakeover = aContextTakeover;
+}
+
+////////////////////////////////////////
+
+void WiFiWebSocketClient::acceptDeflate(const String& aHeaderLine)
+{
+  int colonIndex = aHeaderLine.indexOf(':');
+
+  if (colonIndex == -1)
+  {
+    return;
+  }
+
+  String name = aHeaderLine.substring(0, colonIndex);
+
+  name.trim();
+
+  if (!name.equalsIgnoreCase("Sec-WebSocket-Extensions"))
+  {
+    return;
+  }
+
+  String value = aHeaderLine.substring(colonIndex + 1);
+
+  value.toLowerCase();
+
+  int start = value.indexOf("permessage-deflate");
+
+  if (start == -1)
+  {
+    return;
+  }
+
+  // just this extension, up to the next one
+  value = value.substring(start);
+
+  int end = value.indexOf(',');
+
+  if (end != -1)
+  {
+    value = value.substring(0, end);
+  }
+
+  iDeflateActive      = true;
+  iDeflateClientReset = !iDeflateContextTakeover;
+  iDeflateServerReset = !iDeflateContextTakeover;
+
+  uint8_t clientWindowBits = iDeflateWindowBits;
+  int     paramIndex = value.indexOf(';');
+
+  while (paramIndex != -1)
+  {
+    int nextIndex = value.indexOf(';', paramIndex + 1);
+    String param  = value.substring(paramIndex + 1, (nextIndex == -1) ? value.length() : nextIndex);
+
+    param.trim();
+    param.replace("\"", "");
+
+    if (param == "client_no_context_takeover")
+    {
+      iDeflateClientReset = true;
+    }
+    else if (param == "server_no_context_takeover")
+    {
+      iDeflateServerReset = true;
+    }
+    else if (param.startsWith("client_max_window_bits="))
+    {
+      // the server may ask for a smaller window than offered, its own can only be smaller
+      int bits = param.substring(strlen("client_max_window_bits=")).toInt();
+
+      if ( (bits >= 8) && (bits < clientWindowBits) )
+      {
+        clientWindowBits = bits;
+      }
+    }
+
+    paramIndex = nextIndex;
+  }
+
+  if (clientWindowBits < iDeflate->windowBits())
+  {
+    iDeflateActive = iDeflate->begin(clientWindowBits, deflateOutput, this);
+  }
+}
+
+////////////////////////////////////////
+
 int WiFiWebSocketClient::beginMessage(int aType)
 {
   if (iTxStarted)
@@ -136,6 +311,36 @@ int WiFiWebSocketClient::beginMessage(int aType)
   iTxStarted = true;
   iTxMessageType = (aType & 0xf);
   iTxSize = 0;
+  iTxKnownLength = false;
+  iTxLength = 0;
+  iTxSent = 0;
+  iTxFrameSent = false;
+  iTxError = false;
+
+  // control frames are never compressed
+  iTxCompressed = iDeflateActive && ( (iTxMessageType == TYPE_TEXT) || (iTxMessageType == TYPE_BINARY) );
+
+  return 0;
+}
+
+////////////////////////////////////////
+
+int WiFiWebSocketClient::beginMessage(int aType, uint64_t aLength)
+{
+  if (beginMessage(aType))
+  {
+    return 1;
+  }
+
+  if (iTxCompressed && (aLength >= kDeflateMinLength))
+  {
+    // the compressed length isn't known up front
+    return 0;
+  }
+
+  iTxCompressed = false;
+  iTxKnownLength = true;
+  iTxLength = aLength;
 
   return 0;
 }
@@ -150,56 +355,183 @@ int WiFiWebSocketClient::endMessage()
     return 1;
   }
 
-  // send FIN + the message type (opcode)
-  WiFiHttpClient::write(0x80 | iTxMessageType);
+  if (iTxCompressed)
+  {
+    iDeflate->finishMessage();
+
+    if (iDeflateClientReset)
+    {
+      iDeflate->reset();
+    }
+  }
+
+  int ret = sendTxFrame(true);
 
-  // the message is masked (0x80)
-  // send the length
-  if (iTxSize < 126)
+  if (iTxError)
   {
-    WiFiHttpClient::write(0x80 | (uint8_t)iTxSize);
+    ret = 1;
   }
-  else if (iTxSize < 0xffff)
+
+  // a known length message cut short leaves the connection out of step
+  if (iTxKnownLength && (iTxSent != iTxLength))
   {
-    WiFiHttpClient::write(0x80 | 126);
-    WiFiHttpClient::write((iTxSize >> 8) & 0xff);
-    WiFiHttpClient::write((iTxSize >> 0) & 0xff);
+    ret = 1;
   }
-  else
+
+  iTxStarted = false;
+  iTxSize = 0;
+
+  return ret;
+}
+
+////////////////////////////////////////
+
+int WiFiWebSocketClient::setTxBuffer(uint8_t* aBuffer, size_t aSize)
+{
+  if (iTxStarted)
   {
-    WiFiHttpClient::write(0x80 | 127);
-    WiFiHttpClient::write((iTxSize >> 56) & 0xff);
-    WiFiHttpClient::write((iTxSize >> 48) & 0xff);
-    WiFiHttpClient::write((iTxSize >> 40) & 0xff);
-    WiFiHttpClient::write((iTxSize >> 32) & 0xff);
-    WiFiHttpClient::write((iTxSize >> 24) & 0xff);
-    WiFiHttpClient::write((iTxSize >> 16) & 0xff);
-    WiFiHttpClient::write((iTxSize >>  8) & 0xff);
-    WiFiHttpClient::write((iTxSize >>  0) & 0xff);
+    return 1;
   }
 
-  uint8_t maskKey[4];
+  if (!aBuffer)
+  {
+    iTxBuffer     = iTxStaticBuffer;
+    iTxBufferSize = kWebSocketTxBufferSize;
+
+    return 0;
+  }
 
-  // create a random mask for the data and send
-  for (int i = 0; i < (int)sizeof(maskKey); i++)
+  if (aSize <= kMaxFrameHeader)
   {
-    maskKey[i] = random(0xff);
+    return 1;
   }
 
-  WiFiHttpClient::write(maskKey, sizeof(maskKey));
+  iTxBuffer     = aBuffer;
+  iTxBufferSize = aSize - kMaxFrameHeader;
 
-  // mask the data and send
-  for (int i = 0; i < (int)iTxSize; i++)
+  return 0;
+}
+
+////////////////////////////////////////
+
+int WiFiWebSocketClient::sendTxFrame(bool aFinal)
+{
+  uint8_t* payload = iTxBuffer + kMaxFrameHeader;
+
+  // the header goes right in front of the payload, so the frame is sent in one write
+  uint8_t* frame = payload;
+
+  if (!iTxKnownLength || !iTxFrameSent)
   {
-    iTxBuffer[i] ^= maskKey[i % sizeof(maskKey)];
+    uint64_t length = iTxKnownLength ? iTxLength : iTxSize;
+    bool fin = iTxKnownLength || aFinal;
+
+    frame -= frameHeaderLength(length);
+
+    uint8_t* p = frame;
+
+    // send FIN + the message type (opcode), later fragments are continuations
+    // RSV1 (0x40) marks the first frame of a compressed message
+    *p++ = (fin ? 0x80 : 0x00) | (iTxFrameSent ? TYPE_CONTINUATION : (iTxMessageType | (iTxCompressed ? 0x40 : 0x00)));
+
+    // the message is masked (0x80)
+    // send the length
+    if (length < 126)
+    {
+      *p++ = 0x80 | (uint8_t)length;
+    }
+    else if (length <= 0xffff)
+    {
+      *p++ = 0x80 | 126;
+      *p++ = (length >> 8) & 0xff;
+      *p++ = (length >> 0) & 0xff;
+    }
+    else
+    {
+      *p++ = 0x80 | 127;
+
+      for (int shift = 56; shift >= 0; shift -= 8)
+      {
+        *p++ = (length >> shift) & 0xff;
+      }
+    }
+
+    // create a random mask for the frame and send
+    for (int i = 0; i < (int)sizeof(iTxMaskKey); i++)
+    {
+      iTxMaskKey[i] = random(0xff);
+      *p++ = iTxMaskKey[i];
+    }
+
+    iTxMaskIndex = 0;
+    iTxFrameSent = true;
   }
 
-  size_t txSize = iTxSize;
+  // mask the data and send
+  iTxMaskIndex = maskData(payload, iTxSize, iTxMaskKey, iTxMaskIndex);
 
-  iTxStarted = false;
+  size_t frameSize = (payload + iTxSize) - frame;
+
+  iTxSent += iTxSize;
   iTxSize = 0;
 
-  return (WiFiHttpClient::write(iTxBuffer, txSize) == txSize) ? 0 : 1;
+  if (frameSize == 0)
+  {
+    return 0;
+  }
+
+  return (WiFiHttpClient::write(frame, frameSize) == frameSize) ? 0 : 1;
+}
+
+////////////////////////////////////////
+
+size_t WiFiWebSocketClient::frameHeaderLength(uint64_t aPayloadLength)
+{
+  // opcode, length, extended length, mask key
+  return 2 + ( (aPayloadLength < 126) ? 0 : ( (aPayloadLength <= 0xffff) ? 2 : 8 ) ) + 4;
+}
+
+////////////////////////////////////////
+
+uint8_t WiFiWebSocketClient::maskData(uint8_t* aData, size_t aSize, const uint8_t aMaskKey[4], uint8_t aMaskIndex)
+{
+  // bytes up to a word boundary
+  while (aSize && ((uintptr_t) aData & 3))
+  {
+    *aData++ ^= aMaskKey[aMaskIndex++ & 3];
+    aSize--;
+  }
+
+  if (aSize >= 4)
+  {
+    // the key rotated to start at the current index, in memory order
+    uint8_t rotated[4];
+
+    for (int i = 0; i < 4; i++)
+    {
+      rotated[i] = aMaskKey[(aMaskIndex + i) & 3];
+    }
+
+    uint32_t key;
+    memcpy(&key, rotated, sizeof(key));
+
+    uint32_t* word = (uint32_t*) aData;
+
+    for (size_t words = aSize / 4; words; words--)
+    {
+      *word++ ^= key;
+    }
+
+    aData  = (uint8_t*) word;
+    aSize &= 3;
+  }
+
+  while (aSize--)
+  {
+    *aData++ ^= aMaskKey[aMaskIndex++ & 3];
+  }
+
+  return aMaskIndex & 3;
 }
 
 ////////////////////////////////////////
@@ -225,108 +557,234 @@ size_t WiFiWebSocketClient::write(const uint8_t *aBuffer, size_t aSize)
     return 0;
   }
 
-  // check if the write size, fits in the buffer
-  if ((iTxSize + aSize) > sizeof(iTxBuffer))
+  if (iTxCompressed)
   {
-    aSize = sizeof(iTxSize) - iTxSize;
-  }
+    // the deflater's output comes back through deflateOutput()
+    iDeflate->write(aBuffer, aSize);
 
-  // copy data into the buffer
-  memcpy(iTxBuffer + iTxSize, aBuffer, aSize);
+    return iTxError ? 0 : aSize;
+  }
 
-  iTxSize += aSize;
+  // never more than the length given to beginMessage
+  if (iTxKnownLength && ((iTxSent + iTxSize + aSize) > iTxLength))
+  {
+    aSize = iTxLength - iTxSent - iTxSize;
+  }
 
-  return aSize;
+  return bufferTx(aBuffer, aSize);
 }
 
 ////////////////////////////////////////
 
-int WiFiWebSocketClient::parseMessage()
+void WiFiWebSocketClient::deflateOutput(void* aContext, const uint8_t* aData, size_t aLength)
 {
-  flushRx();
+  WiFiWebSocketClient* client = (WiFiWebSocketClient*) aContext;
 
-  // make sure 2 bytes (opcode + length)
-  // are available
-  if (WiFiHttpClient::available() < 2)
+  if (client->bufferTx(aData, aLength) != aLength)
   {
-    return 0;
+    client->iTxError = true;
   }
+}
 
-  // read open code and length
-  uint8_t opcode = WiFiHttpClient::read();
-  int length = WiFiHttpClient::read();
+////////////////////////////////////////
 
-  if ((opcode & 0x0f) == 0)
-  {
-    // continuation, use previous opcode and update flags
-    iRxOpCode |= opcode;
-  }
-  else
+size_t WiFiWebSocketClient::bufferTx(const uint8_t* aBuffer, size_t aSize)
+{
+  size_t written = 0;
+
+  while (written < aSize)
   {
-    iRxOpCode = opcode;
-  }
+    if (iTxSize == iTxBufferSize)
+    {
+      // buffer full, send it on
+      if (sendTxFrame(false))
+      {
+        break;
+      }
+    }
 
-  iRxMasked = (length & 0x80);
-  length   &= 0x7f;
+    size_t chunk = min((size_t) (iTxBufferSize - iTxSize), aSize - written);
 
-  // read the RX size
-  if (length < 126)
-  {
-    iRxSize = length;
-  }
-  else if (length == 126)
-  {
-    iRxSize = (WiFiHttpClient::read() << 8) | WiFiHttpClient::read();
+    // copy data into the buffer, after the room for the frame header
+    memcpy(iTxBuffer + kMaxFrameHeader + iTxSize, aBuffer + written, chunk);
+
+    iTxSize += chunk;
+    written += chunk;
   }
-  else
+
+  return written;
+}
+
+////////////////////////////////////////
+
+int WiFiWebSocketClient::parseMessage()
+{
+  while (true)
   {
-    iRxSize =   ((uint64_t)WiFiHttpClient::read() << 56) |
-                ((uint64_t)WiFiHttpClient::read() << 48) |
-                ((uint64_t)WiFiHttpClient::read() << 40) |
-                ((uint64_t)WiFiHttpClient::read() << 32) |
-                ((uint64_t)WiFiHttpClient::read() << 24) |
-                ((uint64_t)WiFiHttpClient::read() << 16) |
-                ((uint64_t)WiFiHttpClient::read() << 8)  |
-                (uint64_t)WiFiHttpClient::read();
+    if (iRxControlOpCode == 0)
+    {
+      if (iRxHeaderLength == 0)
+      {
+        // skip what is left of the previous message, as far as it has arrived
+        flushRx();
+
+        if (iRxSize > 0)
+        {
+          return 0;
+        }
+      }
+
+      if (!readFrameHeader())
+      {
+        // wait for the rest of the header
+        return 0;
+      }
+
+      iRxHeaderLength = 0;
+
+      uint8_t opcode = iRxHeader[0];
+
+      if ((opcode & 0x08) == 0)
+      {
+        if ((opcode & 0x0f) == TYPE_CONTINUATION)
+        {
+          // continuation, use previous opcode and update flags
+          iRxOpCode = (opcode & 0x80) | (iRxOpCode & 0x0f);
+        }
+        else
+        {
+          iRxOpCode = opcode;
+
+          // RSV1 (0x40) marks the first frame of a compressed message
+          iRxCompressed = iDeflateActive && (opcode & 0x40);
+
+          if (iRxCompressed)
+          {
+            if (iDeflateServerReset)
+            {
+              iInflate->reset();
+            }
+            else
+            {
+              iInflate->beginMessage();
+            }
+          }
+        }
+
+        return iRxSize;
+      }
+
+      // control frames may come between the fragments of a message, which keeps its type
+      iRxControlOpCode = (opcode & 0x0f);
+
+      if (TYPE_PING == iRxControlOpCode)
+      {
+        // echo the ping data as it arrives
+        iRxPong = (beginMessage(TYPE_PONG, iRxSize) == 0);
+      }
+    }
+
+    // control frame payload, at most 125 bytes
+    uint8_t buffer[125];
+    int     len;
+
+    while ((len = read(buffer, sizeof(buffer))) > 0)
+    {
+      if ( (TYPE_PING == iRxControlOpCode) && iRxPong )
+      {
+        write(buffer, len);
+      }
+    }
+
+    if (iRxSize > 0)
+    {
+      return 0;
+    }
+
+    if (TYPE_CONNECTION_CLOSE == iRxControlOpCode)
+    {
+      iRxControlOpCode = 0;
+      stop();
+
+      return 0;
+    }
+    else if ( (TYPE_PING == iRxControlOpCode) && iRxPong )
+    {
+      endMessage();
+    }
+
+    iRxControlOpCode = 0;
   }
+}
 
-  // read in the mask, if present
-  if (iRxMasked)
+////////////////////////////////////////
+
+bool WiFiWebSocketClient::readFrameHeader()
+{
+  // opcode + length, then the extended length and mask key they announce
+  size_t headerLength = 2;
+
+  while (true)
   {
-    for (int i = 0; i < (int)sizeof(iRxMaskKey); i++)
+    if (iRxHeaderLength >= 2)
     {
-      iRxMaskKey[i] = WiFiHttpClient::read();
+      uint8_t length = iRxHeader[1] & 0x7f;
+
+      headerLength = 2 + ( (length == 126) ? 2 : ( (length == 127) ? 8 : 0 ) ) + ( (iRxHeader[1] & 0x80) ? 4 : 0 );
     }
+
+    if (iRxHeaderLength >= headerLength)
+    {
+      break;
+    }
+
+    int clientAvailable = WiFiHttpClient::available();
+
+    if (clientAvailable <= 0)
+    {
+      return false;
+    }
+
+    int readCount = WiFiHttpClient::read(iRxHeader + iRxHeaderLength,
+                                         min((size_t) clientAvailable, headerLength - iRxHeaderLength));
+
+    if (readCount <= 0)
+    {
+      return false;
+    }
+
+    iRxHeaderLength += readCount;
   }
 
-  iRxMaskIndex = 0;
+  uint8_t length  = iRxHeader[1] & 0x7f;
+  uint8_t* p      = iRxHeader + 2;
 
-  if (TYPE_CONNECTION_CLOSE == messageType())
+  // read the RX size
+  if (length < 126)
   {
-    flushRx();
-    stop();
-    iRxSize = 0;
+    iRxSize = length;
   }
-  else if (TYPE_PING == messageType())
+  else
   {
-    beginMessage(TYPE_PONG);
+    iRxSize = 0;
 
-    while (available())
+    for (int i = (length == 126) ? 2 : 8; i > 0; i--)
     {
-      write(read());
+      iRxSize = (iRxSize << 8) | *p++;
     }
+  }
 
-    endMessage();
+  // read in the mask, if present
+  iRxMasked = (iRxHeader[1] & 0x80);
 
-    iRxSize = 0;
-  }
-  else if (TYPE_PONG == messageType())
+  if (iRxMasked)
   {
-    flushRx();
-    iRxSize = 0;
+    memcpy(iRxMaskKey, p, sizeof(iRxMaskKey));
   }
 
-  return iRxSize;
+  iRxMaskIndex = 0;
+
+  return true;
 }
 
 ////////////////////////////////////////
@@ -350,13 +808,41 @@ String WiFiWebSocketClient::readString()
   int avail = available();
   String s;
 
-  if (avail > 0)
+  if (rxPending())
   {
-    s.reserve(avail);
+    // Reserve once, the message is then appended without reallocation. A
+    // compressed message can only reserve what is decoded so far
+    if ( (avail > 0) && !s.reserve(avail) )
+    {
+      return s;
+    }
+
+    // One more for appendBlock()'s NUL
+    uint8_t buffer[kHttpBodyBlockSize + 1];
+    unsigned long timeoutStart = millis();
 
-    for (int i = 0; i < avail; i++)
+    // the rest of the message may still be on its way
+    while ( rxPending() && ( (millis() - timeoutStart) < _timeout ) )
     {
-      s += (char)read();
+      int len = read(buffer, kHttpBodyBlockSize);
+
+      if (len > 0)
+      {
+        if (!appendBlock(s, (char*) buffer, len))
+        {
+          break;
+        }
+
+        timeoutStart = millis();
+      }
+      else if (!WiFiHttpClient::connected())
+      {
+        break;
+      }
+      else
+      {
+        yield();
+      }
     }
   }
 
@@ -390,16 +876,30 @@ int WiFiWebSocketClient::available()
     return WiFiHttpClient::available();
   }
 
+  if (iRxCompressed && (iRxControlOpCode == 0))
+  {
+    inflateRx();
+
+    return iInflate->available();
+  }
+
   return iRxSize;
 }
 
 ////////////////////////////////////////
 
+bool WiFiWebSocketClient::rxPending()
+{
+  return (iRxSize > 0) || ( iRxCompressed && (iRxControlOpCode == 0) && (available() > 0) );
+}
+
+////////////////////////////////////////
+
 int WiFiWebSocketClient::read()
 {
   byte b;
 
-  if (read(&b, sizeof(b)))
+  if (read(&b, sizeof(b)) == 1)
   {
     return b;
   }
@@ -411,6 +911,54 @@ int WiFiWebSocketClient::read()
 
 int WiFiWebSocketClient::read(uint8_t *aBuffer, size_t aSize)
 {
+  if (iState < eReadingBody)
+  {
+    return WiFiHttpClient::read(aBuffer, aSize);
+  }
+
+  if (iRxCompressed && (iRxControlOpCode == 0))
+  {
+    size_t total = 0;
+
+    while (total < aSize)
+    {
+      inflateRx();
+
+      int len = iInflate->read(aBuffer + total, aSize - total);
+
+      if (len <= 0)
+      {
+        break;
+      }
+
+      total += len;
+    }
+
+    return (total > 0) ? (int) total : -1;
+  }
+
+  return readFrameData(aBuffer, aSize);
+}
+
+////////////////////////////////////////
+
+int WiFiWebSocketClient::readFrameData(uint8_t *aBuffer, size_t aSize)
+{
+  // stay within the current frame, and only take what has arrived
+  int clientAvailable = WiFiHttpClient::available();
+
+  if (clientAvailable <= 0 || iRxSize == 0)
+  {
+    return -1;
+  }
+
+  aSize = min(aSize, (size_t) clientAvailable);
+
+  if (aSize > iRxSize)
+  {
+    aSize = iRxSize;
+  }
+
   int readCount = WiFiHttpClient::read(aBuffer, aSize);
 
   if (readCount > 0)
@@ -420,20 +968,79 @@ int WiFiWebSocketClient::read(uint8_t *aBuffer, size_t aSize)
     // unmask the RX data if needed
     if (iRxMasked)
     {
-      for (int i = 0; i < (int)aSize; i++, iRxMaskIndex++)
+      iRxMaskIndex = maskData(aBuffer, readCount, iRxMaskKey, iRxMaskIndex);
+    }
+  }
+
+  return readCount;
+}
+
+////////////////////////////////////////
+
+void WiFiWebSocketClient::inflateRx()
+{
+  uint8_t buffer[kHttpBodyBlockSize];
+
+  while (iRxSize > 0)
+  {
+    size_t space = iInflate->inputSpace();
+
+    if (space == 0)
+    {
+      // decode to make room, unless the window is full too
+      iInflate->available();
+      space = iInflate->inputSpace();
+
+      if (space == 0)
       {
-        aBuffer[i] ^= iRxMaskKey[iRxMaskIndex % sizeof(iRxMaskKey)];
+        break;
       }
     }
+
+    int len = readFrameData(buffer, min(sizeof(buffer), space));
+
+    if (len <= 0)
+    {
+      break;
+    }
+
+    iInflate->write(buffer, len);
   }
 
-  return readCount;
+  if ( (iRxSize == 0) && isFinal() )
+  {
+    iInflate->finishMessage();
+  }
+
+  if (iInflate->error())
+  {
+    // corrupt stream, the connection can't be trusted any more
+    iRxCompressed = false;
+    stop();
+  }
 }
 
 ////////////////////////////////////////
 
 int WiFiWebSocketClient::peek()
 {
+  if (iState < eReadingBody)
+  {
+    return WiFiHttpClient::peek();
+  }
+
+  if (iRxCompressed && (iRxControlOpCode == 0))
+  {
+    inflateRx();
+
+    return iInflate->peek();
+  }
+
+  if (iRxSize == 0)
+  {
+    return -1;
+  }
+
   int p = WiFiHttpClient::peek();
 
   if (p != -1 && iRxMasked)
@@ -449,11 +1056,14 @@ int WiFiWebSocketClient::peek()
 
 void WiFiWebSocketClient::flushRx()
 {
-  while (available())
+  uint8_t buffer[kHttpBodyBlockSize];
+
+  // only what has arrived, the rest is skipped by the next parseMessage()
+  while (read(buffer, sizeof(buffer)) > 0)
   {
-    read();
   }
 }
 
 ////////////////////////////////////////
 
+#endif    // #if WEBSERVER_SUPPORT_HTTP_CLIENT
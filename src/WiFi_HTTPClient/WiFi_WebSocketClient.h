@@ -47,6 +47,7 @@
 #include "utility/WiFiDebug.h"
 
 #include "WiFi_HTTPClient/WiFi_HttpClient.h"
+#include "WiFi_HTTPClient/WiFi_Deflate.h"
 
 ////////////////////////////////////////
 
@@ -57,6 +58,13 @@ static const int TYPE_CONNECTION_CLOSE = 0x8;
 static const int TYPE_PING             = 0x9;
 static const int TYPE_PONG             = 0xa;
 
+// Payload bytes buffered per frame, see also setTxBuffer(). It sizes the class, which
+// WiFi_WebSocketClient.cpp also uses, so redefine it as a compiler flag (e.g. build_flags).
+// A value set only in the sketch fails to link
+#ifndef kWebSocketTxBufferSize
+  #define kWebSocketTxBufferSize    128
+#endif
+
 ////////////////////////////////////////
 
 class WiFiWebSocketClient : public WiFiHttpClient
@@ -73,6 +81,22 @@ class WiFiWebSocketClient : public WiFiHttpClient
     int begin(const char* aPath = "/");
     int begin(const String& aPath);
 
+    /** Offer permessage-deflate (RFC 7692) in the next begin(). Both windows are
+        2^aWindowBits bytes, allocated by begin() and freed if the server declines:
+        9 or 10 bits suit a SAMD21. Without context takeover every message starts
+        from an empty window, for a worse ratio but no state between messages
+      @param aWindowBits        9 to 15
+    */
+    void enableDeflate(WiFiDeflate& aDeflate, WiFiInflate& aInflate, uint8_t aWindowBits = 10,
+                       bool aContextTakeover = true);
+
+    /** @return true if the server accepted permessage-deflate
+    */
+    bool deflateActive()
+    {
+      return iDeflateActive;
+    }
+
     /** Begin to send a message of type (TYPE_TEXT or TYPE_BINARY)
         Use the write or Stream API's to set message content, followed by endMessage
         to complete the message.
@@ -81,12 +105,31 @@ class WiFiWebSocketClient : public WiFiHttpClient
     */
     int beginMessage(int aType);
 
-    /** Completes sending of a message started by beginMessage
+    /** Begin to send a message of type (TYPE_TEXT or TYPE_BINARY) and known
+        length. The frame header goes out with the first data, then the data
+        is streamed each time the buffer fills. Exactly aLength bytes must be
+        written before endMessage. With deflate active, messages of at least
+        kDeflateMinLength bytes are compressed and sent as fragments instead
+      @return 0 if successful, else error
+    */
+    int beginMessage(int aType, uint64_t aLength);
+
+    /** Completes sending of a message started by beginMessage. Without a known
+        length, a message larger than the buffer has been sent as fragments
+        and this sends the final one
       @return 0 if successful, else error
     */
     int endMessage();
 
-    /** Try to parse an incoming messages
+    /** Use aBuffer, of aSize bytes, instead of the built-in kWebSocketTxBufferSize
+        one. Larger buffers mean fewer, larger frames. 14 bytes are kept for the
+        frame header. NULL goes back to the built-in buffer
+      @return 0 if successful, else error
+    */
+    int setTxBuffer(uint8_t* aBuffer, size_t aSize);
+
+    /** Try to parse an incoming messages. Never waits: a frame header which
+        has only partly arrived is kept and completed by the next call
       @return 0 if no message available, else size of parsed message
     */
     int parseMessage();
@@ -102,7 +145,8 @@ class WiFiWebSocketClient : public WiFiHttpClient
     */
     bool isFinal();
 
-    /** Read the current messages as a string
+    /** Read the current messages as a string, waiting up to the Stream
+        timeout for the rest of it
       @return current message as a string
     */
     String readString();
@@ -128,17 +172,97 @@ class WiFiWebSocketClient : public WiFiHttpClient
   private:
     void flushRx();
 
+    /** Read frame payload, unmasked, as far as it has arrived
+    */
+    int readFrameData(uint8_t *aBuffer, size_t aSize);
+
+    /** Feed the compressed frame payload which has arrived to the inflater
+    */
+    void inflateRx();
+
+    bool rxPending();
+
+    /** Parse one response header line of the upgrade for the negotiated deflate parameters
+    */
+    void acceptDeflate(const String& aHeaderLine);
+
+    /** Append to the payload buffer, sending a fragment each time it fills
+      @return bytes taken
+    */
+    size_t bufferTx(const uint8_t* aBuffer, size_t aSize);
+
+    static void deflateOutput(void* aContext, const uint8_t* aData, size_t aLength);
+
+    /** Read the frame header as far as it has arrived
+      @return true once it is complete, with iRxSize and the mask key set
+    */
+    bool readFrameHeader();
+
+    static size_t frameHeaderLength(uint64_t aPayloadLength);
+
+    /** Send the buffered payload, with a frame header if one is due
+      @param aFinal   Last frame of a message of unknown length
+      @return 0 if successful, else error
+    */
+    int sendTxFrame(bool aFinal);
+
+    /** XOR aData with the mask key, a word at a time where aligned
+      @param aMaskIndex   Key byte for aData[0]
+      @return key byte for the data after aData
+    */
+    static uint8_t maskData(uint8_t* aData, size_t aSize, const uint8_t aMaskKey[4], uint8_t aMaskIndex);
+
   private:
+    // FIN/opcode, length, 64-bit extended length, mask key
+    static const size_t kMaxFrameHeader = 14;
+
+    // Shorter known length messages aren't worth compressing
+    static const uint64_t kDeflateMinLength = 32;
+
     bool      iTxStarted;
     uint8_t   iTxMessageType;
-    uint8_t   iTxBuffer[128];
+    // Room for the frame header, then the payload
+    uint8_t   iTxStaticBuffer[kMaxFrameHeader + kWebSocketTxBufferSize];
+    uint8_t*  iTxBuffer = iTxStaticBuffer;
+    size_t    iTxBufferSize = kWebSocketTxBufferSize;
+    // Payload bytes in iTxBuffer
     uint64_t  iTxSize;
+    // Message length given to beginMessage, and payload bytes sent so far
+    bool      iTxKnownLength = false;
+    uint64_t  iTxLength = 0;
+    uint64_t  iTxSent = 0;
+    // A frame of this message is out: the header of a known length message,
+    // or a fragment of an unknown length one
+    bool      iTxFrameSent = false;
+    uint8_t   iTxMaskKey[4];
+    uint8_t   iTxMaskIndex = 0;
+    // This message goes through the deflater, and a fragment of it failed to send
+    bool      iTxCompressed = false;
+    bool      iTxError = false;
 
     uint8_t   iRxOpCode;
     uint64_t  iRxSize;
     bool      iRxMasked;
-    int       iRxMaskIndex;
+    uint8_t   iRxMaskIndex;
     uint8_t   iRxMaskKey[4];
+    // Frame header bytes read so far
+    uint8_t   iRxHeader[kMaxFrameHeader];
+    uint8_t   iRxHeaderLength;
+    // Control frame being read, and whether its pong is being sent
+    uint8_t   iRxControlOpCode;
+    bool      iRxPong;
+    bool      iRxCompressed = false;
+
+    WiFiDeflate*  iDeflate = NULL;
+    WiFiInflate*  iInflate = NULL;
+    uint8_t       iDeflateWindowBits = 0;
+    bool          iDeflateContextTakeover = true;
+    bool          iDeflateActive = false;
+    // Negotiated *_no_context_takeover: reset the deflater, or inflater, for each message
+    bool          iDeflateClientReset = false;
+    bool          iDeflateServerReset = false;
 };
 
+WS_LAYOUT_CHECK(WiFiWebSocketClient, kWebSocketTxBufferSize);
+
 #endif    // WiFi_WebSocketClient_H
@@ -16,72 +16,26 @@
 
 #include "base64.h"
 
-/* Simple test program
-  #include <stdio.h>
-  void main()
-  {
-    char* in = "amcewen";
-    char out[22];
-
-    b64_encode(in, 15, out, 22);
-    out[21] = '\0';
-
-    printf(out);
-  }
-*/
+#include "utility/Base64Codec.h"
 
 int base64_encode(const unsigned char* aInput, int aInputLen, unsigned char* aOutput, int aOutputLen)
 {
+  int length = WS_BASE64_ENCODED_LENGTH(aInputLen);
+
   // Work out if we've got enough space to encode the input
-  // Every 6 bits of input becomes a byte of output
-  if (aOutputLen < (aInputLen * 8) / 6)
+  if (aOutputLen < length)
   {
     // FIXME Should we return an error here, or just the length
-    return (aInputLen * 8) / 6;
+    return length;
   }
 
-  // If we get here we've got enough space to do the encoding
-
-  const char* b64_dictionary = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-  if (aInputLen == 3)
-  {
-    aOutput[0] = b64_dictionary[aInput[0] >> 2];
-    aOutput[1] = b64_dictionary[(aInput[0] & 0x3) << 4 | (aInput[1] >> 4)];
-    aOutput[2] = b64_dictionary[(aInput[1] & 0x0F) << 2 | (aInput[2] >> 6)];
-    aOutput[3] = b64_dictionary[aInput[2] & 0x3F];
-  }
-  else if (aInputLen == 2)
-  {
-    aOutput[0] = b64_dictionary[aInput[0] >> 2];
-    aOutput[1] = b64_dictionary[(aInput[0] & 0x3) << 4 | (aInput[1] >> 4)];
-    aOutput[2] = b64_dictionary[(aInput[1] & 0x0F) << 2];
-    aOutput[3] = '=';
-  }
-  else if (aInputLen == 1)
-  {
-    aOutput[0] = b64_dictionary[aInput[0] >> 2];
-    aOutput[1] = b64_dictionary[(aInput[0] & 0x3) << 4];
-    aOutput[2] = '=';
-    aOutput[3] = '=';
-  }
-  else
-  {
-    // Break the input into 3-byte chunks and process each of them
-    int i;
+  // Whole groups go straight to aOutput, which may have no room for a NUL terminator
+  WiFiBase64Encoder encoder;
+  char              last[5];
 
-    for (i = 0; i < aInputLen / 3; i++)
-    {
-      base64_encode(&aInput[i * 3], 3, &aOutput[i * 4], 4);
-    }
+  size_t encoded = encoder.update(aInput, aInputLen, (char*) aOutput);
 
-    if (aInputLen % 3 > 0)
-    {
-      // It doesn't fit neatly into a 3-byte chunk, so process what's left
-      base64_encode(&aInput[i * 3], aInputLen % 3, &aOutput[i * 4], aOutputLen - (i * 4));
-    }
-  }
+  memcpy(aOutput + encoded, last, encoder.finish(last));
 
-  return ((aInputLen + 2) / 3) * 4;
+  return length;
 }
-
@@ -0,0 +1,367 @@
+/****************************************************************************************************************************
+  Base64Codec.cpp - Table-driven streaming base64 encoder and decoder
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "Base64Codec.h"
+
+////////////////////////////////////////
+
+static const char kEncode[64] PROGMEM =
+{
+  'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+  'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+  'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+  'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+// 0 - 63 for the alphabet, the flags below for the rest
+#define BASE64_PAD          0x40
+#define BASE64_SPACE        0x41
+#define BASE64_INVALID      0x80
+
+static const uint8_t kDecode[256] PROGMEM =
+{
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x41, 0x41, 0x80, 0x80, 0x41, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x41, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3E, 0x80, 0x80, 0x80, 0x3F,
+  0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80,
+  0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+  0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+  0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+};
+
+////////////////////////////////////////
+
+// 3 bytes to 4 characters, stored as one word
+static inline char* encodeGroup(const uint8_t* aInput, char* aOutput)
+{
+  uint32_t bits = ((uint32_t) aInput[0] << 16) | ((uint32_t) aInput[1] << 8) | aInput[2];
+
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  uint32_t word =   (uint32_t) pgm_read_byte(&kEncode[bits >> 18])
+                  | ((uint32_t) pgm_read_byte(&kEncode[(bits >> 12) & 0x3F]) << 8)
+                  | ((uint32_t) pgm_read_byte(&kEncode[(bits >> 6) & 0x3F]) << 16)
+                  | ((uint32_t) pgm_read_byte(&kEncode[bits & 0x3F]) << 24);
+
+  memcpy(aOutput, &word, sizeof(word));
+#else
+  aOutput[0] = pgm_read_byte(&kEncode[bits >> 18]);
+  aOutput[1] = pgm_read_byte(&kEncode[(bits >> 12) & 0x3F]);
+  aOutput[2] = pgm_read_byte(&kEncode[(bits >> 6) & 0x3F]);
+  aOutput[3] = pgm_read_byte(&kEncode[bits & 0x3F]);
+#endif
+
+  return aOutput + 4;
+}
+
+////////////////////////////////////////
+// WiFiBase64Encoder
+////////////////////////////////////////
+
+WiFiBase64Encoder::WiFiBase64Encoder()
+{
+  reset();
+}
+
+////////////////////////////////////////
+
+void WiFiBase64Encoder::reset()
+{
+  _pendingLength = 0;
+}
+
+////////////////////////////////////////
+
+size_t WiFiBase64Encoder::update(const uint8_t* aInput, size_t aLength, char* aOutput)
+{
+  char* output = aOutput;
+
+  // Complete the group carried over from the last call
+  if (_pendingLength)
+  {
+    while (aLength && (_pendingLength < 3))
+    {
+      _pending[_pendingLength++] = *aInput++;
+      aLength--;
+    }
+
+    if (_pendingLength < 3)
+    {
+      return 0;
+    }
+
+    output = encodeGroup(_pending, output);
+    _pendingLength = 0;
+  }
+
+  // 4 groups, 12 bytes, per pass
+  while (aLength >= 12)
+  {
+    output = encodeGroup(aInput, output);
+    output = encodeGroup(aInput + 3, output);
+    output = encodeGroup(aInput + 6, output);
+    output = encodeGroup(aInput + 9, output);
+
+    aInput  += 12;
+    aLength -= 12;
+  }
+
+  while (aLength >= 3)
+  {
+    output = encodeGroup(aInput, output);
+
+    aInput  += 3;
+    aLength -= 3;
+  }
+
+  while (aLength--)
+  {
+    _pending[_pendingLength++] = *aInput++;
+  }
+
+  return output - aOutput;
+}
+
+////////////////////////////////////////
+
+size_t WiFiBase64Encoder::finish(char* aOutput)
+{
+  size_t length = 0;
+
+  if (_pendingLength)
+  {
+    uint8_t remaining = _pendingLength;
+
+    // Zero bits for the missing bytes, then '=' over the characters they would make
+    memset(_pending + _pendingLength, 0, 3 - _pendingLength);
+    encodeGroup(_pending, aOutput);
+
+    aOutput[3] = '=';
+
+    if (remaining == 1)
+    {
+      aOutput[2] = '=';
+    }
+
+    length = 4;
+  }
+
+  aOutput[length] = '\0';
+  _pendingLength  = 0;
+
+  return length;
+}
+
+////////////////////////////////////////
+
+size_t WiFiBase64Encoder::encode(const uint8_t* aInput, size_t aLength, char* aOutput)
+{
+  WiFiBase64Encoder encoder;
+
+  size_t length = encoder.update(aInput, aLength, aOutput);
+
+  return length + encoder.finish(aOutput + length);
+}
+
+////////////////////////////////////////
+// WiFiBase64Decoder
+////////////////////////////////////////
+
+WiFiBase64Decoder::WiFiBase64Decoder()
+{
+  reset();
+}
+
+////////////////////////////////////////
+
+void WiFiBase64Decoder::reset()
+{
+  _bits     = 0;
+  _count    = 0;
+  _padding  = 0;
+  _error    = false;
+}
+
+////////////////////////////////////////
+
+int WiFiBase64Decoder::update(const char* aInput, size_t aLength, uint8_t* aOutput)
+{
+  if (_error)
+  {
+    return -1;
+  }
+
+  uint8_t* output = aOutput;
+
+  while (aLength)
+  {
+    // Whole groups straight from the input, while nothing is carried over
+    if ( (_count == 0) && (_padding == 0) )
+    {
+      while (aLength >= 4)
+      {
+        uint8_t a = pgm_read_byte(&kDecode[(uint8_t) aInput[0]]);
+        uint8_t b = pgm_read_byte(&kDecode[(uint8_t) aInput[1]]);
+        uint8_t c = pgm_read_byte(&kDecode[(uint8_t) aInput[2]]);
+        uint8_t d = pgm_read_byte(&kDecode[(uint8_t) aInput[3]]);
+
+        // Any padding, whitespace or invalid character sets a flag bit
+        if ((a | b | c | d) & 0xC0)
+        {
+          break;
+        }
+
+        uint32_t bits = ((uint32_t) a << 18) | ((uint32_t) b << 12) | ((uint32_t) c << 6) | d;
+
+        output[0] = bits >> 16;
+        output[1] = bits >> 8;
+        output[2] = bits;
+
+        output  += 3;
+        aInput  += 4;
+        aLength -= 4;
+      }
+
+      if (aLength == 0)
+      {
+        break;
+      }
+    }
+
+    // A character at a time
+    uint8_t value = pgm_read_byte(&kDecode[(uint8_t) *aInput++]);
+
+    aLength--;
+
+    if (value == BASE64_SPACE)
+    {
+      continue;
+    }
+
+    if ( (value == BASE64_INVALID) || ( _padding && (value != BASE64_PAD) ) )
+    {
+      _error = true;
+
+      return -1;
+    }
+
+    if (value == BASE64_PAD)
+    {
+      // Only after 2 or 3 characters of a group, to fill it
+      if ( (_count < 2) || (_count + _padding >= 4) )
+      {
+        _error = true;
+
+        return -1;
+      }
+
+      _padding++;
+
+      if (_count + _padding == 4)
+      {
+        // 12 or 18 bits, to 1 or 2 bytes
+        if (_count == 2)
+        {
+          *output++ = _bits >> 4;
+        }
+        else
+        {
+          *output++ = _bits >> 10;
+          *output++ = _bits >> 2;
+        }
+
+        _bits  = 0;
+        _count = 0;
+      }
+
+      continue;
+    }
+
+    _bits = (_bits << 6) | value;
+
+    if (++_count == 4)
+    {
+      output[0] = _bits >> 16;
+      output[1] = _bits >> 8;
+      output[2] = _bits;
+
+      output += 3;
+      _bits   = 0;
+      _count  = 0;
+    }
+  }
+
+  return output - aOutput;
+}
+
+////////////////////////////////////////
+
+int WiFiBase64Decoder::finish(uint8_t* aOutput)
+{
+  int length = 0;
+
+  if ( _error || (_count == 1) || (_padding && _count) )
+  {
+    length = -1;
+  }
+  else if (_count == 2)
+  {
+    aOutput[0] = _bits >> 4;
+    length = 1;
+  }
+  else if (_count == 3)
+  {
+    aOutput[0] = _bits >> 10;
+    aOutput[1] = _bits >> 2;
+    length = 2;
+  }
+
+  reset();
+
+  return length;
+}
+
+////////////////////////////////////////
+
+int WiFiBase64Decoder::decode(const char* aInput, size_t aLength, uint8_t* aOutput)
+{
+  WiFiBase64Decoder decoder;
+
+  int length = decoder.update(aInput, aLength, aOutput);
+
+  if (length < 0)
+  {
+    return -1;
+  }
+
+  int last = decoder.finish(aOutput + length);
+
+  return (last < 0) ? -1 : (length + last);
+}
+
+////////////////////////////////////////
@@ -0,0 +1,105 @@
+/****************************************************************************************************************************
+  Base64Codec.h - Table-driven streaming base64 encoder and decoder
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef Base64Codec_H
+#define Base64Codec_H
+
+#include <Arduino.h>
+
+////////////////////////////////////////
+
+// Output sizes, without a NUL terminator
+#define WS_BASE64_ENCODED_LENGTH(n)     ((((n) + 2) / 3) * 4)
+#define WS_BASE64_DECODED_LENGTH(n)     ((((n) + 3) / 4) * 3)
+
+////////////////////////////////////////
+
+// Encodes 3 bytes to 4 characters per step, never recursing. update() may be called any
+// number of times, a partial group is carried over to the next call
+class WiFiBase64Encoder
+{
+  public:
+
+    WiFiBase64Encoder();
+
+    void reset();
+
+    /** Encode aLength bytes
+      @return characters written to aOutput, at most WS_BASE64_ENCODED_LENGTH(aLength + 2)
+    */
+    size_t update(const uint8_t* aInput, size_t aLength, char* aOutput);
+
+    /** Encode the carried over bytes with '=' padding. aOutput is NUL terminated
+      @return characters written, 0 or 4, without the NUL
+    */
+    size_t finish(char* aOutput);
+
+    /** One shot encode, aOutput needs WS_BASE64_ENCODED_LENGTH(aLength) + 1 characters
+      @return length of the NUL terminated result
+    */
+    static size_t encode(const uint8_t* aInput, size_t aLength, char* aOutput);
+
+  private:
+
+    uint8_t _pending[3];
+    uint8_t _pendingLength;
+};
+
+////////////////////////////////////////
+
+// Decodes 4 characters to 3 bytes per step through a 256 entry table. Whitespace is
+// skipped and padding is optional. update() may be called any number of times
+class WiFiBase64Decoder
+{
+  public:
+
+    WiFiBase64Decoder();
+
+    void reset();
+
+    /** Decode aLength characters
+      @return bytes written to aOutput, at most WS_BASE64_DECODED_LENGTH(aLength + 3),
+              -1 on an invalid character or data after the padding
+    */
+    int update(const char* aInput, size_t aLength, uint8_t* aOutput);
+
+    /** Decode the carried over characters of unpadded input
+      @return bytes written, 0 to 2, -1 if the input was cut short
+    */
+    int finish(uint8_t* aOutput);
+
+    /** One shot decode, aOutput needs WS_BASE64_DECODED_LENGTH(aLength) bytes
+      @return decoded length, -1 on invalid input
+    */
+    static int decode(const char* aInput, size_t aLength, uint8_t* aOutput);
+
+  private:
+
+    uint32_t  _bits;
+    uint8_t   _count;
+    uint8_t   _padding;
+    bool      _error;
+};
+
+////////////////////////////////////////
+
+#endif    // Base64Codec_H
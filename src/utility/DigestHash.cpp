@@ -0,0 +1,318 @@
+/****************************************************************************************************************************
+  DigestHash.cpp - MD5 and SHA-256 for HTTP Digest authentication
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "DigestHash.h"
+
+////////////////////////////////////////
+
+static const uint32_t kMd5Sine[64] PROGMEM =
+{
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+// Rotations of each round, 4 per round
+static const uint8_t kMd5Shift[16] PROGMEM =
+{
+  7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21
+};
+
+static const uint32_t kSha256Round[64] PROGMEM =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t rotateLeft(uint32_t value, uint8_t bits)
+{
+  return (value << bits) | (value >> (32 - bits));
+}
+
+static inline uint32_t rotateRight(uint32_t value, uint8_t bits)
+{
+  return (value >> bits) | (value << (32 - bits));
+}
+
+////////////////////////////////////////
+
+WiFiDigestHash::WiFiDigestHash(uint8_t algorithm)
+{
+  begin(algorithm);
+}
+
+////////////////////////////////////////
+
+void WiFiDigestHash::begin(uint8_t algorithm)
+{
+  _algorithm    = algorithm;
+  _bufferLength = 0;
+  _length       = 0;
+
+  if (_algorithm == HASH_SHA256)
+  {
+    _state[0] = 0x6a09e667;
+    _state[1] = 0xbb67ae85;
+    _state[2] = 0x3c6ef372;
+    _state[3] = 0xa54ff53a;
+    _state[4] = 0x510e527f;
+    _state[5] = 0x9b05688c;
+    _state[6] = 0x1f83d9ab;
+    _state[7] = 0x5be0cd19;
+  }
+  else
+  {
+    _state[0] = 0x67452301;
+    _state[1] = 0xefcdab89;
+    _state[2] = 0x98badcfe;
+    _state[3] = 0x10325476;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiDigestHash::update(const void* data, size_t length)
+{
+  const uint8_t* input = (const uint8_t*) data;
+
+  _length += length;
+
+  while (length)
+  {
+    // Whole blocks straight from the input
+    if ( (_bufferLength == 0) && (length >= sizeof(_buffer)) )
+    {
+      _transform(input);
+
+      input  += sizeof(_buffer);
+      length -= sizeof(_buffer);
+
+      continue;
+    }
+
+    size_t count = min(length, sizeof(_buffer) - _bufferLength);
+
+    memcpy(_buffer + _bufferLength, input, count);
+
+    _bufferLength += count;
+    input         += count;
+    length        -= count;
+
+    if (_bufferLength == sizeof(_buffer))
+    {
+      _transform(_buffer);
+      _bufferLength = 0;
+    }
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiDigestHash::finish(uint8_t* digest)
+{
+  uint64_t bits = _length * 8;
+
+  // 0x80, zeros up to 56 bytes into the block, then the length in bits
+  _buffer[_bufferLength++] = 0x80;
+
+  if (_bufferLength > 56)
+  {
+    memset(_buffer + _bufferLength, 0, sizeof(_buffer) - _bufferLength);
+    _transform(_buffer);
+    _bufferLength = 0;
+  }
+
+  memset(_buffer + _bufferLength, 0, 56 - _bufferLength);
+
+  // MD5 is little endian, SHA-256 big endian
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    _buffer[(_algorithm == HASH_SHA256) ? (63 - i) : (56 + i)] = bits >> (8 * i);
+  }
+
+  _transform(_buffer);
+
+  for (uint8_t i = 0; i < size() / 4; i++)
+  {
+    for (uint8_t j = 0; j < 4; j++)
+    {
+      digest[4 * i + j] = _state[i] >> ( (_algorithm == HASH_SHA256) ? (24 - 8 * j) : (8 * j) );
+    }
+  }
+
+  begin(_algorithm);
+}
+
+////////////////////////////////////////
+
+void WiFiDigestHash::finishHex(char* hex)
+{
+  uint8_t digest[WS_DIGEST_MAX_SIZE];
+  uint8_t length = size();
+
+  finish(digest);
+  toHex(digest, length, hex);
+}
+
+////////////////////////////////////////
+
+void WiFiDigestHash::toHex(const uint8_t* digest, uint8_t length, char* hex)
+{
+  static const char kHex[] = "0123456789abcdef";
+
+  for (uint8_t i = 0; i < length; i++)
+  {
+    *hex++ = kHex[digest[i] >> 4];
+    *hex++ = kHex[digest[i] & 0x0f];
+  }
+
+  *hex = '\0';
+}
+
+////////////////////////////////////////
+
+void WiFiDigestHash::_transform(const uint8_t* block)
+{
+  if (_algorithm == HASH_SHA256)
+    _transformSha256(block);
+  else
+    _transformMd5(block);
+}
+
+////////////////////////////////////////
+
+void WiFiDigestHash::_transformMd5(const uint8_t* block)
+{
+  uint32_t words[16];
+
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    words[i] =    (uint32_t) block[4 * i] | ((uint32_t) block[4 * i + 1] << 8)
+                  | ((uint32_t) block[4 * i + 2] << 16) | ((uint32_t) block[4 * i + 3] << 24);
+  }
+
+  uint32_t a = _state[0];
+  uint32_t b = _state[1];
+  uint32_t c = _state[2];
+  uint32_t d = _state[3];
+
+  for (uint8_t i = 0; i < 64; i++)
+  {
+    uint32_t f;
+    uint8_t  g;
+
+    switch (i >> 4)
+    {
+      case 0:
+        f = (b & c) | (~b & d);
+        g = i;
+        break;
+
+      case 1:
+        f = (d & b) | (~d & c);
+        g = (5 * i + 1) & 15;
+        break;
+
+      case 2:
+        f = b ^ c ^ d;
+        g = (3 * i + 5) & 15;
+        break;
+
+      default:
+        f = c ^ (b | ~d);
+        g = (7 * i) & 15;
+        break;
+    }
+
+    f = f + a + pgm_read_dword(&kMd5Sine[i]) + words[g];
+    a = d;
+    d = c;
+    c = b;
+    b = b + rotateLeft(f, pgm_read_byte(&kMd5Shift[((i >> 4) << 2) | (i & 3)]));
+  }
+
+  _state[0] += a;
+  _state[1] += b;
+  _state[2] += c;
+  _state[3] += d;
+}
+
+////////////////////////////////////////
+
+void WiFiDigestHash::_transformSha256(const uint8_t* block)
+{
+  // Message schedule kept as a 16 word ring
+  uint32_t words[16];
+
+  for (uint8_t i = 0; i < 16; i++)
+  {
+    words[i] =    ((uint32_t) block[4 * i] << 24) | ((uint32_t) block[4 * i + 1] << 16)
+                  | ((uint32_t) block[4 * i + 2] << 8) | (uint32_t) block[4 * i + 3];
+  }
+
+  uint32_t s[8];
+
+  memcpy(s, _state, sizeof(s));
+
+  for (uint8_t i = 0; i < 64; i++)
+  {
+    if (i >= 16)
+    {
+      uint32_t w15 = words[(i + 1) & 15];
+      uint32_t w2  = words[(i + 14) & 15];
+
+      words[i & 15] += (rotateRight(w15, 7) ^ rotateRight(w15, 18) ^ (w15 >> 3))
+                       + words[(i + 9) & 15]
+                       + (rotateRight(w2, 17) ^ rotateRight(w2, 19) ^ (w2 >> 10));
+    }
+
+    uint32_t t1 = s[7] + (rotateRight(s[4], 6) ^ rotateRight(s[4], 11) ^ rotateRight(s[4], 25))
+                  + ((s[4] & s[5]) ^ (~s[4] & s[6])) + pgm_read_dword(&kSha256Round[i]) + words[i & 15];
+    uint32_t t2 = (rotateRight(s[0], 2) ^ rotateRight(s[0], 13) ^ rotateRight(s[0], 22))
+                  + ((s[0] & s[1]) ^ (s[0] & s[2]) ^ (s[1] & s[2]));
+
+    s[7] = s[6];
+    s[6] = s[5];
+    s[5] = s[4];
+    s[4] = s[3] + t1;
+    s[3] = s[2];
+    s[2] = s[1];
+    s[1] = s[0];
+    s[0] = t1 + t2;
+  }
+
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    _state[i] += s[i];
+  }
+}
+
+////////////////////////////////////////
@@ -0,0 +1,85 @@
+/****************************************************************************************************************************
+  DigestHash.h - MD5 and SHA-256 for HTTP Digest authentication
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef DigestHash_H
+#define DigestHash_H
+
+#include <Arduino.h>
+
+////////////////////////////////////////
+
+#define WS_DIGEST_MAX_SIZE      32
+
+////////////////////////////////////////
+
+// Streaming MD5 (RFC 1321) or SHA-256 (FIPS 180-4), one 64 byte block at a time.
+// About 110 bytes of state, nothing allocated
+class WiFiDigestHash
+{
+  public:
+
+    enum
+    {
+      HASH_MD5,
+      HASH_SHA256
+    };
+
+    WiFiDigestHash(uint8_t algorithm = HASH_MD5);
+
+    void begin(uint8_t algorithm);
+
+    void update(const void* data, size_t length);
+
+    inline void update(const char* str)
+    {
+      update(str, strlen(str));
+    }
+
+    // Writes size() bytes and starts over with the same algorithm
+    void finish(uint8_t* digest);
+
+    // Digest as lowercase hex, 2 * size() characters and a NUL
+    void finishHex(char* hex);
+
+    inline uint8_t size() const
+    {
+      return (_algorithm == HASH_SHA256) ? 32 : 16;
+    }
+
+    static void toHex(const uint8_t* digest, uint8_t length, char* hex);
+
+  private:
+
+    void _transform(const uint8_t* block);
+    void _transformMd5(const uint8_t* block);
+    void _transformSha256(const uint8_t* block);
+
+    uint8_t   _algorithm;
+    uint8_t   _bufferLength;
+    uint32_t  _state[8];
+    uint64_t  _length;
+    uint8_t   _buffer[64];
+};
+
+////////////////////////////////////////
+
+#endif    // DigestHash_H
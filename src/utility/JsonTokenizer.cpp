@@ -0,0 +1,611 @@
+/****************************************************************************************************************************
+  JsonTokenizer.cpp - Fixed-memory streaming JSON tokenizer for request bodies
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "JsonTokenizer.h"
+
+#include <Arduino.h>
+
+WS_LAYOUT_DEFINE(WiFiJsonTokenizer, WS_JSON_MAX_PATH_LEN, WS_JSON_MAX_VALUE_LEN, WS_JSON_MAX_DEPTH);
+
+////////////////////////////////////////
+
+WiFiJsonTokenizer::WiFiJsonTokenizer(TJsonValueCallback callback, void* context)
+  : _callback(callback)
+  , _context(context)
+{
+  reset();
+}
+
+////////////////////////////////////////
+
+void WiFiJsonTokenizer::setCallback(TJsonValueCallback callback, void* context)
+{
+  _callback = callback;
+  _context  = context;
+}
+
+////////////////////////////////////////
+
+void WiFiJsonTokenizer::reset()
+{
+  _state          = JS_VALUE;
+  _depth          = 0;
+  _isKey          = false;
+  _truncated      = false;
+  _arrayMask      = 0;
+  _unicode        = 0;
+  _unicodeDigits  = 0;
+  _highSurrogate  = 0;
+  _number         = NUM_INT;
+  _pathLen[0]     = 0;
+  _path[0]        = 0;
+  _valueLen       = 0;
+  _value[0]       = 0;
+}
+
+////////////////////////////////////////
+
+bool WiFiJsonTokenizer::write(const char* data, size_t len)
+{
+  while (len--)
+  {
+    if (!_step(*data++))
+    {
+      _state = JS_ERROR;
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+bool WiFiJsonTokenizer::write(char c)
+{
+  return write(&c, 1);
+}
+
+////////////////////////////////////////
+
+bool WiFiJsonTokenizer::finish()
+{
+  if ( ((_state == JS_NUMBER) || (_state == JS_LITERAL)) && (_depth == 0) )
+  {
+    // Top-level number or literal has no terminating character
+    _step(' ');
+  }
+
+  return (_state == JS_DONE);
+}
+
+////////////////////////////////////////
+
+bool WiFiJsonTokenizer::_step(char c)
+{
+  switch (_state)
+  {
+    case JS_STRING:
+      if (c != '\\')
+        _endSurrogate();
+
+      if (c == '"')
+      {
+        if (_isKey)
+        {
+          _isKey = false;
+          _state = JS_COLON;
+        }
+        else
+        {
+          _emit();
+          _afterValue();
+        }
+      }
+      else if (c == '\\')
+      {
+        _state = JS_ESCAPE;
+      }
+      else if ((uint8_t) c < 0x20)
+      {
+        // Raw control characters must be escaped
+        return false;
+      }
+      else
+      {
+        _putChar(c);
+      }
+
+      break;
+
+    case JS_ESCAPE:
+      _state = JS_STRING;
+
+      if (c != 'u')
+        _endSurrogate();
+
+      switch (c)
+      {
+        case 'b':
+          _putChar('\b');
+          break;
+
+        case 'f':
+          _putChar('\f');
+          break;
+
+        case 'n':
+          _putChar('\n');
+          break;
+
+        case 'r':
+          _putChar('\r');
+          break;
+
+        case 't':
+          _putChar('\t');
+          break;
+
+        case 'u':
+          _unicode        = 0;
+          _unicodeDigits  = 0;
+          _state          = JS_UNICODE;
+          break;
+
+        case '"':
+        case '\\':
+        case '/':
+          _putChar(c);
+          break;
+
+        default:
+          return false;
+      }
+
+      break;
+
+    case JS_UNICODE:
+      if (!isHexadecimalDigit(c))
+        return false;
+
+      _unicode = (_unicode << 4) | ( (c <= '9') ? (c - '0') : ((c | 0x20) - 'a' + 10) );
+
+      if (++_unicodeDigits == 4)
+      {
+        _state = JS_STRING;
+
+        if ( (_unicode >= 0xDC00) && (_unicode <= 0xDFFF) && _highSurrogate )
+        {
+          _putCodepoint(0x10000 + ( ((uint32_t) (_highSurrogate - 0xD800) << 10) | (_unicode - 0xDC00) ));
+          _highSurrogate = 0;
+        }
+        else
+        {
+          _endSurrogate();
+
+          if ( (_unicode >= 0xD800) && (_unicode <= 0xDBFF) )
+          {
+            // High surrogate, wait for the low half
+            _highSurrogate = _unicode;
+          }
+          else
+          {
+            _putCodepoint(_unicode);
+          }
+        }
+      }
+
+      break;
+
+    case JS_NUMBER:
+      if (_stepNumber(c))
+      {
+        _putChar(c);
+      }
+      else
+      {
+        // Only a number which can end here is valid, then let the delimiter be processed normally
+        if ( (_number != NUM_ZERO) && (_number != NUM_INT) && (_number != NUM_FRAC) && (_number != NUM_EXP) )
+          return false;
+
+        _emit();
+        _afterValue();
+
+        return _step(c);
+      }
+
+      break;
+
+    case JS_LITERAL:
+      if (isAlpha(c))
+      {
+        _putChar(c);
+      }
+      else
+      {
+        // Validate the completed literal, then let the delimiter be processed normally
+        if ( strcmp(_value, "true") && strcmp(_value, "false") && strcmp(_value, "null") )
+          return false;
+
+        _emit();
+        _afterValue();
+
+        return _step(c);
+      }
+
+      break;
+
+    default:
+      if ( (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') )
+        break;
+
+      switch (_state)
+      {
+        case JS_VALUE_OR_END:
+          if (c == ']')
+            return _endContainer(true);
+
+        // fall through
+
+        case JS_VALUE:
+          _valueLen = 0;
+          _value[0] = 0;
+
+          if (c == '{')
+          {
+            return _beginContainer(false);
+          }
+          else if (c == '[')
+          {
+            return _beginContainer(true);
+          }
+          else if (c == '"')
+          {
+            _isKey = false;
+            _state = JS_STRING;
+          }
+          else if ( isDigit(c) || (c == '-') )
+          {
+            _state  = JS_NUMBER;
+            _number = NUM_START;
+            _stepNumber(c);
+            _putChar(c);
+          }
+          else if (isAlpha(c))
+          {
+            _state = JS_LITERAL;
+            _putChar(c);
+          }
+          else
+          {
+            return false;
+          }
+
+          break;
+
+        case JS_KEY_OR_END:
+          if (c == '}')
+            return _endContainer(false);
+
+        // fall through
+
+        case JS_KEY:
+          if (c != '"')
+            return false;
+
+          // Nested keys are joined with '.' to the path of the enclosing object
+          if (_pathLen[_depth] == 0)
+          {
+            _path[0] = 0;
+          }
+          else if (_pathLen[_depth] < WS_JSON_MAX_PATH_LEN)
+          {
+            _path[_pathLen[_depth]]     = '.';
+            _path[_pathLen[_depth] + 1] = 0;
+          }
+          else
+          {
+            return false;
+          }
+
+          _isKey = true;
+          _state = JS_STRING;
+
+          break;
+
+        case JS_COLON:
+          if (c != ':')
+            return false;
+
+          _state = JS_VALUE;
+
+          break;
+
+        case JS_COMMA_OR_END:
+          if (c == ',')
+          {
+            if (_inArray())
+            {
+              _index[_depth - 1]++;
+              _state = JS_VALUE;
+            }
+            else
+            {
+              _state = JS_KEY;
+            }
+          }
+          else if ( (c == '}') || (c == ']') )
+          {
+            return _endContainer(c == ']');
+          }
+          else
+          {
+            return false;
+          }
+
+          break;
+
+        default:
+          // JS_DONE accepts trailing whitespace only, JS_ERROR accepts nothing
+          return false;
+      }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////
+
+// -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?, one character at a time.
+// Returns false if c does not continue the number
+bool WiFiJsonTokenizer::_stepNumber(char c)
+{
+  switch (_number)
+  {
+    case NUM_START:
+      if (c == '-')
+      {
+        _number = NUM_SIGN;
+
+        return true;
+      }
+
+    // fall through
+
+    case NUM_SIGN:
+      if (isDigit(c))
+      {
+        _number = (c == '0') ? NUM_ZERO : NUM_INT;
+
+        return true;
+      }
+
+      break;
+
+    case NUM_INT:
+      if (isDigit(c))
+        return true;
+
+    // fall through
+
+    case NUM_ZERO:
+      if (c == '.')
+      {
+        _number = NUM_FRAC_START;
+
+        return true;
+      }
+
+      if ( (c == 'e') || (c == 'E') )
+      {
+        _number = NUM_EXP_START;
+
+        return true;
+      }
+
+      // A digit after a leading zero is never valid, don't let it end the number
+      if (isDigit(c))
+        _number = NUM_ERROR;
+
+      break;
+
+    case NUM_FRAC_START:
+    case NUM_FRAC:
+      if (isDigit(c))
+      {
+        _number = NUM_FRAC;
+
+        return true;
+      }
+
+      if ( (_number == NUM_FRAC) && ((c == 'e') || (c == 'E')) )
+      {
+        _number = NUM_EXP_START;
+
+        return true;
+      }
+
+      break;
+
+    case NUM_EXP_START:
+      if ( (c == '+') || (c == '-') )
+      {
+        _number = NUM_EXP_SIGN;
+
+        return true;
+      }
+
+    // fall through
+
+    case NUM_EXP_SIGN:
+    case NUM_EXP:
+      if (isDigit(c))
+      {
+        _number = NUM_EXP;
+
+        return true;
+      }
+
+      break;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////
+
+bool WiFiJsonTokenizer::_beginContainer(bool isArray)
+{
+  if (_depth >= WS_JSON_MAX_DEPTH)
+    return false;
+
+  if (isArray)
+    _arrayMask |= (1u << _depth);
+  else
+    _arrayMask &= ~(1u << _depth);
+
+  _index[_depth]  = 0;
+  _depth++;
+  _pathLen[_depth] = strlen(_path);
+  _state = isArray ? JS_VALUE_OR_END : JS_KEY_OR_END;
+
+  return true;
+}
+
+////////////////////////////////////////
+
+bool WiFiJsonTokenizer::_endContainer(bool isArray)
+{
+  if ( (_depth == 0) || (_inArray() != isArray) )
+    return false;
+
+  // Back to the key path which led into this container
+  _path[_pathLen[_depth]] = 0;
+  _depth--;
+  _afterValue();
+
+  return true;
+}
+
+////////////////////////////////////////
+
+void WiFiJsonTokenizer::_afterValue()
+{
+  _state = (_depth == 0) ? JS_DONE : JS_COMMA_OR_END;
+}
+
+////////////////////////////////////////
+
+void WiFiJsonTokenizer::_emit()
+{
+  int index = -1;
+
+  for (int d = _depth; d > 0; d--)
+  {
+    if (_arrayMask & (1u << (d - 1)))
+    {
+      index = _index[d - 1];
+      break;
+    }
+  }
+
+  if (_callback)
+    _callback(_context, _path, index, _value);
+
+  _valueLen = 0;
+  _value[0] = 0;
+}
+
+////////////////////////////////////////
+
+void WiFiJsonTokenizer::_putChar(char c)
+{
+  if (_isKey)
+  {
+    size_t len = strlen(_path);
+
+    if (len < WS_JSON_MAX_PATH_LEN)
+    {
+      _path[len]      = c;
+      _path[len + 1]  = 0;
+    }
+    else
+    {
+      // Key path too long, an arg with a cut name would be misleading
+      _state = JS_ERROR;
+    }
+  }
+  else if (_valueLen < WS_JSON_MAX_VALUE_LEN)
+  {
+    _value[_valueLen++] = c;
+    _value[_valueLen]   = 0;
+  }
+  else
+  {
+    _truncated = true;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiJsonTokenizer::_endSurrogate()
+{
+  // A high surrogate not followed by \uDC00-\uDFFF is emitted on its own, as U+FFFD
+  if (_highSurrogate)
+  {
+    _putCodepoint(_highSurrogate);
+    _highSurrogate = 0;
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiJsonTokenizer::_putCodepoint(uint32_t cp)
+{
+  // Lone surrogates become U+FFFD
+  if ( (cp >= 0xD800) && (cp <= 0xDFFF) )
+    cp = 0xFFFD;
+
+  if (cp < 0x80)
+  {
+    _putChar((char) cp);
+  }
+  else if (cp < 0x800)
+  {
+    _putChar((char) (0xC0 | (cp >> 6)));
+    _putChar((char) (0x80 | (cp & 0x3F)));
+  }
+  else if (cp < 0x10000)
+  {
+    _putChar((char) (0xE0 | (cp >> 12)));
+    _putChar((char) (0x80 | ((cp >> 6) & 0x3F)));
+    _putChar((char) (0x80 | (cp & 0x3F)));
+  }
+  else
+  {
+    _putChar((char) (0xF0 | (cp >> 18)));
+    _putChar((char) (0x80 | ((cp >> 12) & 0x3F)));
+    _putChar((char) (0x80 | ((cp >> 6) & 0x3F)));
+    _putChar((char) (0x80 | (cp & 0x3F)));
+  }
+}
+
+////////////////////////////////////////
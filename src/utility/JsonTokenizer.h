@@ -0,0 +1,184 @@
+/****************************************************************************************************************************
+  JsonTokenizer.h - Fixed-memory streaming JSON tokenizer for request bodies
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef JsonTokenizer_H
+#define JsonTokenizer_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "WiFiLayout.h"
+
+////////////////////////////////////////
+
+// The sizes below are compiled into JsonTokenizer.cpp too, so redefine them
+// as compiler flags (e.g. build_flags). Set in the sketch only, they fail to link
+
+// Dotted path of nested keys, e.g. "config.wifi.ssid"
+#ifndef WS_JSON_MAX_PATH_LEN
+  #define WS_JSON_MAX_PATH_LEN        64
+#endif
+
+// Longest scalar value kept. Longer values are truncated
+#ifndef WS_JSON_MAX_VALUE_LEN
+  #define WS_JSON_MAX_VALUE_LEN       64
+#endif
+
+// Max nesting of objects / arrays, up to 16
+#ifndef WS_JSON_MAX_DEPTH
+  #define WS_JSON_MAX_DEPTH           8
+#elif (WS_JSON_MAX_DEPTH > 16)
+  #undef WS_JSON_MAX_DEPTH
+  #define WS_JSON_MAX_DEPTH           16
+#endif
+
+////////////////////////////////////////
+
+// Called once per scalar (string, number, true, false, null)
+// path  : dotted key path, "" for a top-level scalar
+// index : index in the innermost enclosing array, or -1 if not inside an array
+// value : unescaped, NUL-terminated value text
+typedef void (*TJsonValueCallback)(void* context, const char* path, int index, const char* value);
+
+////////////////////////////////////////
+
+class WiFiJsonTokenizer
+{
+  public:
+
+    WiFiJsonTokenizer(TJsonValueCallback callback = nullptr, void* context = nullptr);
+
+    void setCallback(TJsonValueCallback callback, void* context);
+
+    // Prepare for a new document
+    void reset();
+
+    // Feed the next block of the document. Returns false once a syntax error has been seen
+    bool write(const char* data, size_t len);
+    bool write(char c);
+
+    // End of input, flushes a pending top-level number. Returns true if the document was complete and valid
+    bool finish();
+
+    ////////////////////////////////////////
+
+    inline bool hasError()
+    {
+      return (_state == JS_ERROR);
+    }
+
+    ////////////////////////////////////////
+
+    inline bool isDone()
+    {
+      return (_state == JS_DONE);
+    }
+
+    ////////////////////////////////////////
+
+    // True if any value was cut to WS_JSON_MAX_VALUE_LEN
+    inline bool truncated()
+    {
+      return _truncated;
+    }
+
+    ////////////////////////////////////////
+
+  private:
+
+    enum
+    {
+      JS_VALUE,             // expecting a value
+      JS_KEY_OR_END,        // just after '{'
+      JS_VALUE_OR_END,      // just after '['
+      JS_KEY,               // after ',' inside an object
+      JS_COLON,
+      JS_COMMA_OR_END,
+      JS_STRING,
+      JS_ESCAPE,
+      JS_UNICODE,
+      JS_NUMBER,
+      JS_LITERAL,           // true, false or null
+      JS_DONE,
+      JS_ERROR
+    };
+
+    // Position inside a number
+    enum
+    {
+      NUM_START,
+      NUM_SIGN,             // after '-'
+      NUM_ZERO,             // leading '0', no more integer digits
+      NUM_INT,
+      NUM_FRAC_START,       // after '.'
+      NUM_FRAC,
+      NUM_EXP_START,        // after 'e' / 'E'
+      NUM_EXP_SIGN,
+      NUM_EXP,
+      NUM_ERROR
+    };
+
+    bool _step(char c);
+    bool _stepNumber(char c);
+    bool _beginContainer(bool isArray);
+    bool _endContainer(bool isArray);
+    void _afterValue();
+    void _emit();
+    void _putChar(char c);
+    void _endSurrogate();
+    void _putCodepoint(uint32_t cp);
+
+    ////////////////////////////////////////
+
+    inline bool _inArray()
+    {
+      return (_depth > 0) && (_arrayMask & (1u << (_depth - 1)));
+    }
+
+    ////////////////////////////////////////
+
+    TJsonValueCallback  _callback;
+    void*               _context;
+
+    uint8_t   _state;
+    uint8_t   _depth;
+    bool      _isKey;
+    bool      _truncated;
+    uint16_t  _arrayMask;               // bit n set => container at depth n+1 is an array
+    uint16_t  _unicode;
+    uint8_t   _unicodeDigits;
+    uint16_t  _highSurrogate;
+    uint8_t   _number;
+
+    uint16_t  _index[WS_JSON_MAX_DEPTH];
+    uint16_t  _pathLen[WS_JSON_MAX_DEPTH + 1];
+    char      _path[WS_JSON_MAX_PATH_LEN + 1];
+
+    uint16_t  _valueLen;
+    char      _value[WS_JSON_MAX_VALUE_LEN + 1];
+};
+
+WS_LAYOUT_CHECK(WiFiJsonTokenizer, WS_JSON_MAX_PATH_LEN, WS_JSON_MAX_VALUE_LEN, WS_JSON_MAX_DEPTH);
+
+////////////////////////////////////////
+
+#endif    // JsonTokenizer_H
@@ -0,0 +1,386 @@
+/****************************************************************************************************************************
+  JsonWriter.cpp - Streaming JSON writer for responses
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "JsonWriter.h"
+
+////////////////////////////////////////
+
+WiFiJsonWriter::WiFiJsonWriter(Print& out)
+  : _out(out)
+  , _depth(0)
+  , _afterKey(false)
+  , _hasItems(0)
+{
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::beginObject()
+{
+  _begin('{');
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::endObject()
+{
+  _end('}');
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::beginArray()
+{
+  _begin('[');
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::endArray()
+{
+  _end(']');
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::key(const char* name)
+{
+  _separator();
+  _string(name, false);
+  _out.write(':');
+  _afterKey = true;
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::key(const __FlashStringHelper* name)
+{
+  _separator();
+  _string((const char*) name, true);
+  _out.write(':');
+  _afterKey = true;
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(const char* str)
+{
+  if (!str)
+    return null();
+
+  _separator();
+  _string(str, false);
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(const __FlashStringHelper* str)
+{
+  if (!str)
+    return null();
+
+  _separator();
+  _string((const char*) str, true);
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(const String& str)
+{
+  return value(str.c_str());
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(bool b)
+{
+  _separator();
+
+  if (b)
+    _out.write((const uint8_t*) "true", 4);
+  else
+    _out.write((const uint8_t*) "false", 5);
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(int n)
+{
+  return value((long) n);
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(unsigned int n)
+{
+  return value((unsigned long) n);
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(long n)
+{
+  _separator();
+
+  // Negate as unsigned, so LONG_MIN is fine
+  if (n < 0)
+    _unsigned(0UL - (unsigned long) n, true);
+  else
+    _unsigned((unsigned long) n, false);
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(unsigned long n)
+{
+  _separator();
+  _unsigned(n, false);
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::value(double d, uint8_t decimals)
+{
+  static const uint32_t pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+  // Also catches values which don't fit in the integer part
+  if ( isnan(d) || isinf(d) || (d > 4294967295.0) || (d < -4294967295.0) )
+    return null();
+
+  if (decimals > 6)
+    decimals = 6;
+
+  _separator();
+
+  bool negative = (d < 0);
+
+  if (negative)
+    d = -d;
+
+  // Round once, then split into integer and fraction
+  d += 0.5 / pow10[decimals];
+
+  if (d > 4294967295.0)
+    d = 4294967295.0;
+
+  unsigned long intPart = (unsigned long) d;
+  uint32_t      frac    = (uint32_t) ((d - intPart) * pow10[decimals]);
+
+  if (frac >= pow10[decimals])
+    frac = pow10[decimals] - 1;
+
+  // No "-0"
+  _unsigned(intPart, negative && (intPart || frac));
+
+  if (decimals)
+  {
+    char buf[8];
+
+    buf[0] = '.';
+
+    for (uint8_t i = decimals; i > 0; i--)
+    {
+      buf[i] = '0' + (frac % 10);
+      frac /= 10;
+    }
+
+    _out.write((const uint8_t*) buf, decimals + 1);
+  }
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+WiFiJsonWriter& WiFiJsonWriter::null()
+{
+  _separator();
+  _out.write((const uint8_t*) "null", 4);
+
+  return *this;
+}
+
+////////////////////////////////////////
+
+void WiFiJsonWriter::_separator()
+{
+  if (_afterKey)
+  {
+    _afterKey = false;
+
+    return;
+  }
+
+  if ( (_depth == 0) || (_depth > WS_JSON_WRITER_MAX_DEPTH) )
+    return;
+
+  uint16_t bit = (1u << (_depth - 1));
+
+  if (_hasItems & bit)
+    _out.write(',');
+  else
+    _hasItems |= bit;
+}
+
+////////////////////////////////////////
+
+void WiFiJsonWriter::_begin(char c)
+{
+  _separator();
+  _out.write(c);
+
+  if (_depth < WS_JSON_WRITER_MAX_DEPTH)
+    _hasItems &= ~(1u << _depth);
+
+  _depth++;
+}
+
+////////////////////////////////////////
+
+void WiFiJsonWriter::_end(char c)
+{
+  if (_depth)
+    _depth--;
+
+  _afterKey = false;
+  _out.write(c);
+}
+
+////////////////////////////////////////
+
+void WiFiJsonWriter::_string(const char* str, bool progmem)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  char    buf[32];
+  uint8_t len = 0;
+
+  buf[len++] = '"';
+
+  while (true)
+  {
+    char c = progmem ? (char) pgm_read_byte(str) : *str;
+
+    if (c == 0)
+      break;
+
+    str++;
+
+    // Room for the longest escape, \u00XX, and the closing quote
+    if (len > sizeof(buf) - 7)
+    {
+      _out.write((const uint8_t*) buf, len);
+      len = 0;
+    }
+
+    if ( (c == '"') || (c == '\\') )
+    {
+      buf[len++] = '\\';
+      buf[len++] = c;
+    }
+    else if ((uint8_t) c < 0x20)
+    {
+      buf[len++] = '\\';
+
+      switch (c)
+      {
+        case '\n':
+          buf[len++] = 'n';
+          break;
+
+        case '\r':
+          buf[len++] = 'r';
+          break;
+
+        case '\t':
+          buf[len++] = 't';
+          break;
+
+        case '\b':
+          buf[len++] = 'b';
+          break;
+
+        case '\f':
+          buf[len++] = 'f';
+          break;
+
+        default:
+          buf[len++] = 'u';
+          buf[len++] = '0';
+          buf[len++] = '0';
+          buf[len++] = hex[(c >> 4) & 0x0F];
+          buf[len++] = hex[c & 0x0F];
+          break;
+      }
+    }
+    else
+    {
+      buf[len++] = c;
+    }
+  }
+
+  buf[len++] = '"';
+
+  _out.write((const uint8_t*) buf, len);
+}
+
+////////////////////////////////////////
+
+void WiFiJsonWriter::_unsigned(unsigned long n, bool negative)
+{
+  // Filled from the end, max "-4294967295" on 32-bit, 21 chars on 64-bit long
+  char  buf[22];
+  char* p = buf + sizeof(buf);
+
+  do
+  {
+    *--p = '0' + (n % 10);
+    n /= 10;
+  } while (n);
+
+  if (negative)
+    *--p = '-';
+
+  _out.write((const uint8_t*) p, buf + sizeof(buf) - p);
+}
+
+////////////////////////////////////////
@@ -0,0 +1,109 @@
+/****************************************************************************************************************************
+  JsonWriter.h - Streaming JSON writer for responses
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef JsonWriter_H
+#define JsonWriter_H
+
+#include <Arduino.h>
+
+////////////////////////////////////////
+
+// Max nesting of objects / arrays, up to 16
+#ifndef WS_JSON_WRITER_MAX_DEPTH
+  #define WS_JSON_WRITER_MAX_DEPTH    16
+#elif (WS_JSON_WRITER_MAX_DEPTH > 16)
+  #undef WS_JSON_WRITER_MAX_DEPTH
+  #define WS_JSON_WRITER_MAX_DEPTH    16
+#endif
+
+////////////////////////////////////////
+
+// Writes JSON directly to any Print, such as WiFiResponseStream, without building a String.
+// Commas and colons are inserted automatically
+class WiFiJsonWriter
+{
+  public:
+
+    WiFiJsonWriter(Print& out);
+
+    WiFiJsonWriter& beginObject();
+    WiFiJsonWriter& endObject();
+    WiFiJsonWriter& beginArray();
+    WiFiJsonWriter& endArray();
+
+    WiFiJsonWriter& key(const char* name);
+    WiFiJsonWriter& key(const __FlashStringHelper* name);
+
+    // Strings are escaped, nullptr is written as null
+    WiFiJsonWriter& value(const char* str);
+    WiFiJsonWriter& value(const __FlashStringHelper* str);
+    WiFiJsonWriter& value(const String& str);
+
+    WiFiJsonWriter& value(bool b);
+    WiFiJsonWriter& value(int n);
+    WiFiJsonWriter& value(unsigned int n);
+    WiFiJsonWriter& value(long n);
+    WiFiJsonWriter& value(unsigned long n);
+
+    // Fixed-point, up to 6 decimals. NaN / Inf are written as null
+    WiFiJsonWriter& value(double d, uint8_t decimals = 2);
+
+    WiFiJsonWriter& null();
+
+    ////////////////////////////////////////
+
+    template<typename T>
+    inline WiFiJsonWriter& member(const char* name, T v)
+    {
+      key(name);
+
+      return value(v);
+    }
+
+    ////////////////////////////////////////
+
+    inline WiFiJsonWriter& member(const char* name, double d, uint8_t decimals)
+    {
+      key(name);
+
+      return value(d, decimals);
+    }
+
+    ////////////////////////////////////////
+
+  private:
+
+    void _separator();
+    void _begin(char c);
+    void _end(char c);
+    void _string(const char* str, bool progmem);
+    void _unsigned(unsigned long n, bool negative);
+
+    Print&    _out;
+    uint8_t   _depth;
+    bool      _afterKey;
+    uint16_t  _hasItems;    // bit per depth, set once the container has its first item
+};
+
+////////////////////////////////////////
+
+#endif    // JsonWriter_H
@@ -0,0 +1,360 @@
+/****************************************************************************************************************************
+  LogRing.cpp - Deferred binary log records for the WS_LOG macros
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "LogRing.h"
+#include "WiFiDebug.h"
+
+////////////////////////////////////////
+
+static_assert( (WS_LOG_RING_SZ & (WS_LOG_RING_SZ - 1)) == 0 && (WS_LOG_RING_SZ <= 32768),
+               "WS_LOG_RING_SZ must be a power of 2, max 32768");
+
+static_assert( (WS_LOG_MAX_RECORD >= 16) && (WS_LOG_MAX_RECORD <= 255), "WS_LOG_MAX_RECORD must be 16 to 255");
+
+WS_LAYOUT_DEFINE(WiFiLogRing, WS_LOG_RING_SZ, WS_LOG_MAX_RECORD);
+
+////////////////////////////////////////
+
+WiFiLogRing& wsLogRing()
+{
+  static WiFiLogRing ring;
+
+  return ring;
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_putRaw(uint8_t* record, size_t& len, uint8_t type, const void* data, size_t size)
+{
+  if (len + 1 + size > WS_LOG_MAX_RECORD)
+    return;
+
+  record[len++] = type;
+  memcpy(record + len, data, size);
+  len += size;
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_putString(uint8_t* record, size_t& len, const char* str, size_t strLen)
+{
+  // RAM strings may be gone by flush() time, so their bytes are copied
+  if (len + 2 > WS_LOG_MAX_RECORD)
+    return;
+
+  size_t room = WS_LOG_MAX_RECORD - len - 2;
+
+  if (strLen > room)
+  {
+    strLen = room;
+    record[len++] = ARG_STRING_CUT;
+  }
+  else
+  {
+    record[len++] = ARG_STRING;
+  }
+
+  record[len++] = (uint8_t) strLen;
+  memcpy(record + len, str, strLen);
+  len += strLen;
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, const __FlashStringHelper* str)
+{
+  // Flash strings stay valid, keep only the pointer
+  _putRaw(record, len, ARG_FLASH, &str, sizeof(str));
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, const char* str)
+{
+  if (!str)
+    str = "(null)";
+
+  _putString(record, len, str, strlen(str));
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, const String& str)
+{
+  _putString(record, len, str.c_str(), str.length());
+}
+
+////////////////////////////////////////
+
+// Captures the printed form of IPAddress and other Printable objects
+class LogRecordPrint : public Print
+{
+  public:
+
+    LogRecordPrint(uint8_t* buffer, size_t size) : _buffer(buffer), _size(size) {}
+
+    size_t write(uint8_t c)
+    {
+      if (_len >= _size)
+        return 0;
+
+      _buffer[_len++] = c;
+
+      return 1;
+    }
+
+    size_t length() const
+    {
+      return _len;
+    }
+
+  private:
+
+    uint8_t*  _buffer;
+    size_t    _size;
+    size_t    _len = 0;
+};
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, const Printable& obj)
+{
+  if (len + 2 > WS_LOG_MAX_RECORD)
+    return;
+
+  LogRecordPrint printed(record + len + 2, WS_LOG_MAX_RECORD - len - 2);
+
+  obj.printTo(printed);
+
+  record[len]     = ARG_STRING;
+  record[len + 1] = (uint8_t) printed.length();
+  len += 2 + printed.length();
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, char c)
+{
+  _putRaw(record, len, ARG_CHAR, &c, 1);
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, unsigned char num)
+{
+  _put(record, len, (unsigned long) num);
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, int num)
+{
+  _put(record, len, (long) num);
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, unsigned int num)
+{
+  _put(record, len, (unsigned long) num);
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, long num)
+{
+  _putRaw(record, len, ARG_LONG, &num, sizeof(num));
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, unsigned long num)
+{
+  _putRaw(record, len, ARG_ULONG, &num, sizeof(num));
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_put(uint8_t* record, size_t& len, double num)
+{
+  _putRaw(record, len, ARG_DOUBLE, &num, sizeof(num));
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_push(const uint8_t* record, size_t len)
+{
+  uint16_t head = _head;
+
+  if (len > (uint16_t) (WS_LOG_RING_SZ - (uint16_t) (head - _tail)))
+  {
+    // Never block the caller, count the loss instead
+    _dropped = _dropped + 1;
+
+    return;
+  }
+
+  for (size_t i = 0; i < len; i++)
+  {
+    _buffer[(uint16_t) (head + i) & (WS_LOG_RING_SZ - 1)] = record[i];
+  }
+
+  // Publish the record only once its bytes are in place
+  _head = head + len;
+}
+
+////////////////////////////////////////
+
+uint16_t WiFiLogRing::flush(Print& out, uint16_t maxRecords)
+{
+  uint16_t printed = 0;
+
+  uint32_t dropped = _dropped;
+
+  if (dropped != _reported)
+  {
+    out.print(WWS_MARK);
+    out.print(F("Log records dropped: "));
+    out.println(dropped - _reported);
+
+    _reported = dropped;
+  }
+
+  while ( (_tail != _head) && (printed < maxRecords) )
+  {
+    uint8_t   record[WS_LOG_MAX_RECORD];
+    uint16_t  tail  = _tail;
+    size_t    len   = _buffer[tail & (WS_LOG_RING_SZ - 1)];
+
+    for (size_t i = 0; i < len; i++)
+    {
+      record[i] = _buffer[(uint16_t) (tail + i) & (WS_LOG_RING_SZ - 1)];
+    }
+
+    // Free the space before the slow part
+    _tail = tail + len;
+
+    _print(out, record, len);
+    printed++;
+  }
+
+  return printed;
+}
+
+////////////////////////////////////////
+
+void WiFiLogRing::_print(Print& out, const uint8_t* record, size_t len)
+{
+  uint8_t flags = record[1];
+  size_t  pos   = 2;
+  bool    first = true;
+
+  if (flags & LOG_MARK)
+    out.print(WWS_MARK);
+
+  while (pos < len)
+  {
+    uint8_t type = record[pos++];
+
+    if (!first)
+      out.print(WWS_SPACE);
+
+    first = false;
+
+    switch (type)
+    {
+      case ARG_FLASH:
+      {
+        const __FlashStringHelper* str;
+
+        memcpy(&str, record + pos, sizeof(str));
+        pos += sizeof(str);
+
+        out.print(str);
+
+        break;
+      }
+
+      case ARG_STRING:
+      case ARG_STRING_CUT:
+      {
+        size_t strLen = record[pos++];
+
+        out.write(record + pos, strLen);
+        pos += strLen;
+
+        if (type == ARG_STRING_CUT)
+          out.print(F("..."));
+
+        break;
+      }
+
+      case ARG_CHAR:
+        out.print((char) record[pos++]);
+
+        break;
+
+      case ARG_LONG:
+      {
+        long num;
+
+        memcpy(&num, record + pos, sizeof(num));
+        pos += sizeof(num);
+
+        out.print(num);
+
+        break;
+      }
+
+      case ARG_ULONG:
+      {
+        unsigned long num;
+
+        memcpy(&num, record + pos, sizeof(num));
+        pos += sizeof(num);
+
+        out.print(num);
+
+        break;
+      }
+
+      case ARG_DOUBLE:
+      {
+        double num;
+
+        memcpy(&num, record + pos, sizeof(num));
+        pos += sizeof(num);
+
+        out.print(num);
+
+        break;
+      }
+
+      default:
+        // Corrupt record, skip the rest
+        pos = len;
+
+        break;
+    }
+  }
+
+  if (flags & LOG_NEWLINE)
+    out.println();
+}
+
+////////////////////////////////////////
@@ -0,0 +1,164 @@
+/****************************************************************************************************************************
+  LogRing.h - Deferred binary log records for the WS_LOG macros
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef LogRing_H
+#define LogRing_H
+
+#include <Arduino.h>
+
+#include "WiFiLayout.h"
+
+////////////////////////////////////////
+
+// The two sizes below are compiled into LogRing.cpp too, which holds the ring, so redefine
+// them as compiler flags (e.g. build_flags). A sketch-only #define of either fails to link
+
+// Ring size in bytes, must be a power of 2, max 32768
+#ifndef WS_LOG_RING_SZ
+  #define WS_LOG_RING_SZ              1024
+#endif
+
+// Max bytes of one record, longer strings are cut
+#ifndef WS_LOG_MAX_RECORD
+  #define WS_LOG_MAX_RECORD           96
+#endif
+
+// Permit redefinition in sketch. Max records printed per idle handleClient() call
+#ifndef WS_LOG_FLUSH_RECORDS
+  #define WS_LOG_FLUSH_RECORDS        4
+#endif
+
+////////////////////////////////////////
+
+// Stores a log line as a flash format pointer plus the raw bytes of its arguments.
+// Formatting and UART output happen later, in flush(). Single producer, single consumer.
+class WiFiLogRing
+{
+  public:
+
+    enum
+    {
+      LOG_MARK      = 0x01,     // Start with WWS_MARK
+      LOG_NEWLINE   = 0x02      // End with a new line
+    };
+
+    ////////////////////////////////////////
+
+    template<typename... Args>
+    void log(uint8_t flags, const Args&... args)
+    {
+      uint8_t record[WS_LOG_MAX_RECORD];
+      size_t  len = 2;
+
+      record[1] = flags;
+
+      _pack(record, len, args...);
+
+      record[0] = (uint8_t) len;
+
+      _push(record, len);
+    }
+
+    ////////////////////////////////////////
+
+    // Print up to maxRecords records, return the number printed
+    uint16_t flush(Print& out, uint16_t maxRecords = 0xFFFF);
+
+    inline bool empty() const
+    {
+      return (_head == _tail);
+    }
+
+    inline uint32_t dropped() const
+    {
+      return _dropped;
+    }
+
+  private:
+
+    enum
+    {
+      ARG_FLASH,
+      ARG_STRING,
+      ARG_STRING_CUT,
+      ARG_CHAR,
+      ARG_LONG,
+      ARG_ULONG,
+      ARG_DOUBLE
+    };
+
+    ////////////////////////////////////////
+
+    static inline void _pack(uint8_t* record, size_t& len)
+    {
+      (void) record;
+      (void) len;
+    }
+
+    template<typename T, typename... Rest>
+    static inline void _pack(uint8_t* record, size_t& len, const T& first, const Rest&... rest)
+    {
+      _put(record, len, first);
+      _pack(record, len, rest...);
+    }
+
+    ////////////////////////////////////////
+
+    static void _put(uint8_t* record, size_t& len, const __FlashStringHelper* str);
+    static void _put(uint8_t* record, size_t& len, const char* str);
+    static void _put(uint8_t* record, size_t& len, const String& str);
+    static void _put(uint8_t* record, size_t& len, const Printable& obj);
+    static void _put(uint8_t* record, size_t& len, char c);
+    static void _put(uint8_t* record, size_t& len, unsigned char num);
+    static void _put(uint8_t* record, size_t& len, int num);
+    static void _put(uint8_t* record, size_t& len, unsigned int num);
+    static void _put(uint8_t* record, size_t& len, long num);
+    static void _put(uint8_t* record, size_t& len, unsigned long num);
+    static void _put(uint8_t* record, size_t& len, double num);
+
+    static void _putString(uint8_t* record, size_t& len, const char* str, size_t strLen);
+    static void _putRaw(uint8_t* record, size_t& len, uint8_t type, const void* data, size_t size);
+
+    ////////////////////////////////////////
+
+    void _push(const uint8_t* record, size_t len);
+    void _print(Print& out, const uint8_t* record, size_t len);
+
+    uint8_t             _buffer[WS_LOG_RING_SZ];
+
+    // _head is only written by log(), _tail and _reported only by flush()
+    volatile uint16_t   _head     = 0;
+    volatile uint16_t   _tail     = 0;
+    volatile uint32_t   _dropped  = 0;
+    uint32_t            _reported = 0;
+};
+
+WS_LAYOUT_CHECK(WiFiLogRing, WS_LOG_RING_SZ, WS_LOG_MAX_RECORD);
+
+////////////////////////////////////////
+
+// Shared by all WS_LOG macros when WIFI_WEBSERVER_DEFERRED_LOG is true
+WiFiLogRing& wsLogRing();
+
+////////////////////////////////////////
+
+#endif    // LogRing_H
@@ -0,0 +1,262 @@
+/****************************************************************************************************************************
+  MemoryStats.cpp - Free heap, largest block and stack use probes
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "MemoryStats.h"
+
+#if defined(ESP8266)
+
+  #include <cont.h>
+
+#elif defined(__AVR__)
+
+  // avr-libc malloc internals
+  struct __freelist
+  {
+    size_t              sz;
+    struct __freelist*  nx;
+  };
+
+  extern "C"
+  {
+    extern char               __heap_start;
+    extern char*              __brkval;
+    extern struct __freelist* __flp;
+  }
+
+  #define WS_STACK_ABOVE_HEAP         true
+
+#elif ( defined(__arm__) && !defined(ARDUINO_ARCH_MBED) && !defined(ARDUINO_ARCH_NRF52) )
+
+  #include <malloc.h>
+
+  extern "C" char* sbrk(int incr);
+
+  #define WS_STACK_ABOVE_HEAP         true
+
+#elif defined(__arm__)
+
+  // mbed and nRF52 FreeRTOS run loop() on a thread stack, only the newlib arena is known
+  #include <malloc.h>
+
+#endif
+
+#ifndef WS_STACK_ABOVE_HEAP
+  #define WS_STACK_ABOVE_HEAP         false
+#endif
+
+////////////////////////////////////////
+
+#define WS_STACK_PAINT                0xA5
+
+// Keep clear of the frames of paintStack() itself
+#define WS_STACK_PAINT_MARGIN         64
+
+#if WS_STACK_ABOVE_HEAP
+
+static uint8_t* paintBottom = nullptr;
+static uint8_t* paintTop    = nullptr;
+
+////////////////////////////////////////
+
+static uint8_t* heapEnd()
+{
+#if defined(__AVR__)
+  return (uint8_t*) (__brkval ? __brkval : &__heap_start);
+#else
+  return (uint8_t*) sbrk(0);
+#endif
+}
+
+#endif
+
+////////////////////////////////////////
+
+uint32_t WiFiMemoryStats::freeHeap()
+{
+#if (ESP8266 || ESP32)
+  return ESP.getFreeHeap();
+#elif defined(__AVR__)
+  uint8_t   top;
+  uint32_t  free = &top - heapEnd();
+
+  for (struct __freelist* block = __flp; block; block = block->nx)
+    free += block->sz + sizeof(size_t);
+
+  return free;
+#elif defined(__arm__)
+  uint32_t free = mallinfo().fordblks;
+
+#if WS_STACK_ABOVE_HEAP
+  uint8_t top;
+
+  free += &top - heapEnd();
+#endif
+
+  return free;
+#else
+  return 0;
+#endif
+}
+
+////////////////////////////////////////
+
+uint32_t WiFiMemoryStats::maxFreeBlock()
+{
+#if defined(ESP8266)
+  return ESP.getMaxFreeBlockSize();
+#elif defined(ESP32)
+  return ESP.getMaxAllocHeap();
+#elif defined(__AVR__)
+  uint8_t   top;
+  uint32_t  largest = &top - heapEnd();
+
+  for (struct __freelist* block = __flp; block; block = block->nx)
+  {
+    if (block->sz > largest)
+      largest = block->sz;
+  }
+
+  return largest;
+#elif (defined(__arm__) && WS_STACK_ABOVE_HEAP)
+  // The gap below the stack, a freed arena chunk can only be smaller than the whole free list
+  uint8_t top;
+
+  return &top - heapEnd();
+#else
+  return 0;
+#endif
+}
+
+////////////////////////////////////////
+
+void WiFiMemoryStats::paintStack(uint16_t size)
+{
+#if defined(ESP8266)
+  (void) size;
+
+  ESP.resetFreeContStack();
+#elif WS_STACK_ABOVE_HEAP
+  if (size == 0)
+    return;
+
+  uint8_t   top;
+  uint8_t*  end     = &top - WS_STACK_PAINT_MARGIN;
+  uint8_t*  start   = end - size;
+
+  // Leave a margin for the heap to grow into
+  if (start < heapEnd() + WS_STACK_PAINT_MARGIN)
+    start = heapEnd() + WS_STACK_PAINT_MARGIN;
+
+  paintTop    = end;
+  paintBottom = start;
+
+  for (volatile uint8_t* p = start; p < end; p++)
+    *p = WS_STACK_PAINT;
+#else
+  (void) size;
+#endif
+}
+
+////////////////////////////////////////
+
+uint32_t WiFiMemoryStats::stackUsed()
+{
+#if defined(ESP8266)
+  // Peak use of the whole 4 KB loop() stack
+  return CONT_STACKSIZE - ESP.getFreeContStack();
+#elif WS_STACK_ABOVE_HEAP
+  if (paintBottom >= paintTop)
+    return 0;
+
+  uint8_t* p = paintBottom;
+
+  while ( (p < paintTop) && (*p == WS_STACK_PAINT) )
+    p++;
+
+  // Depth below the frame of paintStack()'s caller
+  return (p < paintTop) ? (paintTop - p + WS_STACK_PAINT_MARGIN) : 0;
+#else
+  return 0;
+#endif
+}
+
+////////////////////////////////////////
+
+#if WS_COUNT_ALLOCATIONS
+
+static volatile uint32_t allocCount = 0;
+static volatile uint32_t allocBytes = 0;
+
+extern "C"
+{
+  void* __real_malloc(size_t size);
+  void* __real_calloc(size_t count, size_t size);
+  void* __real_realloc(void* ptr, size_t size);
+
+  void* __wrap_malloc(size_t size)
+  {
+    allocCount = allocCount + 1;
+    allocBytes = allocBytes + size;
+
+    return __real_malloc(size);
+  }
+
+  void* __wrap_calloc(size_t count, size_t size)
+  {
+    allocCount = allocCount + 1;
+    allocBytes = allocBytes + count * size;
+
+    return __real_calloc(count, size);
+  }
+
+  void* __wrap_realloc(void* ptr, size_t size)
+  {
+    allocCount = allocCount + 1;
+    allocBytes = allocBytes + size;
+
+    return __real_realloc(ptr, size);
+  }
+}
+
+uint32_t WiFiMemoryStats::allocations()
+{
+  return allocCount;
+}
+
+uint32_t WiFiMemoryStats::allocatedBytes()
+{
+  return allocBytes;
+}
+
+#else
+
+uint32_t WiFiMemoryStats::allocations()
+{
+  return 0;
+}
+
+uint32_t WiFiMemoryStats::allocatedBytes()
+{
+  return 0;
+}
+
+#endif
+
+////////////////////////////////////////
@@ -0,0 +1,58 @@
+/****************************************************************************************************************************
+  MemoryStats.h - Free heap, largest block and stack use probes
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef MemoryStats_H
+#define MemoryStats_H
+
+#include <Arduino.h>
+
+////////////////////////////////////////
+
+// Permit redefinition in sketch. Bytes painted below the stack pointer by paintStack(), 0 to disable.
+// Only used where the stack sits above the heap (AVR, single-stack ARM)
+#ifndef WS_STACK_PAINT_SZ
+  #define WS_STACK_PAINT_SZ           512
+#endif
+
+////////////////////////////////////////
+
+// Each probe returns 0 where the platform doesn't expose the value
+class WiFiMemoryStats
+{
+  public:
+
+    static uint32_t freeHeap();
+    static uint32_t maxFreeBlock();
+
+    // Peak stack use since the last paintStack(). The default size is taken where it's called
+    static void     paintStack(uint16_t size = WS_STACK_PAINT_SZ);
+    static uint32_t stackUsed();
+
+    // malloc / calloc / realloc calls and bytes requested, counted when linked with
+    // -DWS_COUNT_ALLOCATIONS=1 -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+    static uint32_t allocations();
+    static uint32_t allocatedBytes();
+};
+
+////////////////////////////////////////
+
+#endif    // MemoryStats_H
@@ -108,12 +108,35 @@ class RequestHandler
       _next = r;
     }
 
+#if WEBSERVER_SUPPORT_UPLOAD
+    ////////////////////////////////////////
+
+    // Bytes handed to upload() at a time, 0 for HTTP_UPLOAD_BUFLEN
+    RequestHandler& setUploadBufferSize(size_t size)
+    {
+      _uploadBufferSize = size;
+
+      return *this;
+    }
+
+    ////////////////////////////////////////
+
+    size_t uploadBufferSize() const
+    {
+      return _uploadBufferSize ? _uploadBufferSize : HTTP_UPLOAD_BUFLEN;
+    }
+#endif
+
     ////////////////////////////////////////
 
   private:
 
     RequestHandler* _next = nullptr;
 
+#if WEBSERVER_SUPPORT_UPLOAD
+    size_t          _uploadBufferSize = 0;
+#endif
+
     ////////////////////////////////////////
 
   protected:
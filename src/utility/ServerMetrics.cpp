@@ -0,0 +1,426 @@
+/****************************************************************************************************************************
+  ServerMetrics.cpp - Fixed-size request counters and latency histograms
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "ServerMetrics.h"
+
+WS_LAYOUT_DEFINE(WiFiServerMetrics, WS_METRICS_MAX_ROUTES, WS_METRICS_LABEL_LEN, WS_METRICS_BUCKETS);
+
+////////////////////////////////////////
+
+// Print us as seconds with 6 decimals, e.g. 0.001234
+static void printSeconds(Print& out, uint64_t us)
+{
+  char  buf[24];
+  char* p = buf + sizeof(buf);
+
+  *--p = 0;
+
+  for (uint8_t i = 0; i < 6; i++)
+  {
+    *--p = '0' + (us % 10);
+    us /= 10;
+  }
+
+  *--p = '.';
+
+  do
+  {
+    *--p = '0' + (us % 10);
+    us /= 10;
+  } while (us);
+
+  out.print(p);
+}
+
+////////////////////////////////////////
+
+WiFiServerMetrics::WiFiServerMetrics()
+{
+  memset(_routes, 0, sizeof(_routes));
+  strcpy(_routes[ROUTE_NONE].label, "none");
+  strcpy(_routes[ROUTE_NOT_FOUND].label, "notfound");
+  strcpy(_routes[ROUTE_OTHER].label, "other");
+
+  _routeCount   = ROUTE_FIRST;
+  _current      = ROUTE_NONE;
+
+  memset(&_parse, 0, sizeof(_parse));
+  memset(_status, 0, sizeof(_status));
+  memset(_timeouts, 0, sizeof(_timeouts));
+
+  _accepted     = 0;
+  _deferredPeak = 0;
+
+  _memoryStartFree      = 0;
+  _memoryMinFree        = 0;
+  _memoryMinBlock       = 0;
+  _memoryAllocations    = 0;
+  _memoryAllocatedBytes = 0;
+  _heapFreeMin          = 0;
+  _memoryRequests       = 0;
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::addRoute(const void* key, const char* label, uint8_t method)
+{
+  if (_routeCount >= ROUTE_FIRST + WS_METRICS_MAX_ROUTES)
+    return;
+
+  Route& route = _routes[_routeCount++];
+
+  route.key     = key;
+  route.method  = method;
+
+  uint8_t i;
+
+  // Quote and backslash would need escaping in the label value
+  for (i = 0; label[i] && (i < WS_METRICS_LABEL_LEN); i++)
+    route.label[i] = ( (label[i] == '"') || (label[i] == '\\') ) ? '_' : label[i];
+
+  route.label[i] = 0;
+}
+
+////////////////////////////////////////
+
+int WiFiServerMetrics::beginRoute(const void* key, uint32_t bytesIn)
+{
+  uint8_t index = key ? ROUTE_OTHER : ROUTE_NOT_FOUND;
+
+  for (uint8_t i = ROUTE_FIRST; key && (i < _routeCount); i++)
+  {
+    if (_routes[i].key == key)
+    {
+      index = i;
+      break;
+    }
+  }
+
+  _current = index;
+  _routes[index].requests++;
+  _routes[index].bytesIn += bytesIn;
+
+  return index;
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::selectRoute(int route)
+{
+  if ( (route >= 0) && (route < _routeCount) )
+    _current = route;
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::clearRoute()
+{
+  _current = ROUTE_NONE;
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::endHandler(uint32_t handler_us)
+{
+  _record(_routes[_current].handler, handler_us);
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::memoryBegin(uint16_t stackPaint)
+{
+  _memoryStartFree      = WiFiMemoryStats::freeHeap();
+  _memoryMinFree        = _memoryStartFree;
+  _memoryMinBlock       = WiFiMemoryStats::maxFreeBlock();
+  _memoryAllocations    = WiFiMemoryStats::allocations();
+  _memoryAllocatedBytes = WiFiMemoryStats::allocatedBytes();
+
+  WiFiMemoryStats::paintStack(stackPaint);
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::memorySample()
+{
+  uint32_t free   = WiFiMemoryStats::freeHeap();
+  uint32_t block  = WiFiMemoryStats::maxFreeBlock();
+
+  if (free < _memoryMinFree)
+    _memoryMinFree = free;
+
+  if (block < _memoryMinBlock)
+    _memoryMinBlock = block;
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::memoryEnd()
+{
+  memorySample();
+
+  Route&    route = _routes[_current];
+  uint32_t  stack = WiFiMemoryStats::stackUsed();
+
+  if (_memoryStartFree - _memoryMinFree > route.heapPeak)
+    route.heapPeak = _memoryStartFree - _memoryMinFree;
+
+  if ( (route.blockMin == 0) || (_memoryMinBlock < route.blockMin) )
+    route.blockMin = _memoryMinBlock;
+
+  if (stack > route.stackPeak)
+    route.stackPeak = stack;
+
+  route.allocations     += WiFiMemoryStats::allocations() - _memoryAllocations;
+  route.allocatedBytes  += WiFiMemoryStats::allocatedBytes() - _memoryAllocatedBytes;
+
+  if ( (_memoryRequests == 0) || (_memoryMinFree < _heapFreeMin) )
+    _heapFreeMin = _memoryMinFree;
+
+  _memoryRequests++;
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::_record(Histogram& hist, uint32_t us)
+{
+  uint8_t bucket = 0;
+
+  // Upper bound of bucket i is (1 << i) ms
+  while ( (bucket < WS_METRICS_BUCKETS - 1) && (us > (1000UL << bucket)) )
+    bucket++;
+
+  hist.buckets[bucket]++;
+  hist.count++;
+  hist.sum_us += us;
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::render(Print& out, uint8_t connectionsActive, uint8_t deferredActive)
+{
+  _renderRouteValue(out, F("wifiwebserver_requests_total"),  F("counter"), VALUE_REQUESTS);
+  _renderRouteValue(out, F("wifiwebserver_bytes_in_total"),  F("counter"), VALUE_BYTES_IN);
+  _renderRouteValue(out, F("wifiwebserver_bytes_out_total"), F("counter"), VALUE_BYTES_OUT);
+
+  out.print(F("# TYPE wifiwebserver_handler_seconds histogram\n"));
+
+  for (uint8_t i = 0; i < _routeCount; i++)
+  {
+    if (_routes[i].handler.count)
+      _renderHistogram(out, F("wifiwebserver_handler_seconds"), &_routes[i], _routes[i].handler);
+  }
+
+  out.print(F("# TYPE wifiwebserver_parse_seconds histogram\n"));
+  _renderHistogram(out, F("wifiwebserver_parse_seconds"), nullptr, _parse);
+
+  out.print(F("# TYPE wifiwebserver_responses_total counter\n"));
+
+  for (uint8_t i = 0; i < 5; i++)
+  {
+    out.print(F("wifiwebserver_responses_total{code=\""));
+    out.print(i + 1);
+    out.print(F("xx\"} "));
+    out.print(_status[i]);
+    out.print('\n');
+  }
+
+  out.print(F("# TYPE wifiwebserver_connections_accepted_total counter\nwifiwebserver_connections_accepted_total "));
+  out.print(_accepted);
+  out.print(F("\n# TYPE wifiwebserver_connections_active gauge\nwifiwebserver_connections_active "));
+  out.print(connectionsActive);
+  out.print(F("\n# TYPE wifiwebserver_deferred_active gauge\nwifiwebserver_deferred_active "));
+  out.print(deferredActive);
+  out.print(F("\n# TYPE wifiwebserver_deferred_peak gauge\nwifiwebserver_deferred_peak "));
+  out.print(_deferredPeak);
+
+  out.print(F("\n# TYPE wifiwebserver_timeouts_total counter\nwifiwebserver_timeouts_total{kind=\"data_wait\"} "));
+  out.print(_timeouts[TIMEOUT_DATA_WAIT]);
+  out.print(F("\nwifiwebserver_timeouts_total{kind=\"close_wait\"} "));
+  out.print(_timeouts[TIMEOUT_CLOSE_WAIT]);
+  out.print(F("\nwifiwebserver_timeouts_total{kind=\"deferred\"} "));
+  out.print(_timeouts[TIMEOUT_DEFERRED]);
+  out.print('\n');
+
+  if (_memoryRequests)
+  {
+    // Only when the server calls memoryBegin() / memoryEnd(), see WS_METRICS_MEMORY
+    _renderGauge(out, F("wifiwebserver_heap_free_bytes"),      WiFiMemoryStats::freeHeap());
+    _renderGauge(out, F("wifiwebserver_heap_free_min_bytes"),  _heapFreeMin);
+    _renderGauge(out, F("wifiwebserver_heap_max_block_bytes"), WiFiMemoryStats::maxFreeBlock());
+
+    _renderRouteValue(out, F("wifiwebserver_route_heap_peak_bytes"),      F("gauge"),   VALUE_HEAP_PEAK);
+    _renderRouteValue(out, F("wifiwebserver_route_heap_block_min_bytes"), F("gauge"),   VALUE_BLOCK_MIN);
+    _renderRouteValue(out, F("wifiwebserver_route_stack_peak_bytes"),     F("gauge"),   VALUE_STACK_PEAK);
+    _renderRouteValue(out, F("wifiwebserver_route_allocations_total"),    F("counter"), VALUE_ALLOCATIONS);
+    _renderRouteValue(out, F("wifiwebserver_route_allocated_bytes_total"), F("counter"), VALUE_ALLOCATED_BYTES);
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::_renderGauge(Print& out, const __FlashStringHelper* name, uint32_t value)
+{
+  out.print(F("# TYPE "));
+  out.print(name);
+  out.print(F(" gauge\n"));
+  out.print(name);
+  out.print(' ');
+  out.print(value);
+  out.print('\n');
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::_renderRouteValue(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* type,
+                                          uint8_t which)
+{
+  out.print(F("# TYPE "));
+  out.print(name);
+  out.print(' ');
+  out.print(type);
+  out.print('\n');
+
+  for (uint8_t i = 0; i < _routeCount; i++)
+  {
+    const Route& route = _routes[i];
+
+    // The none route has bytes out only
+    if (!route.requests && !route.bytesOut)
+      continue;
+
+    out.print(name);
+    out.print('{');
+    _renderLabels(out, route);
+    out.print(F("} "));
+
+    switch (which)
+    {
+      case VALUE_REQUESTS:
+        out.print(route.requests);
+        break;
+
+      case VALUE_BYTES_IN:
+        out.print(route.bytesIn);
+        break;
+
+      case VALUE_BYTES_OUT:
+        out.print(route.bytesOut);
+        break;
+
+      case VALUE_HEAP_PEAK:
+        out.print(route.heapPeak);
+        break;
+
+      case VALUE_BLOCK_MIN:
+        out.print(route.blockMin);
+        break;
+
+      case VALUE_STACK_PEAK:
+        out.print(route.stackPeak);
+        break;
+
+      case VALUE_ALLOCATIONS:
+        out.print(route.allocations);
+        break;
+
+      default:
+        out.print(route.allocatedBytes);
+        break;
+    }
+
+    out.print('\n');
+  }
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::_renderLabels(Print& out, const Route& route)
+{
+  // The same URI may be registered once per method, the method keeps the series apart
+  static const char methods[][8] PROGMEM = { "ANY", "GET", "HEAD", "POST", "PUT", "PATCH", "DELETE", "OPTIONS" };
+
+  out.print(F("route=\""));
+  out.print(route.label);
+  out.print(F("\",method=\""));
+
+  if (route.method < sizeof(methods) / sizeof(methods[0]))
+    out.print((const __FlashStringHelper*) methods[route.method]);
+  else
+    out.print(route.method);
+
+  out.print('"');
+}
+
+////////////////////////////////////////
+
+void WiFiServerMetrics::_renderHistogram(Print& out, const __FlashStringHelper* name, const Route* route,
+                                         const Histogram& hist)
+{
+  uint32_t cumulative = 0;
+
+  for (uint8_t i = 0; i < WS_METRICS_BUCKETS; i++)
+  {
+    cumulative += hist.buckets[i];
+
+    out.print(name);
+    out.print(F("_bucket{"));
+
+    if (route)
+    {
+      _renderLabels(out, *route);
+      out.print(',');
+    }
+
+    out.print(F("le=\""));
+
+    if (i < WS_METRICS_BUCKETS - 1)
+      printSeconds(out, 1000ULL << i);
+    else
+      out.print(F("+Inf"));
+
+    out.print(F("\"} "));
+    out.print(cumulative);
+    out.print('\n');
+  }
+
+  for (uint8_t j = 0; j < 2; j++)
+  {
+    out.print(name);
+    out.print(j ? F("_count") : F("_sum"));
+
+    if (route)
+    {
+      out.print('{');
+      _renderLabels(out, *route);
+      out.print('}');
+    }
+
+    out.print(' ');
+
+    if (j)
+      out.print(hist.count);
+    else
+      printSeconds(out, hist.sum_us);
+
+    out.print('\n');
+  }
+}
+
+////////////////////////////////////////
@@ -0,0 +1,228 @@
+/****************************************************************************************************************************
+  ServerMetrics.h - Fixed-size request counters and latency histograms
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ServerMetrics_H
+#define ServerMetrics_H
+
+#include <Arduino.h>
+
+#include "MemoryStats.h"
+#include "WiFiLayout.h"
+
+////////////////////////////////////////
+
+// The sizes below are compiled into ServerMetrics.cpp too, so redefine them as compiler
+// flags (e.g. build_flags). WS_LAYOUT_CHECK makes a sketch-only redefinition fail to link
+
+// Routes registered by on() / serveStatic(), others are counted as "other"
+#ifndef WS_METRICS_MAX_ROUTES
+  #define WS_METRICS_MAX_ROUTES       8
+#endif
+
+// Route label kept per route, longer URIs are cut
+#ifndef WS_METRICS_LABEL_LEN
+  #define WS_METRICS_LABEL_LEN        24
+#endif
+
+// Histogram buckets, upper bounds 1, 2, 4, ... ms plus +Inf. Between 2 and 16
+#ifndef WS_METRICS_BUCKETS
+  #define WS_METRICS_BUCKETS          10
+#elif (WS_METRICS_BUCKETS < 2)
+  #undef WS_METRICS_BUCKETS
+  #define WS_METRICS_BUCKETS          2
+#elif (WS_METRICS_BUCKETS > 16)
+  #undef WS_METRICS_BUCKETS
+  #define WS_METRICS_BUCKETS          16
+#endif
+
+////////////////////////////////////////
+
+class WiFiServerMetrics
+{
+  public:
+
+    enum
+    {
+      TIMEOUT_DATA_WAIT,
+      TIMEOUT_CLOSE_WAIT,
+      TIMEOUT_DEFERRED,
+      TIMEOUT_KINDS
+    };
+
+    ////////////////////////////////////////
+
+    struct Histogram
+    {
+      uint32_t  buckets[WS_METRICS_BUCKETS];    // not cumulative
+      uint32_t  count;
+      uint64_t  sum_us;
+    };
+
+    ////////////////////////////////////////
+
+    struct Route
+    {
+      const void* key;
+      char        label[WS_METRICS_LABEL_LEN + 1];
+      uint8_t     method;           // HTTPMethod the route was registered for
+      uint32_t    requests;
+      uint32_t    bytesIn;
+      uint32_t    bytesOut;
+      Histogram   handler;
+
+      // Filled by memoryEnd()
+      uint32_t    heapPeak;         // largest drop of free heap during one request
+      uint32_t    blockMin;         // smallest largest-free-block seen
+      uint32_t    stackPeak;
+      uint32_t    allocations;
+      uint32_t    allocatedBytes;
+    };
+
+    ////////////////////////////////////////
+
+    WiFiServerMetrics();
+
+    // key is the RequestHandler*, label its URI, method its HTTPMethod (0, HTTP_ANY, for any)
+    void addRoute(const void* key, const char* label, uint8_t method = 0);
+
+    // Select the route for the request being handled, following bytesOut() go to it. Returns the route index
+    int  beginRoute(const void* key, uint32_t bytesIn);
+    void selectRoute(int route);
+
+    // From a new connection until beginRoute(), bytesOut() go to the "none" route
+    void clearRoute();
+    void endHandler(uint32_t handler_us);
+
+    ////////////////////////////////////////
+
+    inline void bytesOut(size_t len)
+    {
+      _routes[_current].bytesOut += len;
+    }
+
+    ////////////////////////////////////////
+
+    inline void status(int code)
+    {
+      if ( (code >= 100) && (code < 600) )
+        _status[(code / 100) - 1]++;
+    }
+
+    ////////////////////////////////////////
+
+    inline void accepted()
+    {
+      _accepted++;
+    }
+
+    ////////////////////////////////////////
+
+    inline void timeout(uint8_t kind)
+    {
+      _timeouts[kind]++;
+    }
+
+    ////////////////////////////////////////
+
+    inline void parseTime(uint32_t parse_us)
+    {
+      _record(_parse, parse_us);
+    }
+
+    ////////////////////////////////////////
+
+    inline void deferred(uint8_t inUse)
+    {
+      if (inUse > _deferredPeak)
+        _deferredPeak = inUse;
+    }
+
+    ////////////////////////////////////////
+
+    // Heap / stack probes around parse, handler and finalize of one request. The stackPaint default
+    // is evaluated in the server, which is compiled with the sketch and sees its WS_STACK_PAINT_SZ
+    void memoryBegin(uint16_t stackPaint = WS_STACK_PAINT_SZ);
+    void memorySample();
+    void memoryEnd();
+
+    ////////////////////////////////////////
+
+    inline Route& currentRoute()
+    {
+      return _routes[_current];
+    }
+
+    ////////////////////////////////////////
+
+    // Prometheus text exposition format, no allocation
+    void render(Print& out, uint8_t connectionsActive, uint8_t deferredActive);
+
+  private:
+
+    // Route 0 is responses sent before a handler is looked up, such as 400 / 414 / 431, 1 is requests
+    // without a handler, 2 is handlers not registered by on() / serveStatic()
+    enum { ROUTE_NONE, ROUTE_NOT_FOUND, ROUTE_OTHER, ROUTE_FIRST };
+
+    enum
+    {
+      VALUE_REQUESTS,
+      VALUE_BYTES_IN,
+      VALUE_BYTES_OUT,
+      VALUE_HEAP_PEAK,
+      VALUE_BLOCK_MIN,
+      VALUE_STACK_PEAK,
+      VALUE_ALLOCATIONS,
+      VALUE_ALLOCATED_BYTES
+    };
+
+    void _record(Histogram& hist, uint32_t us);
+    void _renderLabels(Print& out, const Route& route);
+    void _renderHistogram(Print& out, const __FlashStringHelper* name, const Route* route, const Histogram& hist);
+    void _renderRouteValue(Print& out, const __FlashStringHelper* name, const __FlashStringHelper* type, uint8_t which);
+    void _renderGauge(Print& out, const __FlashStringHelper* name, uint32_t value);
+
+    Route     _routes[ROUTE_FIRST + WS_METRICS_MAX_ROUTES];
+    uint8_t   _routeCount;
+    uint8_t   _current;
+
+    Histogram _parse;
+    uint32_t  _status[5];
+    uint32_t  _accepted;
+    uint32_t  _timeouts[TIMEOUT_KINDS];
+    uint8_t   _deferredPeak;
+
+    // Request being probed
+    uint32_t  _memoryStartFree;
+    uint32_t  _memoryMinFree;
+    uint32_t  _memoryMinBlock;
+    uint32_t  _memoryAllocations;
+    uint32_t  _memoryAllocatedBytes;
+
+    uint32_t  _heapFreeMin;
+    uint32_t  _memoryRequests;
+};
+
+WS_LAYOUT_CHECK(WiFiServerMetrics, WS_METRICS_MAX_ROUTES, WS_METRICS_LABEL_LEN, WS_METRICS_BUCKETS);
+
+////////////////////////////////////////
+
+#endif    // ServerMetrics_H
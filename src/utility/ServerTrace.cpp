@@ -0,0 +1,82 @@
+/****************************************************************************************************************************
+  ServerTrace.cpp - Fixed RAM ring of request stage timestamps
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "ServerTrace.h"
+
+WS_LAYOUT_DEFINE(WiFiServerTrace, WS_TRACE_ENTRIES);
+
+////////////////////////////////////////
+
+WiFiServerTrace::WiFiServerTrace()
+{
+  clear();
+}
+
+////////////////////////////////////////
+
+void WiFiServerTrace::clear()
+{
+  _head     = 0;
+  _count    = 0;
+  _dumping  = false;
+}
+
+////////////////////////////////////////
+
+void WiFiServerTrace::dump(Print& out)
+{
+  static const char stageNames[][8] PROGMEM =
+  {
+    "accept", "reqline", "headers", "body", "hstart", "hend", "write", "defer", "resume", "timeout", "close"
+  };
+
+  uint16_t index  = (_head + WS_TRACE_ENTRIES - _count) % WS_TRACE_ENTRIES;
+  uint32_t last   = _entries[index].ts_us;
+
+  _dumping = true;
+
+  for (uint16_t i = 0; i < _count; i++)
+  {
+    const Entry& entry = _entries[index];
+
+    out.print(entry.ts_us);
+    out.print(F(" +"));
+    out.print(entry.ts_us - last);
+    out.print(' ');
+
+    if (entry.stage < STAGES)
+      out.print((const __FlashStringHelper*) stageNames[entry.stage]);
+    else
+      out.print(entry.stage);
+
+    out.print(' ');
+    out.print(entry.arg);
+    out.print('\n');
+
+    last = entry.ts_us;
+
+    if (++index == WS_TRACE_ENTRIES)
+      index = 0;
+  }
+
+  _dumping = false;
+}
+
+////////////////////////////////////////
@@ -0,0 +1,109 @@
+/****************************************************************************************************************************
+  ServerTrace.h - Fixed RAM ring of request stage timestamps
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef ServerTrace_H
+#define ServerTrace_H
+
+#include <Arduino.h>
+
+#include "WiFiLayout.h"
+
+////////////////////////////////////////
+
+// Number of entries kept, 12 bytes each. It sizes the class, which ServerTrace.cpp also
+// uses, so redefine it as a compiler flag (e.g. build_flags). In the sketch only, it fails to link
+#ifndef WS_TRACE_ENTRIES
+  #define WS_TRACE_ENTRIES            64
+#endif
+
+////////////////////////////////////////
+
+class WiFiServerTrace
+{
+  public:
+
+    enum
+    {
+      ACCEPT,           // arg : 0
+      REQUEST_LINE,     // arg : HTTPMethod
+      HEADERS,          // arg : body length
+      BODY,             // arg : body length
+      HANDLER_START,    // arg : 1 if a handler was found
+      HANDLER_END,      // arg : handler time in us
+      WRITE,            // arg : bytes
+      DEFER,            // arg : handle
+      RESUME,           // arg : deferred slot
+      TIMEOUT,          // arg : HTTP_MAX_*_WAIT in ms
+      CLOSE,            // arg : 0
+      STAGES
+    };
+
+    ////////////////////////////////////////
+
+    WiFiServerTrace();
+
+    inline void record(uint8_t stage, uint32_t arg)
+    {
+      // The writes of dump() itself would overwrite the entries it has yet to print
+      if (_dumping)
+        return;
+
+      Entry& entry = _entries[_head];
+
+      entry.ts_us = micros();
+      entry.stage = stage;
+      entry.arg   = arg;
+
+      if (++_head == WS_TRACE_ENTRIES)
+        _head = 0;
+
+      if (_count < WS_TRACE_ENTRIES)
+        _count++;
+    }
+
+    ////////////////////////////////////////
+
+    void clear();
+
+    // Oldest first, one "ts_us +delta_us stage arg" line per entry. Nothing is recorded meanwhile
+    void dump(Print& out);
+
+  private:
+
+    struct Entry
+    {
+      uint32_t  ts_us;
+      uint32_t  arg;
+      uint8_t   stage;
+    };
+
+    Entry     _entries[WS_TRACE_ENTRIES];
+    uint16_t  _head;
+    uint16_t  _count;
+    bool      _dumping;
+};
+
+WS_LAYOUT_CHECK(WiFiServerTrace, WS_TRACE_ENTRIES);
+
+////////////////////////////////////////
+
+#endif    // ServerTrace_H
@@ -0,0 +1,99 @@
+/****************************************************************************************************************************
+  UploadBufferPool.cpp - Upload buffer shared by all servers, freed after each upload unless kept
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#include "UploadBufferPool.h"
+
+////////////////////////////////////////
+
+static uint8_t* sharedBuffer  = NULL;
+static size_t   sharedSize    = 0;
+static bool     sharedBusy    = false;
+static bool     sharedKeep    = false;
+
+////////////////////////////////////////
+
+uint8_t* WiFiUploadBufferPool::acquire(size_t size)
+{
+  if (sharedBusy)
+    return (uint8_t*) malloc(size);
+
+  if (sharedSize < size)
+  {
+    // Nothing to keep, so no realloc copying the old contents
+    free(sharedBuffer);
+
+    sharedBuffer  = (uint8_t*) malloc(size);
+    sharedSize    = sharedBuffer ? size : 0;
+
+    if (!sharedBuffer)
+      return NULL;
+  }
+
+  sharedBusy = true;
+
+  return sharedBuffer;
+}
+
+////////////////////////////////////////
+
+void WiFiUploadBufferPool::release(uint8_t* buffer)
+{
+  if (buffer && (buffer == sharedBuffer))
+  {
+    sharedBusy = false;
+
+    if (!sharedKeep)
+      trim();
+  }
+  else
+    free(buffer);
+}
+
+////////////////////////////////////////
+
+void WiFiUploadBufferPool::keep(bool enable)
+{
+  sharedKeep = enable;
+
+  if (!sharedKeep)
+    trim();
+}
+
+////////////////////////////////////////
+
+void WiFiUploadBufferPool::trim()
+{
+  if (sharedBusy)
+    return;
+
+  free(sharedBuffer);
+
+  sharedBuffer  = NULL;
+  sharedSize    = 0;
+}
+
+////////////////////////////////////////
+
+size_t WiFiUploadBufferPool::size()
+{
+  return sharedSize;
+}
+
+////////////////////////////////////////
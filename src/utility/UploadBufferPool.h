@@ -0,0 +1,54 @@
+/****************************************************************************************************************************
+  UploadBufferPool.h - Upload buffer shared by all servers, freed after each upload unless kept
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef UploadBufferPool_H
+#define UploadBufferPool_H
+
+#include <Arduino.h>
+
+////////////////////////////////////////
+
+// One buffer for every server, allocated when an upload starts and freed once its form is parsed.
+// With keep(true) it stays allocated between uploads and is only grown when a route asks for more.
+// An upload running at the same time on another server gets a buffer of its own, freed when it ends
+class WiFiUploadBufferPool
+{
+  public:
+
+    // NULL if out of memory
+    static uint8_t* acquire(size_t size);
+    static void     release(uint8_t* buffer);
+
+    // Keep the shared buffer after an upload, to save a malloc per upload and
+    // fragmenting the heap. Off by default
+    static void     keep(bool enable);
+
+    // Free the shared buffer if no upload holds it, e.g. once uploads are over for good
+    static void     trim();
+
+    // Bytes kept by the shared buffer
+    static size_t   size();
+};
+
+////////////////////////////////////////
+
+#endif    // UploadBufferPool_H
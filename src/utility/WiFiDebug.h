@@ -77,8 +77,65 @@ const char WWS_LINE[]  = "========================================\n";
 #define WWS_PRINT        WS_DEBUG_OUTPUT.print
 #define WWS_PRINTLN      WS_DEBUG_OUTPUT.println
 
+// Set true to store log records in a RAM ring and print them later, out of the request path
+#ifndef WIFI_WEBSERVER_DEFERRED_LOG
+  #define WIFI_WEBSERVER_DEFERRED_LOG     false
+#endif
+
+#if WIFI_WEBSERVER_DEFERRED_LOG
+  #include "LogRing.h"
+
+  #define WWS_LOG_LINE(...)     wsLogRing().log(WiFiLogRing::LOG_MARK | WiFiLogRing::LOG_NEWLINE, __VA_ARGS__)
+  #define WWS_LOG_RAW(x)        wsLogRing().log(0, x)
+
+  // Print up to n pending records, e.g. from loop() when handleClient() is not called
+  #define WS_LOG_FLUSH(n)       wsLogRing().flush(WS_DEBUG_OUTPUT, (n))
+#else
+  #define WS_LOG_FLUSH(n)
+#endif
+
+///////////////////////////////////////
+
+#if WIFI_WEBSERVER_DEFERRED_LOG
+
+// Records go to wsLogRing(), printed by WS_LOG_FLUSH() from handleClient() idle time
+
+#define WS_LOGERROR(x)          if(_WIFI_LOGLEVEL_>0) { WWS_LOG_LINE(x); }
+#define WS_LOGERROR0(x)         if(_WIFI_LOGLEVEL_>0) { WWS_LOG_RAW(x); }
+#define WS_LOGERROR1(x,y)       if(_WIFI_LOGLEVEL_>0) { WWS_LOG_LINE(x, y); }
+#define WS_LOGERROR2(x,y,z)     if(_WIFI_LOGLEVEL_>0) { WWS_LOG_LINE(x, y, z); }
+#define WS_LOGERROR3(x,y,z,w)   if(_WIFI_LOGLEVEL_>0) { WWS_LOG_LINE(x, y, z, w); }
+#define WS_LOGERROR5(x,y,z,w, xx, yy) if(_WIFI_LOGLEVEL_>0) { WWS_LOG_LINE(x, y, z, w, xx, yy); }
+
+///////////////////////////////////////
+
+#define WS_LOGWARN(x)           if(_WIFI_LOGLEVEL_>1) { WWS_LOG_LINE(x); }
+#define WS_LOGWARN0(x)          if(_WIFI_LOGLEVEL_>1) { WWS_LOG_RAW(x); }
+#define WS_LOGWARN1(x,y)        if(_WIFI_LOGLEVEL_>1) { WWS_LOG_LINE(x, y); }
+#define WS_LOGWARN2(x,y,z)      if(_WIFI_LOGLEVEL_>1) { WWS_LOG_LINE(x, y, z); }
+#define WS_LOGWARN3(x,y,z,w)    if(_WIFI_LOGLEVEL_>1) { WWS_LOG_LINE(x, y, z, w); }
+#define WS_LOGWARN5(x,y,z,w, xx, yy) if(_WIFI_LOGLEVEL_>1) { WWS_LOG_LINE(x, y, z, w, xx, yy); }
+
 ///////////////////////////////////////
 
+#define WS_LOGINFO(x)           if(_WIFI_LOGLEVEL_>2) { WWS_LOG_LINE(x); }
+#define WS_LOGINFO0(x)          if(_WIFI_LOGLEVEL_>2) { WWS_LOG_RAW(x); }
+#define WS_LOGINFO1(x,y)        if(_WIFI_LOGLEVEL_>2) { WWS_LOG_LINE(x, y); }
+#define WS_LOGINFO2(x,y,z)      if(_WIFI_LOGLEVEL_>2) { WWS_LOG_LINE(x, y, z); }
+#define WS_LOGINFO3(x,y,z,w)    if(_WIFI_LOGLEVEL_>2) { WWS_LOG_LINE(x, y, z, w); }
+#define WS_LOGINFO5(x,y,z,w, xx, yy) if(_WIFI_LOGLEVEL_>2) { WWS_LOG_LINE(x, y, z, w, xx, yy); }
+
+///////////////////////////////////////
+
+#define WS_LOGDEBUG(x)          if(_WIFI_LOGLEVEL_>3) { WWS_LOG_LINE(x); }
+#define WS_LOGDEBUG0(x)         if(_WIFI_LOGLEVEL_>3) { WWS_LOG_RAW(x); }
+#define WS_LOGDEBUG1(x,y)       if(_WIFI_LOGLEVEL_>3) { WWS_LOG_LINE(x, y); }
+#define WS_LOGDEBUG2(x,y,z)     if(_WIFI_LOGLEVEL_>3) { WWS_LOG_LINE(x, y, z); }
+#define WS_LOGDEBUG3(x,y,z,w)   if(_WIFI_LOGLEVEL_>3) { WWS_LOG_LINE(x, y, z, w); }
+#define WS_LOGDEBUG5(x,y,z,w, xx, yy) if(_WIFI_LOGLEVEL_>3) { WWS_LOG_LINE(x, y, z, w, xx, yy); }
+
+#else
+
 #define WS_LOGERROR(x)         if(_WIFI_LOGLEVEL_>0) { WWS_PRINT_MARK; WWS_PRINTLN(x); }
 #define WS_LOGERROR0(x)        if(_WIFI_LOGLEVEL_>0) { WWS_PRINT(x); }
 #define WS_LOGERROR1(x,y)      if(_WIFI_LOGLEVEL_>0) { WWS_PRINT_MARK; WWS_PRINT(x); WWS_PRINT_SP; WWS_PRINTLN(y); }
@@ -113,4 +170,6 @@ const char WWS_LINE[]  = "========================================\n";
 #define WS_LOGDEBUG3(x,y,z,w)  if(_WIFI_LOGLEVEL_>3) { WWS_PRINT_MARK; WWS_PRINT(x); WWS_PRINT_SP; WWS_PRINT(y); WWS_PRINT_SP; WWS_PRINT(z); WWS_PRINT_SP; WWS_PRINTLN(w); }
 #define WS_LOGDEBUG5(x,y,z,w, xx, yy)  if(_WIFI_LOGLEVEL_>3) { WWS_PRINT_MARK; WWS_PRINT(x); WWS_PRINT_SP; WWS_PRINT(y); WWS_PRINT_SP; WWS_PRINT(z); WWS_PRINT_SP; WWS_PRINT(w); WWS_PRINT_SP; WWS_PRINT(xx); WWS_PRINT_SP; WWS_PRINTLN(yy);}
 
+#endif    // WIFI_WEBSERVER_DEFERRED_LOG
+
 #endif    // WiFiDebug_H
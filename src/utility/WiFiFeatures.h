@@ -0,0 +1,91 @@
+/****************************************************************************************************************************
+  WiFiFeatures.h - Switches removing whole subsystems of the library
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef WiFiFeatures_H
+#define WiFiFeatures_H
+
+////////////////////////////////////////
+
+// Each switch set false removes a subsystem with its methods and data members, to fit small
+// boards such as the Nano Every. The server is compiled in the sketch, so the WEBSERVER_SUPPORT_*
+// server switches may be defined before #include <WiFiWebServer.h>, but as they change the
+// layout of WiFiWebServer every file including it must agree. WEBSERVER_SUPPORT_HTTP_CLIENT, and
+// all of them with WIFI_WEBSERVER_SEPARATE_IMPL, are read by the library's .cpp files and only
+// work as compiler flags (e.g. build_flags).
+// utils/size_report.sh shows what each one saves
+
+// multipart/form-data bodies. Without it they are read like any other body, into arg("plain")
+#ifndef WEBSERVER_SUPPORT_MULTIPART
+  #define WEBSERVER_SUPPORT_MULTIPART     true
+#endif
+
+// File uploads: HTTPUpload, upload(), onFileUpload() and the upload buffer. File parts of
+// multipart forms are skipped without it
+#ifndef WEBSERVER_SUPPORT_UPLOAD
+  #define WEBSERVER_SUPPORT_UPLOAD        WEBSERVER_SUPPORT_MULTIPART
+#endif
+
+// enableCORS() and the Access-Control-* response headers
+#ifndef WEBSERVER_SUPPORT_CORS
+  #define WEBSERVER_SUPPORT_CORS          true
+#endif
+
+// collectHeaders(), header() and friends
+#ifndef WEBSERVER_SUPPORT_HEADERS
+  #define WEBSERVER_SUPPORT_HEADERS       true
+#endif
+
+// authenticate(), requestAuthentication(), setCredentials(), the credential and nonce tables
+#ifndef WEBSERVER_SUPPORT_AUTH
+  #define WEBSERVER_SUPPORT_AUTH          WEBSERVER_SUPPORT_HEADERS
+#endif
+
+// send_P(), sendContent_P() and send_P_template()
+#ifndef WEBSERVER_SUPPORT_PROGMEM
+  #define WEBSERVER_SUPPORT_PROGMEM       true
+#endif
+
+// WiFiHttpClient, WiFiWebSocketClient and their helpers in WiFi_HTTPClient
+#ifndef WEBSERVER_SUPPORT_HTTP_CLIENT
+  #define WEBSERVER_SUPPORT_HTTP_CLIENT   true
+#endif
+
+////////////////////////////////////////
+
+#if (WEBSERVER_SUPPORT_UPLOAD && !WEBSERVER_SUPPORT_MULTIPART)
+  #undef WEBSERVER_SUPPORT_UPLOAD
+  #define WEBSERVER_SUPPORT_UPLOAD        false
+
+  #warning WEBSERVER_SUPPORT_UPLOAD needs WEBSERVER_SUPPORT_MULTIPART, disabled
+#endif
+
+// The Authorization header is kept in the collected headers
+#if (WEBSERVER_SUPPORT_AUTH && !WEBSERVER_SUPPORT_HEADERS)
+  #undef WEBSERVER_SUPPORT_AUTH
+  #define WEBSERVER_SUPPORT_AUTH          false
+
+  #warning WEBSERVER_SUPPORT_AUTH needs WEBSERVER_SUPPORT_HEADERS, disabled
+#endif
+
+////////////////////////////////////////
+
+#endif    // WiFiFeatures_H
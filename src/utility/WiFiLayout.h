@@ -0,0 +1,56 @@
+/****************************************************************************************************************************
+  WiFiLayout.h - Link-time check that sketch and library agree on compile-time sizes
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Forked and modified from ESP8266 https://github.com/esp8266/Arduino/releases
+  Forked and modified from Arduino WiFiNINA library https://www.arduino.cc/en/Reference/WiFiNINA
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Version: 1.10.1
+
+  Version Modified By   Date      Comments
+  ------- -----------  ---------- -----------
+  1.0.0   K Hoang      12/02/2020 Initial coding for SAMD21, Nano 33 IoT, etc running WiFiNINA
+  ...
+  1.10.0  K Hoang      13/11/2022 Add new features, such as CORS. Update code and examples
+  1.10.1  K Hoang      24/11/2022 Using new WiFi101_Generic library to send larger data
+ *****************************************************************************************************************************/
+
+#pragma once
+
+#ifndef WiFiLayout_H
+#define WiFiLayout_H
+
+////////////////////////////////////////
+
+// Size macros such as WS_TRACE_ENTRIES are read both by the sketch and by the library's .cpp files,
+// which only see compiler flags. A value redefined in the sketch alone would give the two sides a
+// different class layout, or a buffer of a different size, without any warning.
+//
+// WS_LAYOUT_CHECK(T, sizes...), placed in T's header after the class, calls at startup a function
+// which only T's .cpp defines, with WS_LAYOUT_DEFINE(T, sizes...), for the values it was built with.
+// A mismatch fails to link with "undefined reference to WiFiLayout<T, sizes...>::check()",
+// showing the sketch's values. The sizes must be integer constants.
+
+template<typename T, unsigned long... Sizes>
+struct WiFiLayout
+{
+  static bool check();
+};
+
+#define WS_LAYOUT_CHECK(T, ...)                                                             \
+  static const bool wsLayout##T __attribute__((unused)) = WiFiLayout<T, __VA_ARGS__>::check()
+
+// Once per .cpp file
+#define WS_LAYOUT_DEFINE(T, ...)                                                            \
+  template<typename C, unsigned long... Sizes> bool WiFiLayout<C, Sizes...>::check()       \
+  {                                                                                         \
+    return true;                                                                            \
+  }                                                                                         \
+  template struct WiFiLayout<T, __VA_ARGS__>
+
+////////////////////////////////////////
+
+#endif    // WiFiLayout_H
@@ -0,0 +1,10 @@
+// Minimal Arduino.h for building the library's base64 codec on a PC
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)     (*(const uint8_t *)(addr))
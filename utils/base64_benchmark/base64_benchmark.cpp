@@ -0,0 +1,104 @@
+/****************************************************************************************************************************
+  base64_benchmark.cpp - Host-side throughput of WiFiBase64Encoder / WiFiBase64Decoder against libb64
+
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Build and run on a PC, from this directory:
+
+    g++ -O2 -I. -I../../src -o base64_benchmark base64_benchmark.cpp ../../src/utility/Base64Codec.cpp \
+        -x c ../../src/libb64/cencode.c ../../src/libb64/cdecode.c
+    ./base64_benchmark
+
+  Both codecs run on the same random data, which is also checked to round trip. libb64 breaks
+  its output into 72 character lines, its decoder skips the line breaks
+ *****************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <chrono>
+
+#include "utility/Base64Codec.h"
+#include "libb64/cencode.h"
+#include "libb64/cdecode.h"
+
+////////////////////////////////////////
+
+static const size_t sizes[]   = { 16, 64, 1024, 65536 };
+static const size_t kTotal    = 64UL * 1024 * 1024;
+
+static volatile size_t sink;
+
+template<typename F>
+static double megabytesPerSecond(size_t size, F run)
+{
+  size_t rounds = kTotal / size;
+
+  auto start = std::chrono::steady_clock::now();
+
+  for (size_t i = 0; i < rounds; i++)
+  {
+    sink = sink + run();
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  return (rounds * size) / elapsed.count() / 1e6;
+}
+
+int main()
+{
+  printf("%8s %14s %14s %14s %14s\n", "bytes", "encode MB/s", "libb64 MB/s", "decode MB/s", "libb64 MB/s");
+
+  for (size_t size : sizes)
+  {
+    std::vector<uint8_t>  input(size);
+    std::vector<char>     encoded(WS_BASE64_ENCODED_LENGTH(size) + 1);
+    std::vector<char>     encodedLibb64(base64_encode_expected_len(size) + size / 54 + 2);
+    std::vector<uint8_t>  decoded(WS_BASE64_DECODED_LENGTH(encoded.size()));
+    std::vector<char>     decodedLibb64(decoded.size() + 1);
+
+    for (size_t i = 0; i < size; i++)
+    {
+      input[i] = rand();
+    }
+
+    double encode = megabytesPerSecond(size, [&]()
+    {
+      return WiFiBase64Encoder::encode(input.data(), size, encoded.data());
+    });
+
+    double encodeLibb64 = megabytesPerSecond(size, [&]()
+    {
+      return (size_t) base64_encode_chars((const char*) input.data(), size, encodedLibb64.data());
+    });
+
+    size_t encodedLength = WiFiBase64Encoder::encode(input.data(), size, encoded.data());
+    size_t libb64Length  = base64_encode_chars((const char*) input.data(), size, encodedLibb64.data());
+
+    double decode = megabytesPerSecond(size, [&]()
+    {
+      return (size_t) WiFiBase64Decoder::decode(encoded.data(), encodedLength, decoded.data());
+    });
+
+    double decodeLibb64 = megabytesPerSecond(size, [&]()
+    {
+      return (size_t) base64_decode_chars(encodedLibb64.data(), libb64Length, decodedLibb64.data());
+    });
+
+    // Round trip, and the same data from libb64 once its line breaks are skipped
+    bool ok = (WiFiBase64Decoder::decode(encoded.data(), encodedLength, decoded.data()) == (int) size)
+              && (memcmp(decoded.data(), input.data(), size) == 0)
+              && (WiFiBase64Decoder::decode(encodedLibb64.data(), libb64Length, decoded.data()) == (int) size)
+              && (memcmp(decoded.data(), input.data(), size) == 0);
+
+    printf("%8zu %14.1f %14.1f %14.1f %14.1f%s\n", size, encode, encodeLibb64, decode, decodeLibb64,
+           ok ? "" : "  MISMATCH");
+  }
+
+  return 0;
+}
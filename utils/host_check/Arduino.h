@@ -0,0 +1,201 @@
+// Minimal Arduino.h for building the library on a PC, see host_check.sh
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <strings.h>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+typedef uint8_t byte;
+typedef bool    boolean;
+
+class __FlashStringHelper;
+
+#define F(s)                  (reinterpret_cast<const __FlashStringHelper*>(s))
+#define FPSTR(s)              (reinterpret_cast<const __FlashStringHelper*>(s))
+#define PSTR(s)               (s)
+#define PROGMEM
+#define PGM_P                 const char*
+#define strlen_P              strlen
+#define memcpy_P              memcpy
+// The Portenta core has it, WiFiWebServer.hpp defines it elsewhere
+#if defined(ARDUINO_PORTENTA_H7_M7)
+  #define memccpy_P           memccpy
+#endif
+#define pgm_read_byte(p)      (*(const uint8_t*)(p))
+#define pgm_read_word(p)      (*(const uint16_t*)(p))
+#define pgm_read_dword(p)     (*(const uint32_t*)(p))
+#define constrain(x, a, b)    ((x) < (a) ? (a) : ((x) > (b) ? (b) : (x)))
+
+#define DEC 10
+#define HEX 16
+
+inline unsigned long millis()
+{
+  static auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline unsigned long micros()
+{
+  static auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline void delay(unsigned long ms)     { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void yield()                     {}
+inline long random(long a)              { return rand() % a; }
+inline long random(long a, long b)      { return a + rand() % (b - a); }
+inline bool isHexadecimalDigit(int c)   { return isxdigit(c); }
+inline bool isSpace(int c)              { return isspace(c); }
+inline bool isAlphaNumeric(int c)       { return isalnum(c); }
+inline bool isAlpha(int c)              { return isalpha(c); }
+inline bool isDigit(int c)              { return isdigit(c); }
+
+using std::min;
+using std::max;
+
+////////////////////////////////////////
+
+// Arduino String on top of std::string, only what the library uses
+class String
+{
+  public:
+    std::string s;
+
+    String() {}
+    String(const char* c)                             { if (c) s = c; }
+    String(const __FlashStringHelper* f)              { if (f) s = (const char*) f; }
+    String(const String&) = default;
+    String(String&&) = default;
+    explicit String(char c)                           { s = std::string(1, c); }
+    String(int v, unsigned char b = 10)               { _format(b == 16 ? "%x" : "%d", v); }
+    String(unsigned int v, unsigned char b = 10)      { _format(b == 16 ? "%x" : "%u", v); }
+    String(long v, unsigned char b = 10)              { _format(b == 16 ? "%lx" : "%ld", v); }
+    String(unsigned long v, unsigned char b = 10)     { _format(b == 16 ? "%lx" : "%lu", v); }
+    String(double v, unsigned char d = 2)             { char t[64]; snprintf(t, sizeof(t), "%.*f", d, v); s = t; }
+
+    String& operator=(const String&) = default;
+    String& operator=(String&&) = default;
+    String& operator=(const char* c)                  { s = c ? c : ""; return *this; }
+    String& operator=(const __FlashStringHelper* c)   { s = c ? (const char*) c : ""; return *this; }
+
+    unsigned int  length() const                      { return s.size(); }
+    const char*   c_str() const                       { return s.c_str(); }
+    unsigned char reserve(unsigned int n)             { s.reserve(n); return 1; }
+    char          charAt(unsigned int i) const        { return (*this)[i]; }
+    char          operator[](unsigned int i) const    { return (i < s.size()) ? s[i] : 0; }
+    char&         operator[](unsigned int i)          { static char d; if (i < s.size()) return s[i]; d = 0; return d; }
+
+    bool concat(const String& o)                      { s += o.s; return true; }
+    bool concat(const char* c)                        { if (!c) return false; s += c; return true; }
+    bool concat(const char* c, unsigned int n)        { if (!c) return false; s.append(c, n); return true; }
+    bool concat(const __FlashStringHelper* f)         { return concat((const char*) f); }
+    bool concat(char c)                               { s += c; return true; }
+    bool concat(int v)                                { return concat(String(v)); }
+    bool concat(unsigned int v)                       { return concat(String(v)); }
+    bool concat(long v)                               { return concat(String(v)); }
+    bool concat(unsigned long v)                      { return concat(String(v)); }
+
+    template<class T> String& operator+=(const T& v)  { concat(v); return *this; }
+
+    bool operator==(const String& o) const            { return s == o.s; }
+    bool operator==(const char* c) const              { return s == (c ? c : ""); }
+    bool operator!=(const String& o) const            { return s != o.s; }
+    bool operator!=(const char* c) const              { return !(*this == c); }
+    bool operator<(const String& o) const             { return s < o.s; }
+    explicit operator bool() const                    { return true; }
+
+    bool equals(const String& o) const                { return s == o.s; }
+    bool equals(const char* c) const                  { return s == c; }
+    bool equalsIgnoreCase(const String& o) const      { return strcasecmp(s.c_str(), o.c_str()) == 0; }
+    bool startsWith(const String& p) const            { return s.compare(0, p.s.size(), p.s) == 0; }
+    bool endsWith(const String& p) const              { return (s.size() >= p.s.size()) && (s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0); }
+
+    int  indexOf(char c, unsigned int from = 0) const           { return _found(s.find(c, from)); }
+    int  indexOf(const String& c, unsigned int from = 0) const  { return _found(s.find(c.s, from)); }
+    int  lastIndexOf(char c) const                              { return _found(s.rfind(c)); }
+
+    String substring(unsigned int a) const
+    {
+      String r;
+
+      if (a < s.size())
+        r.s = s.substr(a);
+
+      return r;
+    }
+
+    String substring(unsigned int a, int b) const
+    {
+      unsigned int e = ( (b < 0) || ((unsigned int) b > s.size()) ) ? s.size() : b;
+      String r;
+
+      if (a > e)
+        std::swap(a, e);
+
+      r.s = s.substr(a, e - a);
+
+      return r;
+    }
+
+    void trim()
+    {
+      size_t a = s.find_first_not_of(" \t\r\n");
+      size_t b = s.find_last_not_of(" \t\r\n");
+
+      s = (a == std::string::npos) ? std::string() : s.substr(a, b - a + 1);
+    }
+
+    void replace(const String& f, const String& t)
+    {
+      for (size_t p = 0; !f.s.empty() && ((p = s.find(f.s, p)) != std::string::npos); p += t.s.size())
+        s.replace(p, f.s.size(), t.s);
+    }
+
+    void  remove(unsigned int i, unsigned int n = -1)   { if (i < s.size()) s.erase(i, n); }
+    long  toInt() const                                 { return atol(s.c_str()); }
+    float toFloat() const                               { return atof(s.c_str()); }
+    void  toLowerCase()                                 { for (auto& c : s) c = tolower(c); }
+
+  private:
+    template<typename T> void _format(const char* f, T v)   { char t[40]; snprintf(t, sizeof(t), f, v); s = t; }
+    static int _found(size_t p)                             { return (p == std::string::npos) ? -1 : (int) p; }
+};
+
+inline String operator+(const String& a, const String& b)   { String r = a; r.s += b.s; return r; }
+inline String operator+(const String& a, const char* b)     { String r = a; r.concat(b); return r; }
+inline String operator+(const char* a, const String& b)     { String r(a); r.s += b.s; return r; }
+inline String operator+(const String& a, char b)            { String r = a; r.s += b; return r; }
+inline String operator+(const String& a, int b)             { return a + String(b); }
+inline String operator+(const String& a, unsigned long b)   { return a + String(b); }
+
+extern const String emptyString;
+
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+
+////////////////////////////////////////
+
+class HardwareSerial : public Stream
+{
+  public:
+    size_t write(uint8_t c)   { fputc(c, stderr); return 1; }
+    using Print::write;
+    int available()           { return 0; }
+    int read()                { return -1; }
+    int peek()                { return -1; }
+    void begin(long)          {}
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,32 @@
+// Minimal IPAddress for building the library on a PC
+
+#pragma once
+
+class IPAddress : public Printable
+{
+  public:
+    uint8_t b[4] = { 0, 0, 0, 0 };
+
+    IPAddress() {}
+    IPAddress(uint8_t a, uint8_t c, uint8_t d, uint8_t e)   { b[0] = a; b[1] = c; b[2] = d; b[3] = e; }
+    IPAddress(uint32_t v)                                   { memcpy(b, &v, 4); }
+
+    operator uint32_t() const                               { uint32_t v; memcpy(&v, b, 4); return v; }
+    bool operator==(const IPAddress& o) const               { return memcmp(b, o.b, 4) == 0; }
+    uint8_t operator[](int i) const                         { return b[i]; }
+
+    size_t printTo(Print& p) const
+    {
+      size_t n = 0;
+
+      for (int i = 0; i < 4; i++)
+      {
+        n += p.print((int) b[i]);
+
+        if (i < 3)
+          n += p.print('.');
+      }
+
+      return n;
+    }
+};
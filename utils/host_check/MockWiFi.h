@@ -0,0 +1,102 @@
+// Scripted WiFiClient / WiFiServer for building the library on a PC, named by
+// WIFI_WEBSERVER_CUSTOM_WIFI_H. rx holds what the peer sends, tx what was written to it
+
+#pragma once
+
+#include "Client.h"
+
+#include <deque>
+#include <memory>
+
+struct MockSocket
+{
+  std::string   rx;
+  size_t        pos       = 0;
+  std::string   tx;
+  bool          open      = true;
+  size_t        trickle   = 0;      // at most this many bytes available at a time, 0 for all
+};
+
+class WiFiClient : public Client
+{
+  public:
+    std::shared_ptr<MockSocket> s;
+
+    WiFiClient() {}
+    WiFiClient(std::shared_ptr<MockSocket> p) : s(p) {}
+
+    int connect(IPAddress, uint16_t)          { return _open(); }
+    int connect(const char*, uint16_t)        { return _open(); }
+
+    size_t write(uint8_t b)                   { return write(&b, 1); }
+    size_t write(const uint8_t* b, size_t n)  { if (!s) return 0; s->tx.append((const char*) b, n); return n; }
+    using Print::write;
+
+    int available()
+    {
+      if (!s)
+        return 0;
+
+      size_t a = s->rx.size() - s->pos;
+
+      return (s->trickle && (a > s->trickle)) ? s->trickle : a;
+    }
+
+    int read()                                { return (!s || (s->pos >= s->rx.size())) ? -1 : (uint8_t) s->rx[s->pos++]; }
+
+    int read(uint8_t* b, size_t n)
+    {
+      int a = available();
+
+      if (a <= 0)
+        return -1;
+
+      n = min(n, (size_t) a);
+      memcpy(b, s->rx.data() + s->pos, n);
+      s->pos += n;
+
+      return n;
+    }
+
+    int  peek()                               { return (!s || (s->pos >= s->rx.size())) ? -1 : (uint8_t) s->rx[s->pos]; }
+    void flush()                              {}
+    void stop()                               { if (s) { s->open = false; s->rx.clear(); s->pos = 0; } }
+    uint8_t connected()                       { return s && (s->open || available()); }
+    operator bool()                           { return (bool) s; }
+    bool operator==(const WiFiClient& o) const { return s == o.s; }
+
+  private:
+    int _open()
+    {
+      if (!s)
+        s = std::make_shared<MockSocket>();
+
+      s->open = true;
+      s->rx.clear();
+      s->pos  = 0;
+
+      return 1;
+    }
+};
+
+// Connections waiting to be accepted
+extern std::deque<std::shared_ptr<MockSocket>> pendingSockets;
+
+class WiFiServer
+{
+  public:
+    WiFiServer(int) {}
+    void begin()            {}
+    void begin(uint16_t)    {}
+
+    WiFiClient available()
+    {
+      if (pendingSockets.empty())
+        return WiFiClient();
+
+      auto p = pendingSockets.front();
+      pendingSockets.pop_front();
+
+      return WiFiClient(p);
+    }
+};
@@ -0,0 +1,56 @@
+// Minimal Print for building the library on a PC
+
+#pragma once
+
+class Printable;
+
+class Print
+{
+  public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t) = 0;
+
+    virtual size_t write(const uint8_t* b, size_t n)
+    {
+      size_t r = 0;
+
+      while (n--)
+        r += write(*b++);
+
+      return r;
+    }
+
+    size_t write(const char* s)                 { return s ? write((const uint8_t*) s, strlen(s)) : 0; }
+    size_t write(const char* b, size_t n)       { return write((const uint8_t*) b, n); }
+    virtual int  availableForWrite()            { return 0; }
+    virtual void flush()                        {}
+
+    size_t print(const char* s)                 { return write(s); }
+    size_t print(const String& s)               { return write(s.c_str(), s.length()); }
+    size_t print(const __FlashStringHelper* s)  { return write((const char*) s); }
+    size_t print(char c)                        { return write((uint8_t) c); }
+    size_t print(int v, int b = 10)             { return print(String(v, (unsigned char) b)); }
+    size_t print(unsigned int v, int b = 10)    { return print(String(v, (unsigned char) b)); }
+    size_t print(long v, int b = 10)            { return print(String(v, (unsigned char) b)); }
+    size_t print(unsigned long v, int b = 10)   { return print(String(v, (unsigned char) b)); }
+    size_t print(unsigned long long v, int = 10){ return print(String((unsigned long) v)); }
+    size_t print(double v, int d = 2)           { return print(String(v, (unsigned char) d)); }
+    size_t print(const Printable& p);
+
+    size_t println()                            { return write("\r\n"); }
+    template<class T> size_t println(const T& v)        { size_t n = print(v); return n + println(); }
+    template<class T> size_t println(const T& v, int b) { size_t n = print(v, b); return n + println(); }
+};
+
+class Printable
+{
+  public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print&) const = 0;
+};
+
+inline size_t Print::print(const Printable& p)
+{
+  return p.printTo(*this);
+}
@@ -0,0 +1,54 @@
+// Minimal Stream for building the library on a PC
+
+#pragma once
+
+class Stream : public Print
+{
+  protected:
+    unsigned long _timeout = 1000;
+
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void          setTimeout(unsigned long t)   { _timeout = t; }
+    unsigned long getTimeout()                  { return _timeout; }
+
+    int timedRead()
+    {
+      unsigned long start = millis();
+
+      do
+      {
+        int c = read();
+
+        if (c >= 0)
+          return c;
+      } while (millis() - start < _timeout);
+
+      return -1;
+    }
+
+    size_t readBytes(char* b, size_t n)
+    {
+      size_t count = 0;
+
+      for (int c; (count < n) && ((c = timedRead()) >= 0); )
+        b[count++] = c;
+
+      return count;
+    }
+
+    size_t readBytes(uint8_t* b, size_t n)      { return readBytes((char*) b, n); }
+
+    String readStringUntil(char t)
+    {
+      String r;
+
+      for (int c = timedRead(); (c >= 0) && (c != t); c = timedRead())
+        r.s += (char) c;
+
+      return r;
+    }
+};
@@ -0,0 +1,3 @@
+// PROGMEM is plain memory on a PC, see ../Arduino.h
+
+#pragma once
@@ -0,0 +1,15 @@
+// vl::Func on top of std::function, for building the library on a PC
+
+#pragma once
+
+#include <functional>
+
+namespace vl
+{
+  template<class T> class Func : public std::function<T>
+  {
+    public:
+      using std::function<T>::function;
+      Func() {}
+  };
+}
@@ -0,0 +1,241 @@
+/****************************************************************************************************************************
+  host_check.cpp - Host-side checks of WiFiWebServer request parsing, against the scripted sockets of MockWiFi.h
+
+  For any WiFi shields, such as WiFiNINA W101, W102, W13x, or custom, such as ESP8266/ESP32-AT, Ethernet, etc
+
+  WiFiWebServer is a library for the ESP32-based WiFi shields to run WebServer
+  Built by Khoi Hoang https://github.com/khoih-prog/WiFiWebServer
+  Licensed under MIT license
+
+  Build and run on a PC with ./host_check.sh, from this directory. It builds this file with the
+  library for several configurations, and reports the compile time and text size of this file.
+
+  Each check prints PASS or FAIL, and the exit status is the number of failures:
+
+    form      multipart fields and a file upload, with handleClient() and handleClient(budget_us)
+    json      a JSON body reaches the handler, an unbalanced one is answered 400
+    lines     a long request line gets 414, a long header line 431, the next request is served
+ *****************************************************************************************************************************/
+
+#include "MockWiFi.h"
+#include <WiFiWebServer.h>
+
+////////////////////////////////////////
+
+const String    emptyString;
+HardwareSerial  Serial;
+
+std::deque<std::shared_ptr<MockSocket>> pendingSockets;
+
+WiFiWebServer server(80);
+
+static int failures = 0;
+
+#if WIFI_WEBSERVER_SEPARATE_IMPL
+  // Built as a second file, sharing the server of WiFiWebServer.cpp
+  void otherFile();
+#else
+  // Two files cannot each hold the header-only implementation
+  #include "other.cpp"
+#endif
+
+////////////////////////////////////////
+
+static void check(const char* name, bool ok)
+{
+  printf("%-6s %s\n", ok ? "PASS" : "FAIL", name);
+
+  if (!ok)
+    failures++;
+}
+
+////////////////////////////////////////
+
+// Queue a connection sending request, then serve it. budget_us 0 uses the blocking handleClient()
+static std::string serve(const std::string& request, unsigned long budget_us = 0, size_t trickle = 0)
+{
+  auto socket = std::make_shared<MockSocket>();
+
+  socket->rx      = request;
+  socket->open    = false;
+  socket->trickle = trickle;
+  pendingSockets.push_back(socket);
+
+  if (budget_us == 0)
+  {
+    server.handleClient();
+    server.handleClient();
+  }
+  else
+  {
+    for (unsigned long start = millis(); millis() - start < 300; )
+      server.handleClient(budget_us);
+  }
+
+  return socket->tx;
+}
+
+////////////////////////////////////////
+
+static std::string statusOf(const std::string& response)
+{
+  return (response.size() > 12) ? response.substr(9, 3) : "---";
+}
+
+////////////////////////////////////////
+
+static std::string bodyOf(const std::string& response)
+{
+  size_t end = response.find("\r\n\r\n");
+
+  return (end == std::string::npos) ? "" : response.substr(end + 4);
+}
+
+////////////////////////////////////////
+
+#if WEBSERVER_SUPPORT_MULTIPART
+
+static std::string uploaded;
+
+static std::string formRequest(const std::string& file)
+{
+  const std::string boundary = "----XyZ";
+
+  std::string form = "--" + boundary + "\r\nContent-Disposition: form-data; name=\"a\"\r\n\r\nval\r\n"
+                     "--" + boundary + "\r\nContent-Disposition: form-data; name=\"f\"; filename=\"x.bin\"\r\n"
+                     "Content-Type: application/octet-stream\r\n\r\n" + file + "\r\n"
+                     "--" + boundary + "\r\nContent-Disposition: form-data; name=\"c\"\r\n\r\nlast\r\n"
+                     "--" + boundary + "--\r\n";
+
+  return "POST /form HTTP/1.1\r\nHost: x\r\nContent-Type: multipart/form-data; boundary=" + boundary +
+         "\r\nContent-Length: " + std::to_string(form.size()) + "\r\n\r\n" + form;
+}
+
+////////////////////////////////////////
+
+static void checkForm(const char* name, const std::string& file, unsigned long budget_us)
+{
+#if WEBSERVER_SUPPORT_UPLOAD
+  const std::string& expected = file;
+#else
+  // File parts are skipped
+  const std::string expected;
+#endif
+
+  uploaded.clear();
+  std::string response = serve(formRequest(file), budget_us, budget_us ? 5 : 0);
+
+  check(name, (statusOf(response) == "200") && (bodyOf(response) == "a=val c=last") && (uploaded == expected));
+}
+
+////////////////////////////////////////
+
+static void checkForm()
+{
+  std::string file;
+
+  for (int i = 0; i < 3000; i++)
+    file += (char) (i * 7);
+
+  checkForm("form, blocking", file, 0);
+  checkForm("form, budget", file, 200);
+
+#if USE_NEW_WEBSERVER_VERSION
+  // Near misses of the delimiter inside the file. Only for the incremental parser of
+  // handleClient(budget_us), _parseForm() compares them with strstr() on an unterminated buffer
+  checkForm("form, near misses", file + "\r\n--XyZ\r\r\n---\r\n------Xytail\r", 200);
+#endif
+}
+
+#endif
+
+////////////////////////////////////////
+
+#if USE_NEW_WEBSERVER_VERSION
+
+static int jsonCalls = 0;
+
+static void checkJson()
+{
+  const std::string good  = "{\"a\":12,\"c\":{\"d\":\"x y\"}}";
+  const std::string bad   = "{\"a\":1}}";
+  const std::string head  = "POST /json HTTP/1.1\r\nHost: x\r\nContent-Type: application/json\r\nContent-Length: ";
+
+  server.enableJsonArgs();
+
+  std::string response = serve(head + std::to_string(good.size()) + "\r\n\r\n" + good);
+
+  check("json, valid", (statusOf(response) == "200") && (bodyOf(response) == "a=12 c.d=x y"));
+
+  jsonCalls = 0;
+  response  = serve(head + std::to_string(bad.size()) + "\r\n\r\n" + bad);
+
+  check("json, invalid", (statusOf(response) == "400") && (jsonCalls == 0));
+
+  server.enableJsonArgs(false);
+}
+
+////////////////////////////////////////
+
+static void checkLines()
+{
+  std::string longLine    = serve("GET /" + std::string(WEBSERVER_MAX_LINE_LEN, 'a') + " HTTP/1.1\r\n\r\n", 5000);
+  std::string longHeader  = serve("GET / HTTP/1.1\r\nX-Big: " + std::string(WEBSERVER_MAX_LINE_LEN, 'b') + "\r\n\r\n", 5000);
+  std::string normal      = serve("GET / HTTP/1.1\r\nX: y\r\n\r\n", 5000);
+
+  check("lines, request line", statusOf(longLine) == "414");
+  check("lines, header line", statusOf(longHeader) == "431");
+  check("lines, next request", (statusOf(normal) == "200") && (bodyOf(normal) == "root"));
+}
+
+#endif
+
+////////////////////////////////////////
+
+int main()
+{
+  server.on("/", []()
+  {
+    server.send(200, "text/plain", "root");
+  });
+
+  server.on("/form", HTTP_POST, []()
+  {
+    server.send(200, "text/plain", "a=" + server.arg("a") + " c=" + server.arg("c"));
+  }, []()
+  {
+#if (WEBSERVER_SUPPORT_MULTIPART && WEBSERVER_SUPPORT_UPLOAD)
+    HTTPUpload& upload = server.upload();
+
+    if (upload.status == UPLOAD_FILE_WRITE)
+      uploaded.append((const char*) upload.buf, upload.currentSize);
+
+#endif
+  });
+
+  server.on("/json", HTTP_POST, []()
+  {
+#if USE_NEW_WEBSERVER_VERSION
+    jsonCalls++;
+#endif
+    server.send(200, "text/plain", "a=" + server.arg("a") + " c.d=" + server.arg("c.d"));
+  });
+
+  otherFile();
+  server.begin();
+
+  printf("sizeof(WiFiWebServer) = %zu\n", sizeof(WiFiWebServer));
+
+#if WEBSERVER_SUPPORT_MULTIPART
+  checkForm();
+#endif
+
+#if USE_NEW_WEBSERVER_VERSION
+  checkJson();
+  checkLines();
+#endif
+
+  check("other file", statusOf(serve("GET /other HTTP/1.1\r\n\r\n")) == "200");
+
+  return failures;
+}
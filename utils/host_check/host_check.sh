@@ -0,0 +1,76 @@
+#!/bin/bash
+#
+# Builds host_check.cpp with the library on a PC, for each configuration below, and runs it.
+# Needs g++, run from this directory:
+#
+#   ./host_check.sh [extra compiler flags]
+#
+# For each configuration it prints the checks, then the compile time and text size of the
+# sketch-like file host_check.cpp. The Arduino headers are the minimal ones of this directory,
+# the sockets are scripted by MockWiFi.h
+
+src=../../src
+out=${TMPDIR:-/tmp}/host_check
+
+common="-std=gnu++17 -O2 -I. -I${src} -DUSE_WIFI_CUSTOM=true -DUSE_WIFI_NINA=false -D_WIFI_LOGLEVEL_=0 \
+        -DWIFI_WEBSERVER_CUSTOM_WIFI_H=\"MockWiFi.h\" -Wno-cpp $*"
+
+names=(
+  "header-only"
+  "all off"
+  "legacy"
+  "separate"
+)
+
+configs=(
+  ""
+  "-DWEBSERVER_SUPPORT_MULTIPART=false -DWEBSERVER_SUPPORT_CORS=false -DWEBSERVER_SUPPORT_HEADERS=false -DWEBSERVER_SUPPORT_PROGMEM=false -DWEBSERVER_SUPPORT_HTTP_CLIENT=false"
+  "-DARDUINO_PORTENTA_H7_M7"
+  "-DWIFI_WEBSERVER_SEPARATE_IMPL=true"
+)
+
+failed=0
+
+for i in "${!configs[@]}"; do
+  flags="${common} ${configs[$i]}"
+  dir="${out}/${i}"
+  objs=()
+
+  echo "== ${names[$i]}: ${configs[$i]:-(defaults)}"
+
+  rm -rf "${dir}" && mkdir -p "${dir}"
+
+  for file in $(cd "${src}" && find . \( -name '*.c' -o -name '*.cpp' \) ! -path '*esp_detail*'); do
+    obj="${dir}/$(echo "${file#./}" | tr '/.' '__').o"
+
+    if [[ ${file} == *.c ]]; then
+      gcc -O2 -I. -I"${src}" -c "${src}/${file}" -o "${obj}" || exit 1
+    else
+      g++ ${flags} -w -c "${src}/${file}" -o "${obj}" || exit 1
+    fi
+
+    objs+=("${obj}")
+  done
+
+  if [[ ${configs[$i]} == *SEPARATE_IMPL=true* ]]; then
+    g++ ${flags} -c other.cpp -o "${dir}/other.o" || exit 1
+    objs+=("${dir}/other.o")
+  fi
+
+  start=$(date +%s%N)
+  g++ ${flags} -c host_check.cpp -o "${dir}/host_check.o" || exit 1
+  end=$(date +%s%N)
+
+  g++ ${flags} -o "${dir}/host_check" "${dir}/host_check.o" "${objs[@]}" || exit 1
+
+  if ! "${dir}/host_check" 2>/dev/null; then
+    failed=$((failed + 1))
+  fi
+
+  printf "host_check.cpp: %d ms, %s bytes of text\n\n" $(( (end - start) / 1000000 )) \
+         "$(size "${dir}/host_check.o" | awk 'NR == 2 { print $1 }')"
+done
+
+echo "${failed} of ${#configs[@]} configurations failed"
+
+exit $((failed != 0))
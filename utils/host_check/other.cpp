@@ -0,0 +1,21 @@
+/****************************************************************************************************************************
+  other.cpp - Second file including WiFiWebServer.h, see host_check.cpp
+
+  With WIFI_WEBSERVER_SEPARATE_IMPL=true it is compiled on its own, and both files share the server
+  built in WiFiWebServer.cpp. The header-only build includes it in host_check.cpp instead
+ *****************************************************************************************************************************/
+
+#include "MockWiFi.h"
+#include <WiFiWebServer.h>
+
+extern WiFiWebServer server;
+
+////////////////////////////////////////
+
+void otherFile()
+{
+  server.on("/other", []()
+  {
+    server.send(200, "text/plain", "other");
+  });
+}
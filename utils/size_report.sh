@@ -0,0 +1,42 @@
+#!/bin/bash
+#
+# Flash and RAM used by a sketch with each WEBSERVER_SUPPORT_* switch of src/utility/WiFiFeatures.h
+# turned off. Needs arduino-cli with the board core installed, run from the library directory:
+#
+#   ./utils/size_report.sh [FQBN] [sketch]
+#
+# The switches are passed as compiler flags, so the sketch and the library .cpp files agree
+
+fqbn=${1:-arduino:megaavr:nona4809}
+sketch=${2:-examples/HelloServer}
+
+configs=(
+  ""
+  "-DWEBSERVER_SUPPORT_MULTIPART=false"
+  "-DWEBSERVER_SUPPORT_UPLOAD=false"
+  "-DWEBSERVER_SUPPORT_CORS=false"
+  "-DWEBSERVER_SUPPORT_HEADERS=false"
+  "-DWEBSERVER_SUPPORT_AUTH=false"
+  "-DWEBSERVER_SUPPORT_PROGMEM=false"
+  "-DWEBSERVER_SUPPORT_HTTP_CLIENT=false"
+  "-DWEBSERVER_SUPPORT_MULTIPART=false -DWEBSERVER_SUPPORT_CORS=false -DWEBSERVER_SUPPORT_HEADERS=false -DWEBSERVER_SUPPORT_PROGMEM=false -DWEBSERVER_SUPPORT_HTTP_CLIENT=false"
+)
+
+echo "Sketch ${sketch} on ${fqbn}"
+echo
+printf "%-10s %-10s %s\n" "Flash" "RAM" "Flags"
+
+for flags in "${configs[@]}"; do
+  out=$(arduino-cli compile --fqbn "${fqbn}" --library . --clean \
+        --build-property "compiler.cpp.extra_flags=${flags}" "${sketch}" 2>&1)
+
+  if [ $? -ne 0 ]; then
+    printf "%-10s %-10s %s\n" "failed" "-" "${flags:-(all on)}"
+    continue
+  fi
+
+  flash=$(echo "${out}" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+  ram=$(echo "${out}" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+
+  printf "%-10s %-10s %s\n" "${flash:--}" "${ram:--}" "${flags:-(all on)}"
+done